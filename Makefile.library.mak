@@ -40,7 +40,7 @@ extension := .so
 include_flags := -Iengine/src -I$(VULKAN_SDK)/include
 compiler_flags := -g -fdeclspec -fPIC
 defines := -DDEBUG -DDEXPORT 
-linker_flags :=-Wl,--no-undefined,--no-allow-shlib-undefined -shared -lm -L./$(bind_dir) -g -lvulkan -lm
+linker_flags :=-Wl,--no-undefined,--no-allow-shlib-undefined -shared -lm -L./$(bind_dir) -g -lvulkan -lm -lpthread
 
 linux_platform := $(shell echo "$$XDG_SESSION_TYPE")
 
@@ -0,0 +1,88 @@
+# Builds one of the command-line tools under tools/, e.g. make -f Makefile.tools.mak all tool=logdecode
+obj_dir := obj
+bin_dir := bin
+cc := clang
+tool ?= logdecode
+src_dir := tools/$(tool)
+
+ifeq ($(OS),Windows_NT)
+
+DIR := $(subst /,\,${CURDIR})
+
+assembly := $(tool)
+extension := .exe
+defines := -DDEBUG -DDIMPORT -DDPLATFORM_WINDOWS
+include_flags := -Iengine\src -I$(src_dir)\src
+linker_flags := -g -lengine.lib -L$(obj_dir)\engine -L$(bin_dir) #-Wl,-rpath,.
+compiler_flags := -Wall -Wextra -g3 -Wno-unused-parameter -Wno-unused-function -Wno-missing-braces -fdeclspec
+build_platform := windows
+
+rwildcard=$(wildcard $1$2) $(foreach d,$(wildcard $1*),$(call rwildcard,$d/,$2))
+
+src_files := $(call rwildcard,$(src_dir)/,*.c) # Get all .c files
+directories := \$(src_dir)\src $(subst $(DIR),,$(shell dir $(src_dir)\src /S /AD /B | findstr /i src)) # Get all directories under src.
+obj_files := $(src_files:%=$(obj_dir)/%.o) # Get all compiled .c.o objects for the tool
+
+else
+
+is_linux := $(shell uname -s)
+
+ifeq ($(is_linux),Linux)
+
+assembly := $(tool)
+extension := 
+include_flags := -Iengine/src -I$(src_dir)/src
+compiler_flags := -g -MD -O0 -fvisibility=hidden -Wall -Werror -Wvla -Werror=vla -Wno-missing-braces -fdeclspec -fPIC
+defines := -DDEBUG -DDIMPORT
+linker_flags := -Wl,--no-undefined,--no-allow-shlib-undefined -lengine -L./$(bin_dir) -Wl,-rpath,. -lm -ldl
+build_platform := linux
+
+# .c files
+src_files := $(shell find $(src_dir) -name *.c)
+# directories with .h files
+directories := $(shell find $(src_dir) -type d)
+
+obj_files := $(src_files:%=$(obj_dir)/%.o)
+
+endif
+
+endif
+
+all: scaffold compile link
+
+.PHONY: scaffold
+scaffold:
+ifeq ($(build_platform),windows)
+	@echo scaffolding project structure
+	-@setlocal enableextensions enabledelayedexpansion && mkdir $(addsuffix \$(src_dir),$(obj_dir)) 2>NUL || cd .
+	-@setlocal enableextensions enabledelayedexpansion && mkdir $(addprefix $(obj_dir), $(directories)) 2>NUL || cd .
+else
+	@echo Scaffolding folder structure...
+	@mkdir -p $(addprefix $(obj_dir)/,$(directories))
+	@echo Done.
+endif
+
+.PHONY: compile
+compile:
+	@echo --- compiling "$(assembly)" for $(build_platform) ---
+
+.PHONY: link
+link: scaffold $(obj_files)
+	@echo Linking $(assembly)
+	@clang $(obj_files) -o $(bin_dir)/$(assembly)$(extension) $(linker_flags)
+
+.PHONY: clean
+clean: # clean build directory
+ifeq ($(build_platform),windows)
+	if exist $(bin_dir)\$(assembly)$(extension) del $(bin_dir)\$(assembly)$(extension)
+	rmdir /s /q $(obj_dir)\$(src_dir)
+else
+	rm -rf $(bin_dir)/$(assembly)
+	rm -rf $(obj_dir)/$(src_dir)
+endif
+
+$(obj_dir)/%.c.o: %.c
+	@echo   $<...
+	@$(cc) $< $(compiler_flags) -c -o $@ $(defines) $(include_flags)
+
+-include $(obj_files:.o=.d)
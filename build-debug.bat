@@ -11,6 +11,15 @@ IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
 make -f "Makefile.tests.mak" all
 IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
 
+make -f "Makefile.tools.mak" all tool=logdecode
+IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
+
+make -f "Makefile.tools.mak" all tool=pack
+IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
+
+make -f "Makefile.tools.mak" all tool=cook
+IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
+
 CALL post_build.bat
 
 ECHO "All assemblies built successfully."
@@ -27,4 +27,35 @@ then
 echo "Error:"$ERRORLEVEL && exit
 fi
 
+make -f Makefile.tools.mak all tool=logdecode
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+make -f Makefile.tools.mak all tool=pack
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+make -f Makefile.tools.mak all tool=cook
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+# Cook the assets, then pack them, so the testbed can load them from a single file.
+pushd bin > /dev/null
+./cook ../assets && ./pack ../assets assets.dpk
+ERRORLEVEL=$?
+popd > /dev/null
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
 echo "All assemblies built successfully."
@@ -27,6 +27,30 @@ then
 echo "Error:"$ERRORLEVEL && exit
 fi
 
+make -f Makefile.tools.mak clean tool=logdecode
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+make -f Makefile.tools.mak clean tool=pack
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+make -f Makefile.tools.mak clean tool=cook
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+rm -f bin/assets.dpk
+find assets \( -name '*.dtex' -o -name '*.dmt' \) -type f -delete
+
 find obj/* -name '*.o' -type f 
 find obj/* -name '*.o' -type f -delete 
 
@@ -8,6 +8,7 @@
 #include "core/dstring.h"
 #include "core/event.h"
 #include "core/input.h"
+#include "platform/filesystem.h"
 #include "platform/platform.h"
 
 #include "memory/linear_allocator.h"
@@ -15,7 +16,9 @@
 #include "renderer/renderer_frontend.h"
 
 // systems
+#include "systems/asset_watcher_system.h"
 #include "systems/geometry_system.h"
+#include "systems/job_system.h"
 #include "systems/material_system.h"
 #include "systems/resource_system.h"
 #include "systems/texture_system.h"
@@ -50,6 +53,9 @@ typedef struct application_state
     u64 platform_system_memory_requirement;
     void *platform_system_state;
 
+    u64 job_system_memory_requirement;
+    void *job_system_state;
+
     u64 resource_system_memory_requirement;
     void *resource_system_state;
 
@@ -65,10 +71,38 @@ typedef struct application_state
     u64 geometry_system_memory_requirement;
     void *geometry_system_state;
 
+    // Only started in debug builds. Null if not running.
+    u64 asset_watcher_system_memory_requirement;
+    void *asset_watcher_system_state;
+
     // TODO: temp
     geometry *test_geometry;
     // TODO: end temp
 
+    // Pipelined rendering. See application_config.pipelined_rendering.
+    platform_thread render_thread;
+    // Held by the main thread between frames, and by the render thread while a frame uses renderer resources.
+    // Not held while the render thread waits for the GPU or the display.
+    platform_mutex render_mutex;
+    // Counts packets built and waiting to be drawn.
+    platform_semaphore packet_ready;
+    // Counts packets that have been drawn and may be rebuilt.
+    platform_semaphore packet_free;
+    b8 render_thread_quit;
+    // Double-buffered, so one packet can be built while the other is drawn.
+    render_packet packets[2];
+    // How long drawing each packet last took, set before the packet is freed.
+    f64 packet_draw_seconds[2];
+    // Totals since last logged, to show how much drawing overlaps the main thread's work.
+    f64 render_timing_start;
+    f64 render_draw_seconds;
+    f64 render_wait_seconds;
+    f64 render_lock_seconds;
+    u32 render_timing_frames;
+    // TODO: temp
+    geometry_render_data packet_geometries[2];
+    // TODO: end temp
+
 } application_state;
 
 static application_state *app_state;
@@ -78,6 +112,12 @@ b8 application_on_event(u16 code, void *sender, void *listener_inst, event_conte
 b8 application_on_key(u16 code, void *sender, void *listener_inst, event_context context);
 b8 application_on_resized(u16 code, void *sender, void *listener_inst, event_context context);
 
+static void build_render_packet(render_packet *packet, f32 delta_time);
+static b8 render_thread_start();
+static void render_thread_stop();
+static u32 render_thread_run(void *params);
+static void log_render_timings();
+
 // TODO: temp
 b8 event_on_debug_event(u16 code, void *sender, void *listener_inst, event_context data)
 {
@@ -93,7 +133,8 @@ b8 event_on_debug_event(u16 code, void *sender, void *listener_inst, event_conte
     // Acquire the new texture.
     if (app_state->test_geometry)
     {
-        app_state->test_geometry->material->diffuse_map.texture = texture_system_acquire(names[choice], true);
+        // The default texture is drawn until the new one has finished loading in the background.
+        app_state->test_geometry->material->diffuse_map.texture = texture_system_acquire_async(names[choice], true);
         if (!app_state->test_geometry->material->diffuse_map.texture)
         {
             DWARN("event_on_debug_event no texture! using default");
@@ -176,10 +217,26 @@ b8 application_create(game *game_inst)
         return false;
     }
 
+    // Job system.
+    job_system_config job_sys_config;
+    job_sys_config.max_worker_count = 32;
+    job_sys_config.max_job_count    = 512;
+    job_system_initialize(&app_state->job_system_memory_requirement, 0, job_sys_config);
+    app_state->job_system_state =
+        linear_allocator_allocate(&app_state->systems_allocator, app_state->job_system_memory_requirement);
+    if (!job_system_initialize(&app_state->job_system_memory_requirement, app_state->job_system_state,
+                               job_sys_config))
+    {
+        DFATAL("Failed to initialize job system. Aborting application.");
+        return false;
+    }
+
     // Resource system.
     resource_system_config resource_sys_config;
     resource_sys_config.asset_base_path  = "../assets";
     resource_sys_config.max_loader_count = 32;
+    // Enough to keep recently released textures decoded, so acquiring them again is cheap.
+    resource_sys_config.cache_budget     = 64 * 1024 * 1024;
     resource_system_initialize(&app_state->resource_system_memory_requirement, 0, resource_sys_config);
     app_state->resource_system_state =
         linear_allocator_allocate(&app_state->systems_allocator, app_state->resource_system_memory_requirement);
@@ -189,6 +246,11 @@ b8 application_create(game *game_inst)
         DFATAL("Failed to initialize resource system. Aborting application.");
         return false;
     }
+    // Load from the asset pack when one was built, falling back to loose files for anything not in it.
+    if (filesystem_exists("assets.dpk"))
+    {
+        resource_system_mount_pack("assets.dpk");
+    }
 
     // Renderer system
     renderer_system_initialize(&app_state->renderer_system_memory_requirement, 0, 0);
@@ -204,6 +266,7 @@ b8 application_create(game *game_inst)
     // Texture system.
     texture_system_config texture_sys_config;
     texture_sys_config.max_texture_count = 65536;
+    texture_sys_config.streaming_budget  = 256 * 1024 * 1024;
     texture_system_initialize(&app_state->texture_system_memory_requirement, 0, texture_sys_config);
     app_state->texture_system_state =
         linear_allocator_allocate(&app_state->systems_allocator, app_state->texture_system_memory_requirement);
@@ -240,6 +303,22 @@ b8 application_create(game *game_inst)
         return false;
     }
 
+#if defined(DEBUG)
+    // Asset watcher, for hot reload. Not needed to run, so failing to start it is not fatal.
+    asset_watcher_system_config asset_watcher_sys_config;
+    asset_watcher_sys_config.asset_base_path = resource_sys_config.asset_base_path;
+    asset_watcher_sys_config.settle_seconds  = 0.1;
+    asset_watcher_system_initialize(&app_state->asset_watcher_system_memory_requirement, 0, asset_watcher_sys_config);
+    app_state->asset_watcher_system_state = linear_allocator_allocate(
+        &app_state->systems_allocator, app_state->asset_watcher_system_memory_requirement);
+    if (!asset_watcher_system_initialize(&app_state->asset_watcher_system_memory_requirement,
+                                         app_state->asset_watcher_system_state, asset_watcher_sys_config))
+    {
+        DWARN("Failed to initialize asset watcher system. Assets will not be hot reloaded.");
+        app_state->asset_watcher_system_state = 0;
+    }
+#endif
+
     // TODO: temp
 
     // Load up a plane configuration, and load geometry from it.
@@ -280,13 +359,46 @@ b8 application_run()
 
     DINFO(get_memory_usage_str());
 
+    b8 pipelined     = app_state->game_inst->app_config.pipelined_rendering;
+    u32 packet_index = 0;
+    if (pipelined && !render_thread_start())
+    {
+        DWARN("Failed to start the render thread. Falling back to rendering on the main thread.");
+        pipelined = false;
+    }
+
     while (app_state->is_running)
     {
+        // Anything here may create or destroy renderer resources, so keep the render thread out.
+        if (pipelined)
+        {
+            f64 lock_start_time = platform_get_absolute_time();
+            platform_mutex_lock(&app_state->render_mutex);
+            app_state->render_lock_seconds += platform_get_absolute_time() - lock_start_time;
+        }
+
         if (!platform_pump_messages())
         {
             app_state->is_running = false;
         }
 
+        // Hand finished background loads over to their owners on this thread.
+        resource_system_pump_completions();
+
+        // Reload assets changed on disk. Also here, so nothing is swapped out while being drawn.
+        asset_watcher_system_update();
+
+        // Load the mip levels textures were last drawn needing.
+        texture_system_update();
+
+        // Deliver events posted since the last frame, including those from other threads.
+        event_dispatch_posted();
+
+        if (pipelined)
+        {
+            platform_mutex_unlock(&app_state->render_mutex);
+        }
+
         if (!app_state->is_suspended)
         {
             // Update clock and get delta time.
@@ -310,20 +422,27 @@ b8 application_run()
                 break;
             }
 
-            // TODO: refactor packet creation
-            render_packet packet;
-            packet.delta_time = delta;
-
-            // TODO: temp
-            geometry_render_data test_render;
-            test_render.geometry = app_state->test_geometry;
-            test_render.model    = mat4_identity();
-
-            packet.geometry_count = 1;
-            packet.geometries     = &test_render;
-            // TODO: end temp
-
-            renderer_draw_frame(&packet);
+            render_packet *packet = &app_state->packets[packet_index];
+            if (pipelined)
+            {
+                // Wait for the render thread to finish with this packet, then hand it back filled.
+                // The other packet is being drawn in the meantime.
+                f64 wait_start_time = platform_get_absolute_time();
+                platform_semaphore_wait(&app_state->packet_free);
+                app_state->render_wait_seconds += platform_get_absolute_time() - wait_start_time;
+                app_state->render_draw_seconds += app_state->packet_draw_seconds[packet_index];
+                app_state->render_timing_frames++;
+
+                build_render_packet(packet, (f32)delta);
+                platform_semaphore_signal(&app_state->packet_ready);
+                packet_index ^= 1;
+                log_render_timings();
+            }
+            else
+            {
+                build_render_packet(packet, (f32)delta);
+                renderer_draw_frame(packet, 0);
+            }
 
             // Figure out how long the frame took and, if below
             f64 frame_end_time     = platform_get_absolute_time();
@@ -358,6 +477,11 @@ b8 application_run()
 
     app_state->is_running = false;
 
+    if (pipelined)
+    {
+        render_thread_stop();
+    }
+
     // Shutdown event system.
     event_unregister(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event);
     event_unregister(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
@@ -368,6 +492,11 @@ b8 application_run()
 
     input_system_shutdown(app_state->input_system_state);
 
+    // Stop the workers first so no job touches a system after it shuts down.
+    job_system_shutdown(app_state->job_system_state);
+
+    asset_watcher_system_shutdown(app_state->asset_watcher_system_state);
+
     geometry_system_shutdown(app_state->geometry_system_state);
 
     material_system_shutdown(app_state->material_system_state);
@@ -380,6 +509,9 @@ b8 application_run()
 
     platform_system_shutdown(app_state->platform_system_state);
 
+    // Writes out anything still queued.
+    shutdown_logging(app_state->logging_system_state);
+
     memory_system_shutdown(app_state->memory_system_state);
 
     event_system_shutdown(app_state->event_system_state);
@@ -387,6 +519,116 @@ b8 application_run()
     return true;
 }
 
+static void build_render_packet(render_packet *packet, f32 delta_time)
+{
+    // TODO: refactor packet creation
+    packet->delta_time = delta_time;
+    packet->view       = renderer_get_view();
+
+    // TODO: temp
+    geometry_render_data *test_render = &app_state->packet_geometries[packet - app_state->packets];
+    test_render->geometry             = app_state->test_geometry;
+    test_render->model                = mat4_identity();
+
+    packet->geometry_count = 1;
+    packet->geometries     = test_render;
+    // TODO: end temp
+}
+
+static b8 render_thread_start()
+{
+    if (!platform_mutex_create(&app_state->render_mutex))
+    {
+        return false;
+    }
+    // Without the semaphores, nothing would keep the threads off each other's packets.
+    if (!platform_semaphore_create(0, &app_state->packet_ready))
+    {
+        platform_mutex_destroy(&app_state->render_mutex);
+        return false;
+    }
+    if (!platform_semaphore_create(2, &app_state->packet_free))
+    {
+        platform_semaphore_destroy(&app_state->packet_ready);
+        platform_mutex_destroy(&app_state->render_mutex);
+        return false;
+    }
+    app_state->render_thread_quit  = false;
+    app_state->render_timing_start = platform_get_absolute_time();
+
+    if (!platform_thread_create(render_thread_run, 0, &app_state->render_thread))
+    {
+        platform_semaphore_destroy(&app_state->packet_free);
+        platform_semaphore_destroy(&app_state->packet_ready);
+        platform_mutex_destroy(&app_state->render_mutex);
+        return false;
+    }
+
+    DINFO("Pipelined rendering enabled.");
+    return true;
+}
+
+static void render_thread_stop()
+{
+    // Let the render thread finish both packets, so it is idle when told to quit.
+    platform_semaphore_wait(&app_state->packet_free);
+    platform_semaphore_wait(&app_state->packet_free);
+
+    // The semaphore orders this write before the render thread reads it.
+    app_state->render_thread_quit = true;
+    platform_semaphore_signal(&app_state->packet_ready);
+    platform_thread_join(&app_state->render_thread);
+
+    platform_semaphore_destroy(&app_state->packet_free);
+    platform_semaphore_destroy(&app_state->packet_ready);
+    platform_mutex_destroy(&app_state->render_mutex);
+}
+
+static u32 render_thread_run(void *params)
+{
+    // Packets are built in order, so they are drawn in the same order.
+    u32 packet_index = 0;
+    for (;;)
+    {
+        platform_semaphore_wait(&app_state->packet_ready);
+        if (app_state->render_thread_quit)
+        {
+            break;
+        }
+
+        f64 draw_start_time = platform_get_absolute_time();
+        renderer_draw_frame(&app_state->packets[packet_index], &app_state->render_mutex);
+        app_state->packet_draw_seconds[packet_index] = platform_get_absolute_time() - draw_start_time;
+
+        packet_index ^= 1;
+        platform_semaphore_signal(&app_state->packet_free);
+    }
+    return 0;
+}
+
+// Logs, every few seconds, how long the render thread drew each frame for against how long the main thread waited
+// for it. Whatever was not waited for overlapped the main thread's work on the next frame.
+static void log_render_timings()
+{
+    f64 elapsed = platform_get_absolute_time() - app_state->render_timing_start;
+    if (elapsed < 5.0 || app_state->render_timing_frames == 0)
+    {
+        return;
+    }
+
+    f64 ms_per_frame = 1000.0 / app_state->render_timing_frames;
+    DDEBUG("Pipelined rendering: drawing took %.2f ms a frame. The main thread waited %.2f ms a frame for a packet "
+           "and %.2f ms for the resource lock.",
+           app_state->render_draw_seconds * ms_per_frame, app_state->render_wait_seconds * ms_per_frame,
+           app_state->render_lock_seconds * ms_per_frame);
+
+    app_state->render_timing_start += elapsed;
+    app_state->render_draw_seconds  = 0;
+    app_state->render_wait_seconds  = 0;
+    app_state->render_lock_seconds  = 0;
+    app_state->render_timing_frames = 0;
+}
+
 void application_get_framebuffer_size(u32 *width, u32 *height)
 {
     *width  = app_state->width;
@@ -21,6 +21,11 @@ typedef struct application_config
 
     // The application name used in windowing, if applicable.
     char *name;
+
+    // If true, frames are drawn on a separate render thread while the game simulates the
+    // next frame. The game's update and render must then not create or destroy renderer
+    // resources; post an event with event_post instead, whose handlers run between frames.
+    b8 pipelined_rendering;
 } application_config;
 
 DAPI b8 application_create(struct game *game_inst);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Atomic operations on plain integer and pointer variables.
+
+These wrap the __atomic builtins, which both clang and gcc provide on every
+platform the engine builds for (the Windows build also uses clang). Like
+darray.h, the macros are type-generic: they operate on whatever integer or
+pointer type ptr points to.
+
+Memory orders follow the C11 model. When in doubt, use DATOMIC_SEQ_CST.
+*/
+
+#if !defined(__clang__) && !defined(__GNUC__)
+#error "datomic.h requires clang or gcc __atomic builtins."
+#endif
+
+#define DATOMIC_RELAXED __ATOMIC_RELAXED
+#define DATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+#define DATOMIC_RELEASE __ATOMIC_RELEASE
+#define DATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+#define DATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+// Atomically reads *ptr.
+#define datomic_load(ptr, order) __atomic_load_n(ptr, order)
+
+// Atomically writes value to *ptr.
+#define datomic_store(ptr, value, order) __atomic_store_n(ptr, value, order)
+
+// Atomically writes value to *ptr and returns the previous value.
+#define datomic_exchange(ptr, value, order) __atomic_exchange_n(ptr, value, order)
+
+// Atomically adds value to *ptr and returns the previous value.
+#define datomic_fetch_add(ptr, value, order) __atomic_fetch_add(ptr, value, order)
+
+// Atomically subtracts value from *ptr and returns the previous value.
+#define datomic_fetch_sub(ptr, value, order) __atomic_fetch_sub(ptr, value, order)
+
+// Atomically ORs value into *ptr and returns the previous value.
+#define datomic_fetch_or(ptr, value, order) __atomic_fetch_or(ptr, value, order)
+
+// Atomically ANDs value into *ptr and returns the previous value.
+#define datomic_fetch_and(ptr, value, order) __atomic_fetch_and(ptr, value, order)
+
+/**
+ * Atomically replaces *ptr with desired if it equals *expected_ptr. Returns true on success.
+ * On failure, the current value of *ptr is written to *expected_ptr.
+ */
+#define datomic_compare_exchange(ptr, expected_ptr, desired, success_order, failure_order)                            \
+    __atomic_compare_exchange_n(ptr, expected_ptr, desired, false, success_order, failure_order)
+
+// Issues a memory fence with the given order.
+#define datomic_thread_fence(order) __atomic_thread_fence(order)
+
+// Hints to the CPU that the caller is spinning, to save power and free up a hyperthread.
+#if defined(__x86_64__) || defined(_M_X64)
+#define datomic_cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define datomic_cpu_relax() __asm__ __volatile__("yield")
+#else
+#define datomic_cpu_relax()
+#endif
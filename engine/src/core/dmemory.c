@@ -1,5 +1,6 @@
 #include "dmemory.h"
 
+#include "core/datomic.h"
 #include "core/dstring.h"
 #include "core/logger.h"
 #include "platform/platform.h"
@@ -50,14 +51,15 @@ void *dallocate(u64 size, memory_tag tag)
 {
     if (tag == MEMORY_TAG_UNKNOWN)
     {
-        DWARN("dallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+        DLOG_RATE_LIMITED(LOG_LEVEL_WARN, "dallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
     }
 
+    // Allocations can come from worker threads, so keep the stats consistent.
     if (state_ptr)
     {
-        state_ptr->stats.total_allocated += size;
-        state_ptr->stats.tagged_allocations[tag] += size;
-        state_ptr->alloc_count++;
+        datomic_fetch_add(&state_ptr->stats.total_allocated, size, DATOMIC_RELAXED);
+        datomic_fetch_add(&state_ptr->stats.tagged_allocations[tag], size, DATOMIC_RELAXED);
+        datomic_fetch_add(&state_ptr->alloc_count, 1, DATOMIC_RELAXED);
     }
 
     // TODO: Memory alignment
@@ -70,12 +72,12 @@ void dfree(void *block, u64 size, memory_tag tag)
 {
     if (tag == MEMORY_TAG_UNKNOWN)
     {
-        DWARN("dfree called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+        DLOG_RATE_LIMITED(LOG_LEVEL_WARN, "dfree called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
     }
     if (state_ptr)
     {
-        state_ptr->stats.total_allocated -= size;
-        state_ptr->stats.tagged_allocations[tag] -= size;
+        datomic_fetch_sub(&state_ptr->stats.total_allocated, size, DATOMIC_RELAXED);
+        datomic_fetch_sub(&state_ptr->stats.tagged_allocations[tag], size, DATOMIC_RELAXED);
     }
 
     // TODO: Memory alignment
@@ -58,7 +58,16 @@ s32 string_format_v(char *dest, const char *format, void *va_listp)
     {
         // Big, but can fit on the stack.
         char buffer[32000];
-        s32 written     = vsnprintf(buffer, 32000, format, va_listp);
+        s32 written = vsnprintf(buffer, 32000, format, va_listp);
+        if (written < 0)
+        {
+            return -1;
+        }
+        if (written >= 32000)
+        {
+            // Truncated.
+            written = 32000 - 1;
+        }
         buffer[written] = 0;
         dcopy_memory(dest, buffer, written + 1);
 
@@ -67,6 +76,25 @@ s32 string_format_v(char *dest, const char *format, void *va_listp)
     return -1;
 }
 
+s32 string_format_n_v(char *dest, u64 max_length, const char *format, void *va_listp)
+{
+    if (dest)
+    {
+        s32 written = vsnprintf(dest, max_length + 1, format, va_listp);
+        if (written < 0)
+        {
+            return -1;
+        }
+        if ((u64)written > max_length)
+        {
+            // Truncated.
+            written = max_length;
+        }
+        return written;
+    }
+    return -1;
+}
+
 char *string_empty(char *str)
 {
     if (str)
@@ -162,6 +190,111 @@ s32 string_index_of(char *str, char c)
     return -1;
 }
 
+string_view string_view_create(const char *data, u64 length)
+{
+    string_view view;
+    view.data   = data;
+    view.length = length;
+    return view;
+}
+
+string_view string_view_trim(string_view view)
+{
+    while (view.length && isspace((unsigned char)view.data[0]))
+    {
+        view.data++;
+        view.length--;
+    }
+    while (view.length && isspace((unsigned char)view.data[view.length - 1]))
+    {
+        view.length--;
+    }
+    return view;
+}
+
+string_view string_view_mid(string_view view, u64 start, s64 length)
+{
+    if (start >= view.length)
+    {
+        return string_view_create(view.data + view.length, 0);
+    }
+    u64 available = view.length - start;
+    if (length < 0 || (u64)length > available)
+    {
+        length = available;
+    }
+    return string_view_create(view.data + start, length);
+}
+
+s64 string_view_index_of(string_view view, char c)
+{
+    const char *found = view.length ? memchr(view.data, c, view.length) : 0;
+    return found ? found - view.data : -1;
+}
+
+b8 string_view_equali(string_view view, const char *str)
+{
+    if (string_length(str) != view.length)
+    {
+        return false;
+    }
+#if defined(__GNUC__)
+    return strncasecmp(view.data, str, view.length) == 0;
+#elif (defined _MSC_VER)
+    return _strnicmp(view.data, str, view.length) == 0;
+#endif
+}
+
+u64 string_view_copy(char *dest, string_view view, u64 max_length)
+{
+    u64 length = view.length < max_length ? view.length : max_length;
+    dcopy_memory(dest, view.data, length);
+    dest[length] = 0;
+    return length;
+}
+
+b8 string_view_next_line(string_view *remaining, string_view *out_line)
+{
+    if (remaining->length == 0)
+    {
+        return false;
+    }
+
+    s64 newline_index = string_view_index_of(*remaining, '\n');
+    u64 line_length   = newline_index >= 0 ? (u64)newline_index : remaining->length;
+    u64 consumed      = newline_index >= 0 ? line_length + 1 : line_length;
+
+    *out_line = string_view_create(remaining->data, line_length);
+    if (out_line->length && out_line->data[out_line->length - 1] == '\r')
+    {
+        out_line->length--;
+    }
+
+    remaining->data += consumed;
+    remaining->length -= consumed;
+    return true;
+}
+
+b8 string_view_next_token(string_view *remaining, string_view *out_token)
+{
+    *remaining = string_view_trim(*remaining);
+    if (remaining->length == 0)
+    {
+        return false;
+    }
+
+    u64 length = 0;
+    while (length < remaining->length && !isspace((unsigned char)remaining->data[length]))
+    {
+        length++;
+    }
+
+    *out_token = string_view_create(remaining->data, length);
+    remaining->data += length;
+    remaining->length -= length;
+    return true;
+}
+
 b8 string_to_vec4(char *str, vec4 *out_vector)
 {
     if (!str)
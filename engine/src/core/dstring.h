@@ -27,6 +27,17 @@ DAPI s32 string_format(char *dest, const char *format, ...);
  */
 DAPI s32 string_format_v(char *dest, const char *format, void *va_list);
 
+/**
+ * Performs variadic string formatting directly into dest, writing at most max_length
+ * characters plus a null terminator. Output beyond that is truncated.
+ * @param dest The destination for the formatted string. Must hold at least max_length + 1 characters.
+ * @param max_length The maximum number of characters to write, excluding the null terminator.
+ * @param format The string to be formatted.
+ * @param va_list The variadic argument list.
+ * @returns The number of characters written, excluding the null terminator; or -1 on error.
+ */
+DAPI s32 string_format_n_v(char *dest, u64 max_length, const char *format, void *va_list);
+
 /**
  * @brief Empties the provided string by setting the first character to 0.
  *
@@ -52,6 +63,64 @@ DAPI void string_mid(char *dest, const char *source, s32 start, s32 length);
  */
 DAPI s32 string_index_of(char *str, char c);
 
+// A non-owning slice of a larger string, such as a line of a loaded file. Not null-terminated.
+typedef struct string_view
+{
+    const char *data;
+    u64 length;
+} string_view;
+
+// Creates a view of the first length characters at data.
+DAPI string_view string_view_create(const char *data, u64 length);
+
+// Returns the view with leading and trailing whitespace removed.
+DAPI string_view string_view_trim(string_view view);
+
+/**
+ * @brief Returns a view of up to length characters of view, starting at start. Clamped to the end of view.
+ *
+ * @param view The view to take a slice of.
+ * @param start The index of the first character.
+ * @param length The maximum number of characters. -1 takes the rest of the view.
+ * @return The slice.
+ */
+DAPI string_view string_view_mid(string_view view, u64 start, s64 length);
+
+// Returns the index of the first occurance of c in view; otherwise -1.
+DAPI s64 string_view_index_of(string_view view, char c);
+
+// Case-insensitive comparison of a view against a null-terminated string. True if the same, otherwise false.
+DAPI b8 string_view_equali(string_view view, const char *str);
+
+/**
+ * @brief Copies a view into dest as a null-terminated string, truncating it if needed.
+ *
+ * @param dest The destination. Must hold at least max_length + 1 characters.
+ * @param view The view to be copied.
+ * @param max_length The maximum number of characters to copy, excluding the null terminator.
+ * @return The number of characters copied.
+ */
+DAPI u64 string_view_copy(char *dest, string_view view, u64 max_length);
+
+/**
+ * @brief Takes the next line from the front of remaining. Handles both '\n' and "\r\n" line endings,
+ * neither of which is included in out_line. Lets text be parsed in place, a line at a time.
+ *
+ * @param remaining The text left to scan. Advanced past the line.
+ * @param out_line A pointer to hold the line.
+ * @return True if a line was taken; false once remaining is empty.
+ */
+DAPI b8 string_view_next_line(string_view *remaining, string_view *out_line);
+
+/**
+ * @brief Takes the next whitespace-delimited token from the front of remaining.
+ *
+ * @param remaining The text left to scan. Advanced past the token.
+ * @param out_token A pointer to hold the token.
+ * @return True if a token was taken; false if only whitespace remains.
+ */
+DAPI b8 string_view_next_token(string_view *remaining, string_view *out_token);
+
 /**
  * @brief Attempts to parse a vector from the provided string.
  *
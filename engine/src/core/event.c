@@ -1,7 +1,9 @@
 #include "core/event.h"
 
 #include "containers/darray.h"
+#include "core/datomic.h"
 #include "core/dmemory.h"
+#include "core/logger.h"
 
 typedef struct registered_event
 {
@@ -12,16 +14,43 @@ typedef struct registered_event
 typedef struct event_code_entry
 {
     registered_event *events;
+    // If set, only the most recent posted event of this code is dispatched per drain.
+    b8 coalesce;
+    // Queue position of the most recent posted event of this code, found while draining.
+    u64 last_posted;
 } event_code_entry;
 
 // This should be more than enough codes...
 #define MAX_MESSAGE_CODES 16384
 
+// The number of events that can be posted between drains. Must be a power of 2.
+#define MAX_POSTED_EVENTS 4096
+
+/*
+A slot in the posted event queue. This is a bounded multi-producer queue as
+described by Dmitry Vyukov: a slot is free for the producer at position pos
+when its sequence equals pos, and ready for the consumer when it equals pos + 1.
+*/
+typedef struct posted_event
+{
+    volatile u64 sequence;
+    u16 code;
+    void *sender;
+    event_context context;
+} posted_event;
+
 // State structure.
 typedef struct event_system_state
 {
     // Lookup table for event codes.
     event_code_entry registered[MAX_MESSAGE_CODES];
+
+    // Claimed by producers on any thread. Kept on its own cache line from the consumer position.
+    volatile u64 post_position;
+    u8 padding[56];
+    // Only ever touched by the thread that drains the queue.
+    u64 drain_position;
+    posted_event posted[MAX_POSTED_EVENTS];
 } event_system_state;
 
 /**
@@ -36,8 +65,17 @@ void event_system_initialize(u64 *memory_requirement, void *state)
     {
         return;
     }
-    dzero_memory(state, sizeof(state));
+    dzero_memory(state, sizeof(event_system_state));
     state_ptr = state;
+
+    for (u64 i = 0; i < MAX_POSTED_EVENTS; ++i)
+    {
+        state_ptr->posted[i].sequence = i;
+    }
+
+    // These can arrive many times a frame, but only the latest value matters.
+    state_ptr->registered[EVENT_CODE_MOUSE_MOVED].coalesce = true;
+    state_ptr->registered[EVENT_CODE_RESIZED].coalesce     = true;
 }
 
 void event_system_shutdown(void *state)
@@ -138,11 +176,102 @@ b8 event_fire(u16 code, void *sender, event_context context)
         registered_event e = state_ptr->registered[code].events[i];
         if (e.callback(code, sender, e.listener, context))
         {
-            // Message has been handled, do not send to other listeners.
+            // Message has been handled, do not send to other listeners. Events fire constantly, so these are
+            // logged without formatting.
+            DLOG_BINARY(LOG_LEVEL_TRACE, "event_fire - Code %u handled by listener %u of %u.", code, (u32)i + 1,
+                        (u32)registered_count);
             return true;
         }
     }
 
     // Not found.
+    DLOG_BINARY(LOG_LEVEL_TRACE, "event_fire - Code %u not handled by any of %u listeners.", code,
+                (u32)registered_count);
     return false;
 }
+
+b8 event_post(u16 code, void *sender, event_context context)
+{
+    if (!state_ptr)
+    {
+        return false;
+    }
+
+    posted_event *slot = 0;
+    u64 position       = datomic_load(&state_ptr->post_position, DATOMIC_RELAXED);
+    for (;;)
+    {
+        slot         = &state_ptr->posted[position & (MAX_POSTED_EVENTS - 1)];
+        u64 sequence = datomic_load(&slot->sequence, DATOMIC_ACQUIRE);
+        s64 diff     = (s64)sequence - (s64)position;
+        if (diff == 0)
+        {
+            // The slot is free. Try to claim it.
+            if (datomic_compare_exchange(&state_ptr->post_position, &position, position + 1, DATOMIC_RELAXED,
+                                         DATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The queue is full, and has not been drained since it filled up.
+            DWARN("event_post - Queue is full, dropping event code %i.", code);
+            return false;
+        }
+        else
+        {
+            // Another producer claimed this slot first. Move on.
+            position = datomic_load(&state_ptr->post_position, DATOMIC_RELAXED);
+        }
+    }
+
+    slot->code    = code;
+    slot->sender  = sender;
+    slot->context = context;
+    datomic_store(&slot->sequence, position + 1, DATOMIC_RELEASE);
+    return true;
+}
+
+void event_dispatch_posted()
+{
+    if (!state_ptr)
+    {
+        return;
+    }
+
+    // Only dispatch what was posted before this call, so listeners that post again cannot
+    // keep the drain going forever. Slots are not released until the second pass.
+    u64 start = state_ptr->drain_position;
+    u64 end   = start;
+    while (end - start < MAX_POSTED_EVENTS)
+    {
+        posted_event *slot = &state_ptr->posted[end & (MAX_POSTED_EVENTS - 1)];
+        if (datomic_load(&slot->sequence, DATOMIC_ACQUIRE) != end + 1)
+        {
+            break;
+        }
+        state_ptr->registered[slot->code].last_posted = end;
+        end++;
+    }
+
+    for (u64 position = start; position < end; ++position)
+    {
+        posted_event *slot    = &state_ptr->posted[position & (MAX_POSTED_EVENTS - 1)];
+        u16 code              = slot->code;
+        void *sender          = slot->sender;
+        event_context context = slot->context;
+
+        // Hand the slot back to producers before firing, as listeners may post.
+        datomic_store(&slot->sequence, position + MAX_POSTED_EVENTS, DATOMIC_RELEASE);
+        state_ptr->drain_position = position + 1;
+
+        event_code_entry *entry = &state_ptr->registered[code];
+        if (entry->coalesce && entry->last_posted != position)
+        {
+            // A newer event of the same code follows in this drain.
+            continue;
+        }
+        event_fire(code, sender, context);
+    }
+}
@@ -60,6 +60,23 @@ DAPI b8 event_unregister(u16 code, void *listener, PFN_on_event on_event);
  */
 DAPI b8 event_fire(u16 code, void *sender, event_context context);
 
+/**
+ * Queues an event to be fired on the main thread during the next call to event_dispatch_posted.
+ * Safe to call from any thread, and does not block. Repeated mouse moved and resized events
+ * posted between dispatches are coalesced into the most recent one.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender. Can be 0/NULL. Must still be valid when the event is dispatched.
+ * @param data The event data.
+ * @returns true if the event was queued; false if the queue is full.
+ */
+DAPI b8 event_post(u16 code, void *sender, event_context context);
+
+/**
+ * Fires all events posted since the last call, in the order they were posted.
+ * Called once per frame by the application.
+ */
+void event_dispatch_posted();
+
 // System internal event codes. Application should use codes beyond 255.
 typedef enum system_event_code
 {
@@ -125,11 +125,11 @@ void input_process_mouse_move(s16 x, s16 y)
         state_ptr->mouse_current.x = x;
         state_ptr->mouse_current.y = y;
 
-        // Fire the event.
+        // Post the event. Several moves in one frame are coalesced into the last.
         event_context context;
         context.data.u16[0] = x;
         context.data.u16[1] = y;
-        event_fire(EVENT_CODE_MOUSE_MOVED, 0, context);
+        event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
     }
 }
 
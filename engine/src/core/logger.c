@@ -1,5 +1,7 @@
 #include "logger.h"
 #include "asserts.h"
+#include "containers/darray.h"
+#include "core/datomic.h"
 #include "core/dmemory.h"
 #include "core/dstring.h"
 #include "platform/filesystem.h"
@@ -7,28 +9,292 @@
 
 // TODO: temporary
 #include <stdarg.h>
+#include <stdlib.h> // qsort
+
+// Technically imposes a 32k character limit on a single log entry, but...
+// DON'T DO THAT!
+#define LOG_MESSAGE_MAX_LENGTH 32000
+
+// Size of the queue between logging threads and the writer thread.
+#define LOG_RING_BUFFER_SIZE (256 * 1024)
+
+// Size of the block of text written to the log file at once.
+#define LOG_FILE_BATCH_SIZE (64 * 1024)
+
+// The longest a message sits in a log file buffer before being written out. Fatal errors are written at once.
+#define LOG_FILE_FLUSH_INTERVAL_MS 250
+
+// Size of each thread's binary log buffer. Must fit in a single ring buffer entry.
+#define LOG_BINARY_BUFFER_SIZE (16 * 1024)
+
+// Format strings longer than this are truncated in binary logs.
+#define LOG_BINARY_MAX_FORMAT_LENGTH 4096
+
+// Ring buffer entries with this level hold a block of binary log records rather than text.
+#define LOG_ENTRY_BINARY 0xFF
+
+// Precedes each message in the ring buffer. The message itself is not null-terminated.
+typedef struct log_entry_header
+{
+    u32 length;
+    u8 level;
+} log_entry_header;
+
+// Binary log records from a single thread, waiting to be handed to the writer.
+typedef struct log_binary_buffer
+{
+    u32 length;
+    // All buffers are linked, so shutdown_logging can flush every thread's records.
+    struct log_binary_buffer *next;
+    u8 data[LOG_BINARY_BUFFER_SIZE];
+} log_binary_buffer;
 
 typedef struct logger_system_state
 {
-    file_handle log_file_handle;
+    // Both owned by the writer thread once it is running.
+    file_writer log_file;
+    file_writer binary_file;
+
+    // Every thread's binary log buffer, guarded by ring_mutex.
+    log_binary_buffer *binary_buffers;
+    // The last format id handed out to a DLOG_BINARY call site.
+    u32 last_format_id;
+
+    // Messages are queued in a ring buffer and written by a background thread, so
+    // logging threads never wait on the console or the disk.
+    platform_thread writer_thread;
+    platform_mutex ring_mutex;
+    // Signalled when entries are queued, or when the writer should quit.
+    platform_condition entries_available;
+    // Broadcast each time the writer finishes a batch and frees up space.
+    platform_condition batch_written;
+    // Total bytes ever queued and written. Positions in the ring are these modulo its size.
+    u64 write_position;
+    u64 read_position;
+    b8 writer_quit;
+    u8 ring[LOG_RING_BUFFER_SIZE];
+
+    // Owned by the writer thread.
+    char writer_message[LOG_MESSAGE_MAX_LENGTH + 1];
+    // When the writer last reported suppressed messages, in milliseconds.
+    u64 last_suppressed_report_ms;
 } logger_system_state;
 
 static logger_system_state *state_ptr;
 
-void append_to_log_file(const char *message)
+// Every rate-limited call site that has suppressed a message. Call sites outlive the logger,
+// and are never unregistered, so this is kept outside its state.
+static log_rate_limit *registered_rate_limits;
+
+static const char *level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
+
+// Every level prefix is this long, so it can be copied without measuring it.
+#define LOG_LEVEL_PREFIX_LENGTH 9
+
+// Each thread formats into its own buffer, so log_output needs neither a lock nor a large
+// stack frame. Never zeroed; messages are length-delimited.
+static DTHREADLOCAL char thread_message_buffer[LOG_MESSAGE_MAX_LENGTH];
+
+// Created on a thread's first binary log call.
+static DTHREADLOCAL log_binary_buffer *thread_binary_buffer;
+
+static u32 log_writer_run(void *params);
+
+static void append_to_log_file(logger_system_state *state, const char *message, u64 length)
 {
-    if (state_ptr && state_ptr->log_file_handle.is_valid)
+    if (state->log_file.is_valid)
     {
         // Since the message already contains a '\n', just write the bytes directly.
-        u64 length  = string_length(message);
-        u64 written = 0;
-        if (!filesystem_write(&state_ptr->log_file_handle, length, message, &written))
+        if (!filesystem_writer_write(&state->log_file, length, message))
         {
             platform_console_write_error("ERROR writing to console.log.", LOG_LEVEL_ERROR);
         }
     }
 }
 
+static void write_to_console(const char *message, log_level level)
+{
+    b8 is_error = level < LOG_LEVEL_WARN;
+    if (is_error)
+    {
+        platform_console_write_error(message, level);
+    }
+    else
+    {
+        platform_console_write(message, level);
+    }
+}
+
+// Copies size bytes into the ring at position, wrapping around its end if needed.
+static void ring_write(u64 position, const void *data, u64 size)
+{
+    u64 offset = position % LOG_RING_BUFFER_SIZE;
+    u64 first  = LOG_RING_BUFFER_SIZE - offset;
+    if (first > size)
+    {
+        first = size;
+    }
+    dcopy_memory(state_ptr->ring + offset, data, first);
+    dcopy_memory(state_ptr->ring, (const u8 *)data + first, size - first);
+}
+
+// Copies size bytes out of the ring at position, wrapping around its end if needed.
+static void ring_read(logger_system_state *state, u64 position, void *out_data, u64 size)
+{
+    u64 offset = position % LOG_RING_BUFFER_SIZE;
+    u64 first  = LOG_RING_BUFFER_SIZE - offset;
+    if (first > size)
+    {
+        first = size;
+    }
+    dcopy_memory(out_data, state->ring + offset, first);
+    dcopy_memory((u8 *)out_data + first, state->ring, size - first);
+}
+
+// Reports messages suppressed by call sites whose interval has ended, which would otherwise wait for
+// the site's next message. Runs on the writer thread at most once per LOG_RATE_LIMIT_INTERVAL_MS, or
+// every time with force, to report everything still pending at shutdown.
+static void report_suppressed_messages(logger_system_state *state, b8 force)
+{
+    u64 now_ms = (u64)(platform_get_absolute_time() * 1000.0);
+    if (!force && now_ms - state->last_suppressed_report_ms < LOG_RATE_LIMIT_INTERVAL_MS)
+    {
+        return;
+    }
+    state->last_suppressed_report_ms = now_ms;
+
+    log_rate_limit *limit = datomic_load(&registered_rate_limits, DATOMIC_ACQUIRE);
+    for (; limit; limit = limit->next)
+    {
+        u64 start_ms = datomic_load(&limit->interval_start_ms, DATOMIC_RELAXED);
+        if (!force && now_ms - start_ms < limit->interval_ms)
+        {
+            continue;
+        }
+
+        // Taken the same way log_rate_limit_allow takes it, so each message is only counted once.
+        u32 suppressed = datomic_exchange(&limit->suppressed, 0, DATOMIC_RELAXED);
+        if (suppressed)
+        {
+            char *message = state->writer_message;
+            s32 length    = string_format(message, "%s%u messages like \"%.256s\" were suppressed.\n",
+                                          level_strings[limit->level], suppressed, limit->format);
+            write_to_console(message, limit->level);
+            append_to_log_file(state, message, length > 0 ? length : 0);
+        }
+    }
+}
+
+// Runs on the writer thread, which is given the state before state_ptr is set.
+static u32 log_writer_run(void *params)
+{
+    logger_system_state *state = params;
+    for (;;)
+    {
+        // Wait for something to write, then take everything queued so far as one batch. While the
+        // files hold unwritten data, or call sites may have suppressed messages to report, wake up
+        // periodically to deal with them even if nothing new arrives.
+        platform_mutex_lock(&state->ring_mutex);
+        while (state->read_position == state->write_position && !state->writer_quit)
+        {
+            if (state->log_file.length || state->binary_file.length ||
+                datomic_load(&registered_rate_limits, DATOMIC_RELAXED))
+            {
+                platform_condition_wait_timeout(&state->entries_available, &state->ring_mutex,
+                                                LOG_FILE_FLUSH_INTERVAL_MS);
+                platform_mutex_unlock(&state->ring_mutex);
+                report_suppressed_messages(state, false);
+                filesystem_writer_update(&state->log_file);
+                filesystem_writer_update(&state->binary_file);
+                platform_mutex_lock(&state->ring_mutex);
+            }
+            else
+            {
+                platform_condition_wait(&state->entries_available, &state->ring_mutex);
+            }
+        }
+        u64 start = state->read_position;
+        u64 end   = state->write_position;
+        b8 quit   = state->writer_quit;
+        platform_mutex_unlock(&state->ring_mutex);
+
+        // Producers never write past read_position, so this range is safe to read unlocked.
+        u64 position = start;
+        while (position < end)
+        {
+            log_entry_header header;
+            ring_read(state, position, &header, sizeof(log_entry_header));
+            position += sizeof(log_entry_header);
+
+            char *message = state->writer_message;
+            ring_read(state, position, message, header.length);
+            message[header.length] = 0;
+            position += header.length;
+
+            if (header.level == LOG_ENTRY_BINARY)
+            {
+                filesystem_writer_write(&state->binary_file, header.length, message);
+                continue;
+            }
+
+            write_to_console(message, header.level);
+            append_to_log_file(state, message, header.length);
+
+            // Fatal errors usually precede a crash. Binary records logged before this were queued ahead of it.
+            if (header.level == LOG_LEVEL_FATAL)
+            {
+                filesystem_writer_notify_fatal(&state->log_file);
+                filesystem_writer_notify_fatal(&state->binary_file);
+            }
+        }
+
+        platform_mutex_lock(&state->ring_mutex);
+        state->read_position = end;
+        platform_condition_broadcast(&state->batch_written);
+        platform_mutex_unlock(&state->ring_mutex);
+
+        if (quit && start == end)
+        {
+            report_suppressed_messages(state, true);
+            break;
+        }
+        report_suppressed_messages(state, false);
+    }
+    return 0;
+}
+
+// Queues a formatted message for the writer thread. Blocks if the ring is full.
+static void enqueue_message(u8 level, const char *message, u32 length)
+{
+    log_entry_header header;
+    header.length = length;
+    header.level  = level;
+    u64 size      = sizeof(log_entry_header) + length;
+
+    platform_mutex_lock(&state_ptr->ring_mutex);
+    while (LOG_RING_BUFFER_SIZE - (state_ptr->write_position - state_ptr->read_position) < size)
+    {
+        platform_condition_wait(&state_ptr->batch_written, &state_ptr->ring_mutex);
+    }
+    ring_write(state_ptr->write_position, &header, sizeof(log_entry_header));
+    ring_write(state_ptr->write_position + sizeof(log_entry_header), message, length);
+    state_ptr->write_position += size;
+    platform_condition_signal(&state_ptr->entries_available);
+    platform_mutex_unlock(&state_ptr->ring_mutex);
+}
+
+// Blocks until everything queued before this call has been written.
+static void flush_queued_messages()
+{
+    platform_mutex_lock(&state_ptr->ring_mutex);
+    u64 target = state_ptr->write_position;
+    while (state_ptr->read_position < target)
+    {
+        platform_condition_wait(&state_ptr->batch_written, &state_ptr->ring_mutex);
+    }
+    platform_mutex_unlock(&state_ptr->ring_mutex);
+}
+
 b8 initialize_logging(u64 *memory_requirement, void *state)
 {
     *memory_requirement = sizeof(logger_system_state);
@@ -37,15 +303,65 @@ b8 initialize_logging(u64 *memory_requirement, void *state)
         return true;
     }
 
-    state_ptr = state;
+    // Everything is set up before state_ptr is, so messages logged meanwhile, such as errors opening the files,
+    // go straight to the console rather than into a ring nothing reads.
+    state_ptr                         = 0;
+    logger_system_state *logger_state = state;
 
     // Create new/wipe existing log file, then open it.
-    if (!filesystem_open("console.log", FILE_MODE_WRITE, false, &state_ptr->log_file_handle))
+    file_writer_config file_config;
+    file_config.buffer_size       = LOG_FILE_BATCH_SIZE;
+    file_config.flush_policy      = FILE_FLUSH_ON_SIZE | FILE_FLUSH_ON_INTERVAL | FILE_FLUSH_ON_FATAL;
+    file_config.flush_interval_ms = LOG_FILE_FLUSH_INTERVAL_MS;
+    if (!filesystem_writer_open("console.log", false, file_config, &logger_state->log_file))
     {
         platform_console_write_error("ERROR: Unable to open console.log for writing.", LOG_LEVEL_ERROR);
         return false;
     }
 
+    // Binary logging still works without its own file; its records are just dropped.
+    if (filesystem_writer_open("console.blog", true, file_config, &logger_state->binary_file))
+    {
+        u32 header[2] = {LOG_BINARY_MAGIC, LOG_BINARY_VERSION};
+        filesystem_writer_write(&logger_state->binary_file, sizeof(header), header);
+    }
+    else
+    {
+        platform_console_write_error("ERROR: Unable to open console.blog for writing.", LOG_LEVEL_ERROR);
+    }
+
+    logger_state->write_position = 0;
+    logger_state->read_position  = 0;
+    logger_state->writer_quit    = false;
+    logger_state->binary_buffers = 0;
+    logger_state->last_format_id = 0;
+
+    logger_state->last_suppressed_report_ms = 0;
+    b8 mutex_created     = platform_mutex_create(&logger_state->ring_mutex);
+    b8 available_created = mutex_created && platform_condition_create(&logger_state->entries_available);
+    b8 written_created   = available_created && platform_condition_create(&logger_state->batch_written);
+    if (!written_created || !platform_thread_create(log_writer_run, logger_state, &logger_state->writer_thread))
+    {
+        platform_console_write_error("ERROR: Unable to start the log writer thread.", LOG_LEVEL_ERROR);
+        if (written_created)
+        {
+            platform_condition_destroy(&logger_state->batch_written);
+        }
+        if (available_created)
+        {
+            platform_condition_destroy(&logger_state->entries_available);
+        }
+        if (mutex_created)
+        {
+            platform_mutex_destroy(&logger_state->ring_mutex);
+        }
+        filesystem_writer_close(&logger_state->log_file);
+        filesystem_writer_close(&logger_state->binary_file);
+        return false;
+    }
+
+    state_ptr = logger_state;
+
     // TODO: Remove this
     DFATAL("A test message: %f", 3.14f);
     DERROR("A test message: %f", 3.14f);
@@ -60,47 +376,614 @@ b8 initialize_logging(u64 *memory_requirement, void *state)
 
 void shutdown_logging(void *state)
 {
-    // TODO: cleanup logging/write queued entries.
+    if (state_ptr)
+    {
+        // Other threads should be done logging by now, so their binary buffers can be flushed from here.
+        log_binary_buffer *buffer = state_ptr->binary_buffers;
+        while (buffer)
+        {
+            log_binary_buffer *next = buffer->next;
+            if (buffer->length)
+            {
+                enqueue_message(LOG_ENTRY_BINARY, (const char *)buffer->data, buffer->length);
+            }
+            dfree(buffer, sizeof(log_binary_buffer), MEMORY_TAG_APPLICATION);
+            buffer = next;
+        }
+        state_ptr->binary_buffers = 0;
+        thread_binary_buffer      = 0;
+
+        // The writer drains everything still queued before it exits.
+        platform_mutex_lock(&state_ptr->ring_mutex);
+        state_ptr->writer_quit = true;
+        platform_condition_signal(&state_ptr->entries_available);
+        platform_mutex_unlock(&state_ptr->ring_mutex);
+        platform_thread_join(&state_ptr->writer_thread);
+
+        platform_condition_destroy(&state_ptr->batch_written);
+        platform_condition_destroy(&state_ptr->entries_available);
+        platform_mutex_destroy(&state_ptr->ring_mutex);
+        filesystem_writer_close(&state_ptr->log_file);
+        filesystem_writer_close(&state_ptr->binary_file);
+    }
     state_ptr = 0;
 }
 
 void log_output(log_level level, const char *message, ...)
 {
-    // TODO: These string operations are all pretty slow. This needs to be
-    // moved to another thread eventually, along with the file writes, to
-    // avoid slowing things down while the engine is trying to run.
-    const char *level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
-    b8 is_error                  = level < LOG_LEVEL_WARN;
-
-    // Technically imposes a 32k character limit on a single log entry, but...
-    // DON'T DO THAT!
-    char out_message[32000];
-    dzero_memory(out_message, sizeof(out_message));
+    // Write the prefix, message and newline straight into the buffer in a single pass.
+    char *out_message = thread_message_buffer;
+    dcopy_memory(out_message, level_strings[level], LOG_LEVEL_PREFIX_LENGTH);
 
-    // Format original message.
     // NOTE: Oddly enough, MS's headers override the GCC/Clang va_list type with a "typedef char* va_list" in some
     // cases, and as a result throws a strange error here. The workaround for now is to just use __builtin_va_list,
     // which is the type GCC/Clang's va_start expects.
     __builtin_va_list arg_ptr;
     va_start(arg_ptr, message);
-    string_format_v(out_message, message, arg_ptr);
+    // Leave room for the newline and null terminator.
+    s32 written = string_format_n_v(out_message + LOG_LEVEL_PREFIX_LENGTH,
+                                    LOG_MESSAGE_MAX_LENGTH - LOG_LEVEL_PREFIX_LENGTH - 2, message, arg_ptr);
     va_end(arg_ptr);
 
-    // Prepend log level to message.
-    string_format(out_message, "%s%s\n", level_strings[level], out_message);
+    u32 length            = LOG_LEVEL_PREFIX_LENGTH + (written > 0 ? written : 0);
+    out_message[length++] = '\n';
+    out_message[length]   = 0;
 
-    // Print accordingly
-    if (is_error)
+    if (!state_ptr)
     {
-        platform_console_write_error(out_message, level);
+        // Logging is not running (yet), so print directly.
+        write_to_console(out_message, level);
+        return;
     }
-    else
+
+    // Fatal errors usually precede a crash, so make sure everything up to here is on disk. The
+    // writer flushes its files when it reaches a fatal message, so queue binary records first.
+    if (level == LOG_LEVEL_FATAL)
+    {
+        log_binary_flush();
+    }
+
+    // Hand the message to the writer thread.
+    enqueue_message(level, out_message, length);
+
+    if (level == LOG_LEVEL_FATAL)
+    {
+        flush_queued_messages();
+    }
+}
+
+b8 log_rate_limit_allow(log_rate_limit *limit, u32 burst, u64 interval_ms, u32 *out_suppressed)
+{
+    *out_suppressed = 0;
+    u64 now_ms      = (u64)(platform_get_absolute_time() * 1000.0);
+    u64 start_ms    = datomic_load(&limit->interval_start_ms, DATOMIC_RELAXED);
+
+    // The first thread to see an interval has ended starts the next one, and reports what was dropped.
+    if (start_ms == 0 || now_ms - start_ms >= interval_ms)
     {
-        platform_console_write(out_message, level);
+        if (datomic_compare_exchange(&limit->interval_start_ms, &start_ms, now_ms, DATOMIC_ACQ_REL,
+                                     DATOMIC_RELAXED))
+        {
+            datomic_store(&limit->logged, 1, DATOMIC_RELAXED);
+            *out_suppressed = datomic_exchange(&limit->suppressed, 0, DATOMIC_RELAXED);
+            return true;
+        }
     }
 
-    // Queue a copy to be written to the log file.
-    append_to_log_file(out_message);
+    // Counts are only approximate while an interval rolls over, which is fine for this.
+    if (datomic_fetch_add(&limit->logged, 1, DATOMIC_RELAXED) < burst)
+    {
+        return true;
+    }
+    datomic_fetch_add(&limit->suppressed, 1, DATOMIC_RELAXED);
+
+    // Register with the log writer, so this gets reported even if the call site goes quiet.
+    if (limit->format && !datomic_load(&limit->registered, DATOMIC_RELAXED) &&
+        datomic_exchange(&limit->registered, 1, DATOMIC_ACQ_REL) == 0)
+    {
+        limit->interval_ms   = interval_ms;
+        log_rate_limit *head = datomic_load(&registered_rate_limits, DATOMIC_RELAXED);
+        do
+        {
+            limit->next = head;
+        } while (!datomic_compare_exchange(&registered_rate_limits, &head, limit, DATOMIC_RELEASE, DATOMIC_RELAXED));
+    }
+    return false;
+}
+
+static void binary_append(log_binary_buffer *buffer, const void *data, u32 size)
+{
+    // Most of these copies are a few bytes, so let the compiler inline them.
+    __builtin_memcpy(buffer->data + buffer->length, data, size);
+    buffer->length += size;
+}
+
+void log_binary_flush()
+{
+    log_binary_buffer *buffer = thread_binary_buffer;
+    if (state_ptr && buffer && buffer->length)
+    {
+        enqueue_message(LOG_ENTRY_BINARY, (const char *)buffer->data, buffer->length);
+        buffer->length = 0;
+    }
+}
+
+void log_binary_output(u32 *format_id, log_level level, const char *format, const log_arg *args, u8 arg_count)
+{
+    if (!state_ptr)
+    {
+        // Binary records can only be decoded from a file, so there is nowhere for these to go.
+        return;
+    }
+
+    log_binary_buffer *buffer = thread_binary_buffer;
+    if (!buffer)
+    {
+        buffer               = dallocate(sizeof(log_binary_buffer), MEMORY_TAG_APPLICATION);
+        thread_binary_buffer = buffer;
+        platform_mutex_lock(&state_ptr->ring_mutex);
+        buffer->next              = state_ptr->binary_buffers;
+        state_ptr->binary_buffers = buffer;
+        platform_mutex_unlock(&state_ptr->ring_mutex);
+    }
+
+    if (arg_count > LOG_BINARY_MAX_ARGS)
+    {
+        arg_count = LOG_BINARY_MAX_ARGS;
+    }
+
+    // Work out the size of the records up front, so they never straddle two buffers.
+    u32 entry_size = sizeof(u8) + sizeof(u32) + sizeof(f64) + sizeof(u8);
+    u16 string_lengths[LOG_BINARY_MAX_ARGS];
+    for (u8 i = 0; i < arg_count; ++i)
+    {
+        entry_size += sizeof(u8);
+        if (args[i].type == LOG_ARG_TYPE_STRING)
+        {
+            u64 length = args[i].value.str ? string_length(args[i].value.str) : 0;
+            if (length > LOG_BINARY_MAX_STRING_LENGTH)
+            {
+                length = LOG_BINARY_MAX_STRING_LENGTH;
+            }
+            string_lengths[i] = (u16)length;
+
+            entry_size += sizeof(u16) + string_lengths[i];
+        }
+        else
+        {
+            entry_size += sizeof(u64);
+        }
+    }
+
+    // The first call at a call site claims an id for it and records the format string.
+    u32 id            = datomic_load(format_id, DATOMIC_ACQUIRE);
+    u16 format_length = 0;
+    if (id == 0)
+    {
+        u32 new_id   = datomic_fetch_add(&state_ptr->last_format_id, 1, DATOMIC_RELAXED) + 1;
+        u32 expected = 0;
+        if (datomic_compare_exchange(format_id, &expected, new_id, DATOMIC_ACQ_REL, DATOMIC_ACQUIRE))
+        {
+            id            = new_id;
+            u64 length    = string_length(format);
+            format_length = length > LOG_BINARY_MAX_FORMAT_LENGTH ? LOG_BINARY_MAX_FORMAT_LENGTH : (u16)length;
+
+            entry_size += sizeof(u8) + sizeof(u32) + sizeof(u8) + sizeof(u16) + format_length;
+        }
+        else
+        {
+            // Another thread got there first, and records the format itself.
+            id = expected;
+        }
+    }
+
+    if (buffer->length + entry_size > LOG_BINARY_BUFFER_SIZE)
+    {
+        log_binary_flush();
+    }
+
+    if (format_length)
+    {
+        u8 kind = LOG_BINARY_RECORD_FORMAT;
+        u8 lvl  = level;
+        binary_append(buffer, &kind, sizeof(u8));
+        binary_append(buffer, &id, sizeof(u32));
+        binary_append(buffer, &lvl, sizeof(u8));
+        binary_append(buffer, &format_length, sizeof(u16));
+        binary_append(buffer, format, format_length);
+    }
+
+    u8 kind       = LOG_BINARY_RECORD_ENTRY;
+    f64 timestamp = platform_get_absolute_time();
+    binary_append(buffer, &kind, sizeof(u8));
+    binary_append(buffer, &id, sizeof(u32));
+    binary_append(buffer, &timestamp, sizeof(f64));
+    binary_append(buffer, &arg_count, sizeof(u8));
+    for (u8 i = 0; i < arg_count; ++i)
+    {
+        u8 type = args[i].type;
+        binary_append(buffer, &type, sizeof(u8));
+        if (type == LOG_ARG_TYPE_STRING)
+        {
+            binary_append(buffer, &string_lengths[i], sizeof(u16));
+            binary_append(buffer, args[i].value.str, string_lengths[i]);
+        }
+        else
+        {
+            binary_append(buffer, &args[i].value, sizeof(u64));
+        }
+    }
+}
+
+// A format string recorded in a binary log.
+typedef struct log_decode_format
+{
+    u8 level;
+    u16 length;
+    const char *text;
+} log_decode_format;
+
+// An entry found in a binary log, by the offset of its format id.
+typedef struct log_decode_entry
+{
+    f64 timestamp;
+    u64 offset;
+} log_decode_entry;
+
+// A message being expanded by log_binary_decode.
+typedef struct log_decode_message
+{
+    char *text;
+    u64 length;
+} log_decode_message;
+
+// Reads size bytes at *offset, failing if that runs past the end of the data.
+static b8 decode_read(const u8 *data, u64 data_size, u64 *offset, void *out, u64 size)
+{
+    if (*offset + size > data_size)
+    {
+        return false;
+    }
+    dcopy_memory(out, data + *offset, size);
+    *offset += size;
+    return true;
+}
+
+static int decode_compare_entries(const void *a, const void *b)
+{
+    const log_decode_entry *entry_a = a;
+    const log_decode_entry *entry_b = b;
+    if (entry_a->timestamp != entry_b->timestamp)
+    {
+        return entry_a->timestamp < entry_b->timestamp ? -1 : 1;
+    }
+    // Equal timestamps keep their file order.
+    return entry_a->offset < entry_b->offset ? -1 : 1;
+}
+
+static void decode_append_char(log_decode_message *message, char c)
+{
+    if (message->length < LOG_MESSAGE_MAX_LENGTH)
+    {
+        message->text[message->length++] = c;
+    }
+}
+
+// Formats onto the end of a message, truncating at LOG_MESSAGE_MAX_LENGTH.
+static void decode_append(log_decode_message *message, const char *format, ...)
+{
+    u64 remaining = LOG_MESSAGE_MAX_LENGTH - message->length;
+    if (remaining == 0)
+    {
+        return;
+    }
+    __builtin_va_list arg_ptr;
+    va_start(arg_ptr, format);
+    s32 written = string_format_n_v(message->text + message->length, remaining, format, arg_ptr);
+    va_end(arg_ptr);
+    if (written > 0)
+    {
+        message->length += (u64)written;
+    }
+}
+
+/*
+Formats a single argument using the conversion spec from the format string. Arguments were
+widened to 64 bits when recorded, so the spec's own length modifier is replaced to match.
+*/
+static void decode_argument(log_decode_message *message, const char *spec, u32 spec_length, char conversion,
+                            const u8 *value_data, u8 type)
+{
+    char conversion_spec[64];
+    if (spec_length > sizeof(conversion_spec) - 4)
+    {
+        spec_length = sizeof(conversion_spec) - 4;
+    }
+    dcopy_memory(conversion_spec, spec, spec_length);
+
+    u64 value = 0;
+    if (type != LOG_ARG_TYPE_STRING)
+    {
+        dcopy_memory(&value, value_data, sizeof(u64));
+    }
+
+    switch (conversion)
+    {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        conversion_spec[spec_length++] = 'l';
+        conversion_spec[spec_length++] = 'l';
+        conversion_spec[spec_length++] = conversion;
+        conversion_spec[spec_length]   = 0;
+        if (type == LOG_ARG_TYPE_F64)
+        {
+            f64 f;
+            dcopy_memory(&f, &value, sizeof(f64));
+            value = (u64)(s64)f;
+        }
+        decode_append(message, conversion_spec, value);
+        break;
+    case 'c':
+        conversion_spec[spec_length++] = 'c';
+        conversion_spec[spec_length]   = 0;
+        decode_append(message, conversion_spec, (int)value);
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A': {
+        conversion_spec[spec_length++] = conversion;
+        conversion_spec[spec_length]   = 0;
+        f64 f;
+        if (type == LOG_ARG_TYPE_F64)
+        {
+            dcopy_memory(&f, &value, sizeof(f64));
+        }
+        else
+        {
+            f = type == LOG_ARG_TYPE_S64 ? (f64)(s64)value : (f64)value;
+        }
+        decode_append(message, conversion_spec, f);
+    }
+    break;
+    case 's':
+        // Recorded strings are not null-terminated, so width and precision are ignored.
+        if (type == LOG_ARG_TYPE_STRING)
+        {
+            u16 length;
+            dcopy_memory(&length, value_data, sizeof(u16));
+            decode_append(message, "%.*s", (int)length, (const char *)(value_data + sizeof(u16)));
+        }
+        else
+        {
+            decode_append(message, "(0x%llx)", value);
+        }
+        break;
+    case 'p':
+    default:
+        decode_append(message, "%p", (void *)value);
+        break;
+    }
+}
+
+// Expands a format string with the arguments recorded in an entry.
+static void decode_message(log_decode_message *message, const log_decode_format *format, u8 arg_count,
+                           const u8 **arg_values, const u8 *arg_types)
+{
+    const char *text = format->text;
+    u8 next_arg      = 0;
+    message->length  = 0;
+    for (u16 i = 0; i < format->length; ++i)
+    {
+        if (text[i] != '%')
+        {
+            decode_append_char(message, text[i]);
+            continue;
+        }
+
+        // Find the end of the conversion spec.
+        u16 start = i++;
+        if (i < format->length && text[i] == '%')
+        {
+            decode_append_char(message, '%');
+            continue;
+        }
+        u32 spec_length = 0;
+        char spec[64];
+        spec[spec_length++] = '%';
+        while (i < format->length && spec_length < sizeof(spec) - 4)
+        {
+            char c = text[i];
+            if (c == 'h' || c == 'l' || c == 'z' || c == 'j' || c == 't' || c == 'L' || c == 'q')
+            {
+                // Length modifiers are dropped; every value is recorded as 64 bits.
+                i++;
+                continue;
+            }
+            if ((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == ' ' || c == '#')
+            {
+                spec[spec_length++] = c;
+                i++;
+                continue;
+            }
+            break;
+        }
+
+        if (i >= format->length)
+        {
+            // A dangling '%' at the end. Keep it as-is.
+            decode_append(message, "%.*s", (int)(i - start), text + start);
+            break;
+        }
+
+        if (next_arg >= arg_count)
+        {
+            decode_append(message, "<missing>");
+            continue;
+        }
+
+        decode_argument(message, spec, spec_length, text[i], arg_values[next_arg], arg_types[next_arg]);
+        next_arg++;
+    }
+    message->text[message->length] = 0;
+}
+
+b8 log_binary_decode(const void *data, u64 data_size, PFN_log_binary_message callback, void *user_data)
+{
+    const u8 *bytes = data;
+    u64 offset      = 0;
+    u32 header[2]   = {0};
+    if (!callback || !decode_read(bytes, data_size, &offset, header, sizeof(header)) ||
+        header[0] != LOG_BINARY_MAGIC || header[1] != LOG_BINARY_VERSION)
+    {
+        return false;
+    }
+
+    // First pass: collect the format strings, and find every entry.
+    log_decode_format *formats = darray_create(log_decode_format);
+    log_decode_entry *entries  = darray_create(log_decode_entry);
+    while (offset < data_size)
+    {
+        u8 kind = 0;
+        u32 id  = 0;
+        if (!decode_read(bytes, data_size, &offset, &kind, sizeof(u8)) ||
+            !decode_read(bytes, data_size, &offset, &id, sizeof(u32)))
+        {
+            break;
+        }
+
+        if (kind == LOG_BINARY_RECORD_FORMAT)
+        {
+            log_decode_format format = {0};
+            if (!decode_read(bytes, data_size, &offset, &format.level, sizeof(u8)) ||
+                !decode_read(bytes, data_size, &offset, &format.length, sizeof(u16)) ||
+                offset + format.length > data_size)
+            {
+                break;
+            }
+            format.text = (const char *)(bytes + offset);
+            offset += format.length;
+
+            while (darray_length(formats) <= id)
+            {
+                log_decode_format empty = {0};
+                darray_push(formats, empty);
+            }
+            formats[id] = format;
+        }
+        else if (kind == LOG_BINARY_RECORD_ENTRY)
+        {
+            // Keep the id with the entry by pointing back at it.
+            log_decode_entry entry;
+            entry.offset = offset - sizeof(u32);
+            u8 arg_count = 0;
+            if (!decode_read(bytes, data_size, &offset, &entry.timestamp, sizeof(f64)) ||
+                !decode_read(bytes, data_size, &offset, &arg_count, sizeof(u8)))
+            {
+                break;
+            }
+
+            // Skip over the arguments.
+            b8 valid = true;
+            for (u8 i = 0; i < arg_count && valid; ++i)
+            {
+                u8 type = 0;
+                valid   = decode_read(bytes, data_size, &offset, &type, sizeof(u8));
+                if (valid && type == LOG_ARG_TYPE_STRING)
+                {
+                    u16 length = 0;
+                    valid      = decode_read(bytes, data_size, &offset, &length, sizeof(u16));
+                    offset += length;
+                }
+                else
+                {
+                    offset += sizeof(u64);
+                }
+            }
+            if (!valid || offset > data_size)
+            {
+                break;
+            }
+
+            darray_push(entries, entry);
+        }
+        else
+        {
+            // Nothing after an unknown record can be trusted.
+            break;
+        }
+    }
+
+    // Entries are buffered per thread, so sort them to restore the order they were logged in.
+    u64 entry_count = darray_length(entries);
+    qsort(entries, entry_count, sizeof(log_decode_entry), decode_compare_entries);
+
+    // Second pass: expand the entries.
+    log_decode_message message;
+    message.text   = dallocate(LOG_MESSAGE_MAX_LENGTH + 1, MEMORY_TAG_STRING);
+    message.length = 0;
+    for (u64 e = 0; e < entry_count; ++e)
+    {
+        u64 position = entries[e].offset;
+        u32 id       = 0;
+        f64 timestamp;
+        u8 arg_count = 0;
+        decode_read(bytes, data_size, &position, &id, sizeof(u32));
+        decode_read(bytes, data_size, &position, &timestamp, sizeof(f64));
+        decode_read(bytes, data_size, &position, &arg_count, sizeof(u8));
+
+        const u8 *arg_values[LOG_BINARY_MAX_ARGS];
+        u8 arg_types[LOG_BINARY_MAX_ARGS];
+        for (u8 i = 0; i < arg_count; ++i)
+        {
+            u8 type = bytes[position++];
+            if (i < LOG_BINARY_MAX_ARGS)
+            {
+                arg_types[i]  = type;
+                arg_values[i] = bytes + position;
+            }
+            if (type == LOG_ARG_TYPE_STRING)
+            {
+                u16 length;
+                dcopy_memory(&length, bytes + position, sizeof(u16));
+                position += sizeof(u16) + length;
+            }
+            else
+            {
+                position += sizeof(u64);
+            }
+        }
+        if (arg_count > LOG_BINARY_MAX_ARGS)
+        {
+            arg_count = LOG_BINARY_MAX_ARGS;
+        }
+
+        if (id >= darray_length(formats) || !formats[id].text)
+        {
+            message.length = 0;
+            decode_append(&message, "<unknown format %u>", id);
+            callback(timestamp, LOG_LEVEL_FATAL, message.text, user_data);
+            continue;
+        }
+
+        const log_decode_format *format = &formats[id];
+        decode_message(&message, format, arg_count, arg_values, arg_types);
+        callback(timestamp, format->level <= LOG_LEVEL_TRACE ? format->level : LOG_LEVEL_FATAL, message.text,
+                 user_data);
+    }
+
+    dfree(message.text, LOG_MESSAGE_MAX_LENGTH + 1, MEMORY_TAG_STRING);
+    darray_destroy(entries);
+    darray_destroy(formats);
+    return true;
 }
 
 void report_assertion_failure(const char *expression, const char *message, const char *file, s32 line)
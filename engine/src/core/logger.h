@@ -2,16 +2,21 @@
 
 #include "defines.h"
 
-#define LOG_WARN_ENABLED 1
-#define LOG_INFO_ENABLED 1
-#define LOG_DEBUG_ENABLED 1
-#define LOG_TRACE_ENABLED 1
-
-// Disable debug and trace logging for release builds.
+// The most verbose log level compiled in. Calls above it are removed by the preprocessor,
+// so their arguments are never evaluated. Can be overridden, e.g. -DLOG_LEVEL_COMPILED=3.
+#ifndef LOG_LEVEL_COMPILED
 #if KRELEASE == 1
-#define LOG_DEBUG_ENABLED 0
-#define LOG_TRACE_ENABLED 0
+// Disable debug and trace logging for release builds.
+#define LOG_LEVEL_COMPILED 3
+#else
+#define LOG_LEVEL_COMPILED 5
 #endif
+#endif
+
+#define LOG_WARN_ENABLED (LOG_LEVEL_COMPILED >= 2)
+#define LOG_INFO_ENABLED (LOG_LEVEL_COMPILED >= 3)
+#define LOG_DEBUG_ENABLED (LOG_LEVEL_COMPILED >= 4)
+#define LOG_TRACE_ENABLED (LOG_LEVEL_COMPILED >= 5)
 
 typedef enum log_level
 {
@@ -31,8 +36,8 @@ typedef enum log_level
  * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
  * @return b8 True on success; otherwise false.
  */
-b8 initialize_logging(u64 *memory_requirement, void *state);
-void shutdown_logging(void *state);
+DAPI b8 initialize_logging(u64 *memory_requirement, void *state);
+DAPI void shutdown_logging(void *state);
 
 DAPI void log_output(log_level level, const char *message, ...);
 
@@ -75,3 +80,234 @@ DAPI void log_output(log_level level, const char *message, ...);
 // Does nothing when LOG_TRACE_ENABLED != 1
 #define DTRACE(message, ...)
 #endif
+
+/*
+Rate limiting.
+
+DLOG_RATE_LIMITED keeps a counter per call site, so a call that fires every frame cannot
+flood the log. Each call site logs at most LOG_RATE_LIMIT_BURST messages per interval of
+LOG_RATE_LIMIT_INTERVAL_MS. The first message after a suppressed stretch reports how many
+were dropped. A call site registers with the logger the first time it suppresses a message, so
+that if it goes quiet, the log writer reports the count itself once the interval is over, or
+at shutdown.
+*/
+
+#define LOG_RATE_LIMIT_BURST 5
+#define LOG_RATE_LIMIT_INTERVAL_MS 1000
+
+// Per call site state for DLOG_RATE_LIMITED. Zero-initialized, apart from level and format.
+typedef struct log_rate_limit
+{
+    // Identify the call site when the log writer reports suppressed messages. Only state with a
+    // format is registered, and it must then never go out of scope.
+    log_level level;
+    const char *format;
+    // When the current interval started, in milliseconds.
+    volatile u64 interval_start_ms;
+    // Messages logged and suppressed in the current interval.
+    volatile u32 logged;
+    volatile u32 suppressed;
+    // Set once registered with the logger, with the interval the call site uses.
+    volatile u32 registered;
+    u64 interval_ms;
+    // The next registered call site.
+    struct log_rate_limit *next;
+} log_rate_limit;
+
+/**
+ * @brief Decides if a rate-limited call site may log now. Thread-safe.
+ *
+ * @param limit The call site's state.
+ * @param burst The number of messages allowed per interval.
+ * @param interval_ms The length of an interval in milliseconds.
+ * @param out_suppressed Set to the number of messages suppressed since the last one logged, if allowed.
+ * @return True if the message should be logged; otherwise false.
+ */
+DAPI b8 log_rate_limit_allow(log_rate_limit *limit, u32 burst, u64 interval_ms, u32 *out_suppressed);
+
+// Logs a message at the given level, at most LOG_RATE_LIMIT_BURST times per interval for this call site.
+#define DLOG_RATE_LIMITED(dlog_level, message, ...)                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((dlog_level) <= LOG_LEVEL_COMPILED)                                                                        \
+        {                                                                                                              \
+            static log_rate_limit dlog_rate_limit = {.level = (dlog_level), .format = message};                        \
+            u32 dlog_suppressed                   = 0;                                                                 \
+            if (log_rate_limit_allow(&dlog_rate_limit, LOG_RATE_LIMIT_BURST, LOG_RATE_LIMIT_INTERVAL_MS,               \
+                                     &dlog_suppressed))                                                                \
+            {                                                                                                          \
+                if (dlog_suppressed)                                                                                   \
+                {                                                                                                      \
+                    log_output(dlog_level, "(%u similar messages suppressed) " message, dlog_suppressed,               \
+                               ##__VA_ARGS__);                                                                         \
+                }                                                                                                      \
+                else                                                                                                   \
+                {                                                                                                      \
+                    log_output(dlog_level, message, ##__VA_ARGS__);                                                    \
+                }                                                                                                      \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
+
+/*
+Binary logging.
+
+DLOG_BINARY defers formatting entirely. The first call at each call site records the format
+string once; every call after that only records the call site's format id, a timestamp and
+the raw argument values. Records are buffered per thread and written to console.blog, which
+the logdecode tool expands into text offline.
+
+Arguments may be integers, floats, strings or pointers, up to LOG_BINARY_MAX_ARGS of them.
+Strings are copied at the call, up to LOG_BINARY_MAX_STRING_LENGTH characters.
+*/
+
+#define LOG_BINARY_MAX_ARGS 8
+#define LOG_BINARY_MAX_STRING_LENGTH 1024
+
+// Identifies console.blog files.
+#define LOG_BINARY_MAGIC 0x474F4C44 // "DLOG"
+#define LOG_BINARY_VERSION 1
+
+// Record kinds in a binary log.
+typedef enum log_binary_record
+{
+    // u32 id, u8 level, u16 length, then the format string (not null-terminated).
+    LOG_BINARY_RECORD_FORMAT = 1,
+    // u32 id, f64 timestamp, u8 arg_count, then per argument a u8 type and its value.
+    LOG_BINARY_RECORD_ENTRY = 2
+} log_binary_record;
+
+// How an argument value is stored. Strings are a u16 length then the characters; everything else is 8 bytes.
+typedef enum log_arg_type
+{
+    LOG_ARG_TYPE_S64     = 1,
+    LOG_ARG_TYPE_U64     = 2,
+    LOG_ARG_TYPE_F64     = 3,
+    LOG_ARG_TYPE_STRING  = 4,
+    LOG_ARG_TYPE_POINTER = 5
+} log_arg_type;
+
+typedef struct log_arg
+{
+    log_arg_type type;
+    union {
+        s64 s;
+        u64 u;
+        f64 f;
+        const char *str;
+        const void *ptr;
+    } value;
+} log_arg;
+
+DINLINE log_arg log_arg_s64(s64 value)
+{
+    return (log_arg){LOG_ARG_TYPE_S64, {.s = value}};
+}
+
+DINLINE log_arg log_arg_u64(u64 value)
+{
+    return (log_arg){LOG_ARG_TYPE_U64, {.u = value}};
+}
+
+DINLINE log_arg log_arg_f64(f64 value)
+{
+    return (log_arg){LOG_ARG_TYPE_F64, {.f = value}};
+}
+
+DINLINE log_arg log_arg_string(const char *value)
+{
+    return (log_arg){LOG_ARG_TYPE_STRING, {.str = value}};
+}
+
+DINLINE log_arg log_arg_pointer(const void *value)
+{
+    return (log_arg){LOG_ARG_TYPE_POINTER, {.ptr = value}};
+}
+
+// Captures a single argument along with its type.
+#define DLOG_ARG(x)                                                                                                    \
+    _Generic((x),                                                                                                      \
+        _Bool: log_arg_u64,                                                                                            \
+        char: log_arg_s64,                                                                                             \
+        signed char: log_arg_s64,                                                                                      \
+        short: log_arg_s64,                                                                                            \
+        int: log_arg_s64,                                                                                              \
+        long: log_arg_s64,                                                                                             \
+        long long: log_arg_s64,                                                                                        \
+        unsigned char: log_arg_u64,                                                                                    \
+        unsigned short: log_arg_u64,                                                                                   \
+        unsigned int: log_arg_u64,                                                                                     \
+        unsigned long: log_arg_u64,                                                                                    \
+        unsigned long long: log_arg_u64,                                                                               \
+        float: log_arg_f64,                                                                                            \
+        double: log_arg_f64,                                                                                           \
+        char *: log_arg_string,                                                                                        \
+        const char *: log_arg_string,                                                                                  \
+        default: log_arg_pointer)(x)
+
+// Counts 0 to 8 macro arguments.
+#define DLOG_COUNT(...) DLOG_COUNT_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_COUNT_(_, _1, _2, _3, _4, _5, _6, _7, _8, count, ...) count
+
+// Applies DLOG_ARG to each macro argument.
+#define DLOG_ARGS_0()
+#define DLOG_ARGS_1(a) DLOG_ARG(a)
+#define DLOG_ARGS_2(a, ...) DLOG_ARG(a), DLOG_ARGS_1(__VA_ARGS__)
+#define DLOG_ARGS_3(a, ...) DLOG_ARG(a), DLOG_ARGS_2(__VA_ARGS__)
+#define DLOG_ARGS_4(a, ...) DLOG_ARG(a), DLOG_ARGS_3(__VA_ARGS__)
+#define DLOG_ARGS_5(a, ...) DLOG_ARG(a), DLOG_ARGS_4(__VA_ARGS__)
+#define DLOG_ARGS_6(a, ...) DLOG_ARG(a), DLOG_ARGS_5(__VA_ARGS__)
+#define DLOG_ARGS_7(a, ...) DLOG_ARG(a), DLOG_ARGS_6(__VA_ARGS__)
+#define DLOG_ARGS_8(a, ...) DLOG_ARG(a), DLOG_ARGS_7(__VA_ARGS__)
+#define DLOG_CONCAT(a, b) DLOG_CONCAT_(a, b)
+#define DLOG_CONCAT_(a, b) a##b
+#define DLOG_ARGS(...) DLOG_CONCAT(DLOG_ARGS_, DLOG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+
+/**
+ * @brief Records a binary log entry. Use DLOG_BINARY rather than calling this directly.
+ *
+ * @param format_id The call site's format id. 0 until the format string has been recorded.
+ * @param level The log level.
+ * @param format The printf-style format string. Must be a string literal.
+ * @param args The captured arguments.
+ * @param arg_count The number of arguments.
+ */
+DAPI void log_binary_output(u32 *format_id, log_level level, const char *format, const log_arg *args, u8 arg_count);
+
+// Hands the calling thread's buffered binary records to the writer thread.
+DAPI void log_binary_flush();
+
+/**
+ * @brief Called by log_binary_decode for each message of a binary log, in the order they were logged.
+ *
+ * @param timestamp When the message was logged, in seconds.
+ * @param level The level it was logged at.
+ * @param message The expanded message, without a level prefix or newline. Only valid during the call.
+ * @param user_data The user data passed to log_binary_decode.
+ */
+typedef void (*PFN_log_binary_message)(f64 timestamp, log_level level, const char *message, void *user_data);
+
+/**
+ * @brief Expands the records of a binary log, as written to console.blog, back into messages.
+ * Decoding stops at the first damaged record, so a log cut short by a crash still decodes.
+ *
+ * @param data The contents of the binary log.
+ * @param data_size The size of data in bytes.
+ * @param callback Invoked with each message. Required.
+ * @param user_data Passed as-is to callback. Can be 0/NULL.
+ * @return True if data is a binary log of this version; otherwise false.
+ */
+DAPI b8 log_binary_decode(const void *data, u64 data_size, PFN_log_binary_message callback, void *user_data);
+
+// Logs a binary message at the given level. Levels above LOG_LEVEL_COMPILED are compiled out.
+#define DLOG_BINARY(level, message, ...)                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((level) <= LOG_LEVEL_COMPILED)                                                                             \
+        {                                                                                                              \
+            static u32 dlog_format_id = 0;                                                                             \
+            /* The leading element keeps the initializer valid when there are no arguments. */                        \
+            log_arg dlog_args[] = {{0}, DLOG_ARGS(__VA_ARGS__)};                                                       \
+            log_binary_output(&dlog_format_id, level, message, dlog_args + 1, DLOG_COUNT(__VA_ARGS__));                \
+        }                                                                                                              \
+    } while (0)
@@ -117,3 +117,10 @@ STATIC_ASSERT(sizeof(f64) == 8, "Expected f64 to be 8 bytes.");
 #define DINLINE static inline
 #define DNOINLINE
 #endif
+
+// Thread-local storage
+#if defined(_MSC_VER)
+#define DTHREADLOCAL __declspec(thread)
+#else
+#define DTHREADLOCAL __thread
+#endif
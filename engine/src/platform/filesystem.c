@@ -1,12 +1,30 @@
 #include "filesystem.h"
 
+#include "containers/darray.h"
+#include "core/datomic.h"
 #include "core/dmemory.h"
+#include "core/dstring.h"
 #include "core/logger.h"
+#include "platform/platform.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
 
+#if DPLATFORM_WINDOWS
+#include <io.h> // _get_osfhandle
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 b8 filesystem_exists(const char *path)
 {
 #ifdef _MSC_VER
@@ -70,9 +88,18 @@ b8 filesystem_size(file_handle *handle, u64 *out_size)
 {
     if (handle->handle)
     {
-        fseek((FILE *)handle->handle, 0, SEEK_END);
-        *out_size = ftell((FILE *)handle->handle);
-        rewind((FILE *)handle->handle);
+        // Ask the OS rather than seeking, so the stream position is left alone.
+#if DPLATFORM_WINDOWS
+        struct _stat64 file_stat;
+        if (_fstat64(_fileno((FILE *)handle->handle), &file_stat) != 0)
+#else
+        struct stat file_stat;
+        if (fstat(fileno((FILE *)handle->handle), &file_stat) != 0)
+#endif
+        {
+            return false;
+        }
+        *out_size = (u64)file_stat.st_size;
         return true;
     }
     return false;
@@ -124,6 +151,67 @@ b8 filesystem_read(file_handle *handle, u64 data_size, void *out_data, u64 *out_
     return false;
 }
 
+b8 filesystem_read_at(file_handle *handle, u64 offset, u64 data_size, void *out_data, u64 *out_bytes_read)
+{
+    if (!handle->handle || !out_data || !out_bytes_read)
+    {
+        return false;
+    }
+
+    *out_bytes_read = 0;
+#if DPLATFORM_WINDOWS
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno((FILE *)handle->handle));
+    while (*out_bytes_read < data_size)
+    {
+        // ReadFile takes at most 4GiB at a time.
+        u64 remaining = data_size - *out_bytes_read;
+        DWORD length  = remaining > 0xFFFFFFFFull ? 0xFFFFFFFF : (DWORD)remaining;
+        u64 position  = offset + *out_bytes_read;
+
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset     = (DWORD)position;
+        overlapped.OffsetHigh = (DWORD)(position >> 32);
+        DWORD read            = 0;
+        if (!ReadFile(file, (u8 *)out_data + *out_bytes_read, length, &read, &overlapped))
+        {
+            if (GetLastError() != ERROR_HANDLE_EOF)
+            {
+                return false;
+            }
+            break;
+        }
+        if (read == 0)
+        {
+            // Reached the end of the file.
+            break;
+        }
+        *out_bytes_read += read;
+    }
+#else
+    s32 fd = fileno((FILE *)handle->handle);
+    while (*out_bytes_read < data_size)
+    {
+        ssize_t read = pread(fd, (u8 *)out_data + *out_bytes_read, data_size - *out_bytes_read,
+                             (off_t)(offset + *out_bytes_read));
+        if (read < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        if (read == 0)
+        {
+            // Reached the end of the file.
+            break;
+        }
+        *out_bytes_read += (u64)read;
+    }
+#endif
+    return *out_bytes_read == data_size;
+}
+
 b8 filesystem_read_all_bytes(file_handle *handle, u8 *out_bytes, u64 *out_bytes_read)
 {
     if (handle->handle && out_bytes && out_bytes_read)
@@ -135,8 +223,8 @@ b8 filesystem_read_all_bytes(file_handle *handle, u8 *out_bytes, u64 *out_bytes_
             return false;
         }
 
-        *out_bytes_read = fread(out_bytes, 1, size, (FILE *)handle->handle);
-        return *out_bytes_read == size;
+        // Always from the start, whatever the stream position.
+        return filesystem_read_at(handle, 0, size, out_bytes, out_bytes_read);
     }
     return false;
 }
@@ -152,6 +240,8 @@ b8 filesystem_read_all_text(file_handle *handle, char *out_text, u64 *out_bytes_
             return false;
         }
 
+        // Read through the stream, so line endings are translated in text mode.
+        rewind((FILE *)handle->handle);
         *out_bytes_read = fread(out_text, 1, size, (FILE *)handle->handle);
         return *out_bytes_read == size;
     }
@@ -172,3 +262,964 @@ b8 filesystem_write(file_handle *handle, u64 data_size, const void *data, u64 *o
     }
     return false;
 }
+
+b8 filesystem_writer_open(const char *path, b8 binary, file_writer_config config, file_writer *out_writer)
+{
+    dzero_memory(out_writer, sizeof(file_writer));
+    const char *open_path = path;
+    if (config.replace_on_close)
+    {
+        // In the same directory, so the rename never crosses filesystems.
+        u64 length            = string_length(path);
+        out_writer->path      = string_duplicate(path);
+        out_writer->temp_path = dallocate(length + 5, MEMORY_TAG_STRING);
+        string_format(out_writer->temp_path, "%s.tmp", path);
+        open_path = out_writer->temp_path;
+    }
+    if (!filesystem_open(open_path, FILE_MODE_WRITE, binary, &out_writer->handle))
+    {
+        if (out_writer->path)
+        {
+            u64 length = string_length(out_writer->path);
+            dfree(out_writer->path, length + 1, MEMORY_TAG_STRING);
+            dfree(out_writer->temp_path, length + 5, MEMORY_TAG_STRING);
+        }
+        dzero_memory(out_writer, sizeof(file_writer));
+        return false;
+    }
+
+    // The writer does its own buffering, so skip stdio's and have every write out go straight to the OS.
+    setvbuf((FILE *)out_writer->handle.handle, 0, _IONBF, 0);
+
+    out_writer->capacity          = config.buffer_size ? config.buffer_size : FILE_WRITER_DEFAULT_BUFFER_SIZE;
+    out_writer->buffer            = dallocate(out_writer->capacity, MEMORY_TAG_ARRAY);
+    out_writer->flush_policy      = config.flush_policy;
+    out_writer->flush_interval_ms = config.flush_interval_ms;
+    out_writer->is_valid          = true;
+    return true;
+}
+
+// Moves the temporary file of a replace_on_close writer over the file it replaces.
+static b8 replace_file(const char *temp_path, const char *path)
+{
+#if DPLATFORM_WINDOWS
+    return MoveFileExA(temp_path, path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(temp_path, path) == 0;
+#endif
+}
+
+void filesystem_writer_close(file_writer *writer)
+{
+    if (writer->is_valid)
+    {
+        filesystem_writer_flush(writer);
+        dfree(writer->buffer, writer->capacity, MEMORY_TAG_ARRAY);
+        filesystem_close(&writer->handle);
+        if (writer->path)
+        {
+            if (writer->failed || !replace_file(writer->temp_path, writer->path))
+            {
+                remove(writer->temp_path);
+            }
+            u64 length = string_length(writer->path);
+            dfree(writer->path, length + 1, MEMORY_TAG_STRING);
+            dfree(writer->temp_path, length + 5, MEMORY_TAG_STRING);
+        }
+        dzero_memory(writer, sizeof(file_writer));
+    }
+}
+
+b8 filesystem_writer_flush(file_writer *writer)
+{
+    if (!writer->is_valid)
+    {
+        return false;
+    }
+    if (writer->length == 0)
+    {
+        return true;
+    }
+
+    // NOTE: No logging in here, since the logger itself writes through a file_writer.
+    u64 written    = fwrite(writer->buffer, 1, writer->length, (FILE *)writer->handle.handle);
+    b8 result      = written == writer->length;
+    writer->length = 0;
+    writer->failed = writer->failed || !result;
+    return result;
+}
+
+b8 filesystem_writer_update(file_writer *writer)
+{
+    if (writer->is_valid && writer->length && (writer->flush_policy & FILE_FLUSH_ON_INTERVAL) &&
+        (platform_get_absolute_time() - writer->buffered_since) * 1000.0 >= writer->flush_interval_ms)
+    {
+        return filesystem_writer_flush(writer);
+    }
+    return writer->is_valid;
+}
+
+b8 filesystem_writer_notify_fatal(file_writer *writer)
+{
+    if (writer->is_valid && (writer->flush_policy & FILE_FLUSH_ON_FATAL))
+    {
+        return filesystem_writer_flush(writer);
+    }
+    return writer->is_valid;
+}
+
+b8 filesystem_writer_write(file_writer *writer, u64 data_size, const void *data)
+{
+    if (!writer->is_valid)
+    {
+        return false;
+    }
+
+    b8 result = true;
+    if (writer->length + data_size > writer->capacity)
+    {
+        if (writer->flush_policy & FILE_FLUSH_ON_SIZE)
+        {
+            result = filesystem_writer_flush(writer);
+
+            // Data that would not fit even in an empty buffer is written straight through.
+            if (data_size > writer->capacity)
+            {
+                u64 written    = fwrite(data, 1, data_size, (FILE *)writer->handle.handle);
+                writer->failed = writer->failed || written != data_size;
+                return result && written == data_size;
+            }
+        }
+        else
+        {
+            // Nothing is written until a flush, so grow to hold everything.
+            u64 new_capacity = writer->capacity;
+            while (new_capacity < writer->length + data_size)
+            {
+                new_capacity *= 2;
+            }
+            u8 *new_buffer = dallocate(new_capacity, MEMORY_TAG_ARRAY);
+            dcopy_memory(new_buffer, writer->buffer, writer->length);
+            dfree(writer->buffer, writer->capacity, MEMORY_TAG_ARRAY);
+            writer->buffer   = new_buffer;
+            writer->capacity = new_capacity;
+        }
+    }
+
+    if (writer->length == 0)
+    {
+        writer->buffered_since = platform_get_absolute_time();
+    }
+    dcopy_memory(writer->buffer + writer->length, data, data_size);
+    writer->length += data_size;
+
+    if (writer->flush_policy & FILE_FLUSH_ON_INTERVAL)
+    {
+        result = filesystem_writer_update(writer) && result;
+    }
+    return result;
+}
+
+b8 filesystem_map(const char *path, file_mapping *out_mapping)
+{
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+
+#if DPLATFORM_WINDOWS
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        DERROR("Error opening file for mapping: '%s'", path);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        DERROR("Unable to get the size of file: '%s'", path);
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0)
+    {
+        // Empty files cannot be mapped, but there is nothing to read anyway.
+        CloseHandle(file);
+        return true;
+    }
+
+    HANDLE file_mapping_handle = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    const void *data           = file_mapping_handle ? MapViewOfFile(file_mapping_handle, FILE_MAP_READ, 0, 0, 0) : 0;
+    // The view keeps the file mapped on its own.
+    if (file_mapping_handle)
+    {
+        CloseHandle(file_mapping_handle);
+    }
+    CloseHandle(file);
+    if (!data)
+    {
+        DERROR("Error mapping file: '%s'", path);
+        return false;
+    }
+    out_mapping->size = (u64)size.QuadPart;
+#else
+    s32 fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        DERROR("Error opening file for mapping: '%s'", path);
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0)
+    {
+        DERROR("Unable to get the size of file: '%s'", path);
+        close(fd);
+        return false;
+    }
+    if (file_stat.st_size == 0)
+    {
+        // Empty files cannot be mapped, but there is nothing to read anyway.
+        close(fd);
+        return true;
+    }
+
+    void *data = mmap(0, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file open on its own.
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        DERROR("Error mapping file: '%s'", path);
+        return false;
+    }
+
+    // Assets are read front to back, usually right away, so start reading ahead now. Only hints.
+    madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+    madvise(data, file_stat.st_size, MADV_WILLNEED);
+    out_mapping->size = (u64)file_stat.st_size;
+#endif
+
+    out_mapping->data = data;
+    return true;
+}
+
+void filesystem_unmap(file_mapping *mapping)
+{
+    if (mapping->data)
+    {
+#if DPLATFORM_WINDOWS
+        UnmapViewOfFile(mapping->data);
+#else
+        munmap((void *)mapping->data, mapping->size);
+#endif
+    }
+    mapping->data = 0;
+    mapping->size = 0;
+}
+
+// Reads one file in full. Used where batched reads are unavailable.
+static void read_file_sync(file_read_request *request)
+{
+    request->bytes_read = 0;
+    request->success    = false;
+
+    file_handle handle;
+    u64 size = 0;
+    if (!filesystem_open(request->path, FILE_MODE_READ, true, &handle))
+    {
+        return;
+    }
+    if (!filesystem_size(&handle, &size))
+    {
+        filesystem_close(&handle);
+        return;
+    }
+
+    if (!request->buffer)
+    {
+        request->buffer      = size ? dallocate(size, MEMORY_TAG_ARRAY) : 0;
+        request->buffer_size = size;
+    }
+    if (size > request->buffer_size)
+    {
+        size = request->buffer_size;
+    }
+
+    filesystem_read(&handle, size, request->buffer, &request->bytes_read);
+    request->success = request->bytes_read == size;
+    filesystem_close(&handle);
+}
+
+#if DPLATFORM_WINDOWS
+
+b8 filesystem_read_batch(u32 count, file_read_request *requests)
+{
+    // TODO: Overlapped reads.
+    b8 result = true;
+    for (u32 i = 0; i < count; ++i)
+    {
+        read_file_sync(&requests[i]);
+        result = requests[i].success && result;
+    }
+    return result;
+}
+
+#else
+
+// The most operations kept in flight with the kernel at once.
+#define READ_BATCH_QUEUE_DEPTH 64
+
+// Encoded in each operation's user_data along with the request index.
+#define READ_BATCH_OP_OPEN 0
+#define READ_BATCH_OP_READ 1
+
+// A minimal io_uring. Only the submitting thread touches it.
+typedef struct io_ring
+{
+    s32 fd;
+    u32 *sq_head;
+    u32 *sq_tail;
+    u32 *sq_mask;
+    u32 *sq_array;
+    struct io_uring_sqe *sqes;
+    u32 *cq_head;
+    u32 *cq_tail;
+    u32 *cq_mask;
+    struct io_uring_cqe *cqes;
+    void *ring_memory;
+    u64 ring_memory_size;
+    u64 sqe_memory_size;
+    // Operations queued since the last submit.
+    u32 to_submit;
+} io_ring;
+
+static b8 io_ring_create(u32 entries, io_ring *out_ring)
+{
+    struct io_uring_params params;
+    dzero_memory(&params, sizeof(params));
+    dzero_memory(out_ring, sizeof(io_ring));
+
+    out_ring->fd = (s32)syscall(__NR_io_uring_setup, entries, &params);
+    if (out_ring->fd < 0)
+    {
+        return false;
+    }
+    // Kernels old enough to lack a single mapping for both queues also lack the operations used here.
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        close(out_ring->fd);
+        return false;
+    }
+
+    u64 sq_size                = params.sq_off.array + params.sq_entries * sizeof(u32);
+    u64 cq_size                = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    out_ring->ring_memory_size = sq_size > cq_size ? sq_size : cq_size;
+    out_ring->sqe_memory_size  = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    u8 *ring = mmap(0, out_ring->ring_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, out_ring->fd,
+                    IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED)
+    {
+        close(out_ring->fd);
+        return false;
+    }
+    void *sqes = mmap(0, out_ring->sqe_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, out_ring->fd,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        munmap(ring, out_ring->ring_memory_size);
+        close(out_ring->fd);
+        return false;
+    }
+
+    out_ring->ring_memory = ring;
+    out_ring->sq_head     = (u32 *)(ring + params.sq_off.head);
+    out_ring->sq_tail     = (u32 *)(ring + params.sq_off.tail);
+    out_ring->sq_mask     = (u32 *)(ring + params.sq_off.ring_mask);
+    out_ring->sq_array    = (u32 *)(ring + params.sq_off.array);
+    out_ring->sqes        = sqes;
+    out_ring->cq_head     = (u32 *)(ring + params.cq_off.head);
+    out_ring->cq_tail     = (u32 *)(ring + params.cq_off.tail);
+    out_ring->cq_mask     = (u32 *)(ring + params.cq_off.ring_mask);
+    out_ring->cqes        = (struct io_uring_cqe *)(ring + params.cq_off.cqes);
+    return true;
+}
+
+static void io_ring_destroy(io_ring *ring)
+{
+    munmap(ring->sqes, ring->sqe_memory_size);
+    munmap(ring->ring_memory, ring->ring_memory_size);
+    close(ring->fd);
+}
+
+// Returns a zeroed submission queue entry to fill in. The caller keeps in-flight operations within the queue size.
+static struct io_uring_sqe *io_ring_get_sqe(io_ring *ring)
+{
+    // This thread is the only producer, so the tail needs no atomic read.
+    u32 tail                 = *ring->sq_tail;
+    u32 index                = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    ring->sq_array[index]    = index;
+    dzero_memory(sqe, sizeof(struct io_uring_sqe));
+    // Published to the kernel on io_ring_submit_and_wait.
+    datomic_store(ring->sq_tail, tail + 1, DATOMIC_RELEASE);
+    ring->to_submit++;
+    return sqe;
+}
+
+// Submits everything queued, and waits for at least one completion.
+static b8 io_ring_submit_and_wait(io_ring *ring)
+{
+    for (;;)
+    {
+        s32 result = (s32)syscall(__NR_io_uring_enter, ring->fd, ring->to_submit, 1, IORING_ENTER_GETEVENTS, 0, 0);
+        if (result >= 0)
+        {
+            ring->to_submit -= result;
+            return true;
+        }
+        // EAGAIN and EBUSY mean the kernel is short of resources for now; it frees them as operations complete.
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            return false;
+        }
+    }
+}
+
+static void queue_open(io_ring *ring, u32 index, const char *path)
+{
+    struct io_uring_sqe *sqe = io_ring_get_sqe(ring);
+    sqe->opcode              = IORING_OP_OPENAT;
+    sqe->fd                  = AT_FDCWD;
+    sqe->addr                = (u64)path;
+    sqe->open_flags          = O_RDONLY;
+    sqe->user_data           = ((u64)index << 1) | READ_BATCH_OP_OPEN;
+}
+
+static void queue_read(io_ring *ring, u32 index, s32 fd, void *buffer, u32 size, u64 offset)
+{
+    struct io_uring_sqe *sqe = io_ring_get_sqe(ring);
+    sqe->opcode              = IORING_OP_READ;
+    sqe->fd                  = fd;
+    sqe->addr                = (u64)buffer;
+    sqe->len                 = size;
+    sqe->off                 = offset;
+    sqe->user_data           = ((u64)index << 1) | READ_BATCH_OP_READ;
+}
+
+static void close_batch_file(s32 *fds, u32 index)
+{
+    close(fds[index]);
+    fds[index] = -1;
+}
+
+// Clamps a read so its length fits in a submission queue entry.
+static u32 read_length(u64 remaining)
+{
+    return remaining > 0x40000000 ? 0x40000000 : (u32)remaining;
+}
+
+b8 filesystem_read_batch(u32 count, file_read_request *requests)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        requests[i].bytes_read = 0;
+        requests[i].success    = false;
+    }
+
+    io_ring ring;
+    if (!io_ring_create(READ_BATCH_QUEUE_DEPTH, &ring))
+    {
+        // No io_uring here (old kernel, or blocked by a sandbox), so read each file in turn.
+        b8 result = true;
+        for (u32 i = 0; i < count; ++i)
+        {
+            read_file_sync(&requests[i]);
+            result = requests[i].success && result;
+        }
+        return result;
+    }
+
+    s32 *fds = dallocate(sizeof(s32) * count, MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i < count; ++i)
+    {
+        fds[i] = -1;
+    }
+    u32 next_open  = 0;
+    u32 in_flight  = 0;
+    u32 completed  = 0;
+    b8 ring_failed = false;
+    while (completed < count && !ring_failed)
+    {
+        // Keep the queue full of opens. Each completed open is replaced by a read of the same file.
+        while (in_flight < READ_BATCH_QUEUE_DEPTH && next_open < count)
+        {
+            queue_open(&ring, next_open, requests[next_open].path);
+            next_open++;
+            in_flight++;
+        }
+
+        if (!io_ring_submit_and_wait(&ring))
+        {
+            DERROR("filesystem_read_batch - io_uring_enter failed (errno %i). Remaining files are not read.", errno);
+            ring_failed = true;
+            break;
+        }
+
+        u32 head = *ring.cq_head;
+        u32 tail = datomic_load(ring.cq_tail, DATOMIC_ACQUIRE);
+        for (; head != tail; ++head)
+        {
+            struct io_uring_cqe *cqe   = &ring.cqes[head & *ring.cq_mask];
+            u32 index                  = (u32)(cqe->user_data >> 1);
+            u32 op                     = (u32)(cqe->user_data & 1);
+            file_read_request *request = &requests[index];
+            in_flight--;
+
+            if (op == READ_BATCH_OP_OPEN)
+            {
+                if (cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP)
+                {
+                    // The kernel predates IORING_OP_OPENAT.
+                    read_file_sync(request);
+                    completed++;
+                    continue;
+                }
+                if (cqe->res < 0)
+                {
+                    DERROR("filesystem_read_batch - Error opening file: '%s'", request->path);
+                    completed++;
+                    continue;
+                }
+
+                fds[index] = cqe->res;
+                if (!request->buffer)
+                {
+                    struct stat file_stat;
+                    if (fstat(fds[index], &file_stat) != 0)
+                    {
+                        close_batch_file(fds, index);
+                        completed++;
+                        continue;
+                    }
+                    request->buffer_size = (u64)file_stat.st_size;
+                    request->buffer      = request->buffer_size ? dallocate(request->buffer_size, MEMORY_TAG_ARRAY) : 0;
+                }
+                if (request->buffer_size == 0)
+                {
+                    request->success = true;
+                    close_batch_file(fds, index);
+                    completed++;
+                    continue;
+                }
+
+                // Buffered io_uring reads do not ramp up readahead the way blocking reads do, which makes
+                // large cold files slower than a plain read. Asking for the whole range up front fixes that.
+                posix_fadvise(fds[index], 0, request->buffer_size, POSIX_FADV_WILLNEED);
+                queue_read(&ring, index, fds[index], request->buffer, read_length(request->buffer_size), 0);
+                in_flight++;
+            }
+            else
+            {
+                if (cqe->res < 0)
+                {
+                    DERROR("filesystem_read_batch - Error reading file: '%s'", request->path);
+                    close_batch_file(fds, index);
+                    completed++;
+                    continue;
+                }
+
+                request->bytes_read += cqe->res;
+                u64 remaining = request->buffer_size - request->bytes_read;
+                if (cqe->res == 0 || remaining == 0)
+                {
+                    // Reached the end of the file or the buffer.
+                    request->success = true;
+                    close_batch_file(fds, index);
+                    completed++;
+                    continue;
+                }
+
+                // A short read; queue the rest.
+                queue_read(&ring, index, fds[index], (u8 *)request->buffer + request->bytes_read,
+                           read_length(remaining), request->bytes_read);
+                in_flight++;
+            }
+        }
+        datomic_store(ring.cq_head, head, DATOMIC_RELEASE);
+    }
+
+    // Closing the ring cancels anything still in flight after a failure.
+    io_ring_destroy(&ring);
+    b8 result = true;
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (fds[i] >= 0)
+        {
+            close(fds[i]);
+            requests[i].success = false;
+        }
+        result = requests[i].success && result;
+    }
+    dfree(fds, sizeof(s32) * count, MEMORY_TAG_ARRAY);
+    return result;
+}
+
+#endif
+
+#if DPLATFORM_WINDOWS
+
+typedef struct watcher_state
+{
+    HANDLE directory;
+    OVERLAPPED overlapped;
+    // Filled in by ReadDirectoryChangesW, which requires DWORD alignment.
+    DWORD buffer[16 * 1024];
+} watcher_state;
+
+static b8 watcher_issue_read(watcher_state *state)
+{
+    ResetEvent(state->overlapped.hEvent);
+    return ReadDirectoryChangesW(state->directory, state->buffer, sizeof(state->buffer), TRUE,
+                                 FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, 0, &state->overlapped,
+                                 0);
+}
+
+b8 filesystem_watcher_create(const char *directory, file_watcher *out_watcher)
+{
+    out_watcher->internal_data = 0;
+
+    HANDLE handle = CreateFileA(directory, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                0, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, 0);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        DERROR("filesystem_watcher_create - Unable to open directory '%s'.", directory);
+        return false;
+    }
+
+    watcher_state *state     = dallocate(sizeof(watcher_state), MEMORY_TAG_ARRAY);
+    state->directory         = handle;
+    state->overlapped.hEvent = CreateEventA(0, TRUE, FALSE, 0);
+    if (!state->overlapped.hEvent || !watcher_issue_read(state))
+    {
+        DERROR("filesystem_watcher_create - Unable to watch directory '%s'.", directory);
+        if (state->overlapped.hEvent)
+        {
+            CloseHandle(state->overlapped.hEvent);
+        }
+        CloseHandle(handle);
+        dfree(state, sizeof(watcher_state), MEMORY_TAG_ARRAY);
+        return false;
+    }
+
+    out_watcher->internal_data = state;
+    return true;
+}
+
+void filesystem_watcher_destroy(file_watcher *watcher)
+{
+    watcher_state *state = watcher->internal_data;
+    if (!state)
+    {
+        return;
+    }
+
+    // The pending read writes into the buffer, so wait for the cancellation before freeing it.
+    DWORD bytes = 0;
+    CancelIo(state->directory);
+    GetOverlappedResult(state->directory, &state->overlapped, &bytes, TRUE);
+    CloseHandle(state->overlapped.hEvent);
+    CloseHandle(state->directory);
+    dfree(state, sizeof(watcher_state), MEMORY_TAG_ARRAY);
+    watcher->internal_data = 0;
+}
+
+u32 filesystem_watcher_poll(file_watcher *watcher, PFN_file_changed callback, void *user_data)
+{
+    watcher_state *state = watcher->internal_data;
+    if (!state)
+    {
+        return 0;
+    }
+
+    DWORD bytes = 0;
+    if (!GetOverlappedResult(state->directory, &state->overlapped, &bytes, FALSE))
+    {
+        if (GetLastError() != ERROR_IO_INCOMPLETE)
+        {
+            DWARN("filesystem_watcher_poll - Watching failed; restarting.");
+            watcher_issue_read(state);
+        }
+        return 0;
+    }
+
+    u32 count = 0;
+    if (bytes == 0)
+    {
+        // The buffer overflowed.
+        DWARN("filesystem_watcher_poll - Too many changes at once; some were missed.");
+    }
+    else
+    {
+        const u8 *entry = (const u8 *)state->buffer;
+        for (;;)
+        {
+            const FILE_NOTIFY_INFORMATION *info = (const FILE_NOTIFY_INFORMATION *)entry;
+            if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED ||
+                info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+            {
+                char path[512];
+                s32 length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, info->FileNameLength / sizeof(WCHAR),
+                                                 path, sizeof(path) - 1, 0, 0);
+                if (length > 0)
+                {
+                    path[length] = 0;
+                    for (s32 i = 0; i < length; ++i)
+                    {
+                        if (path[i] == '\\')
+                        {
+                            path[i] = '/';
+                        }
+                    }
+                    callback(path, user_data);
+                    count++;
+                }
+            }
+            if (info->NextEntryOffset == 0)
+            {
+                break;
+            }
+            entry += info->NextEntryOffset;
+        }
+    }
+
+    watcher_issue_read(state);
+    return count;
+}
+
+#else
+
+// inotify only watches single directories, so every directory in the tree gets its own watch.
+typedef struct watched_directory
+{
+    s32 wd;
+    // Relative to the root, or empty for the root itself.
+    char path[256];
+} watched_directory;
+
+typedef struct watcher_state
+{
+    s32 fd;
+    char root[512];
+    // darray
+    watched_directory *directories;
+} watcher_state;
+
+// IN_CLOSE_WRITE and IN_MOVED_TO mark a file as complete. IN_CREATE is only used to find new directories.
+#define WATCHER_EVENT_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR)
+
+static watched_directory *find_watched_directory(watcher_state *state, s32 wd, u64 *out_index)
+{
+    u64 length = darray_length(state->directories);
+    for (u64 i = 0; i < length; ++i)
+    {
+        if (state->directories[i].wd == wd)
+        {
+            if (out_index)
+            {
+                *out_index = i;
+            }
+            return &state->directories[i];
+        }
+    }
+    return 0;
+}
+
+// Watches the directory at relative_path and everything under it.
+static void watch_directory_tree(watcher_state *state, const char *relative_path)
+{
+    char full_path[1024];
+    if (relative_path[0])
+    {
+        snprintf(full_path, sizeof(full_path), "%s/%s", state->root, relative_path);
+    }
+    else
+    {
+        snprintf(full_path, sizeof(full_path), "%s", state->root);
+    }
+
+    s32 wd = inotify_add_watch(state->fd, full_path, WATCHER_EVENT_MASK);
+    if (wd < 0)
+    {
+        DWARN("filesystem_watcher - Unable to watch directory '%s'.", full_path);
+        return;
+    }
+    if (!find_watched_directory(state, wd, 0))
+    {
+        watched_directory directory;
+        directory.wd = wd;
+        snprintf(directory.path, sizeof(directory.path), "%s", relative_path);
+        darray_push(state->directories, directory);
+    }
+
+    // Then the subdirectories. Files created in a new directory before its watch is added are missed.
+    DIR *dir = opendir(full_path);
+    if (!dir)
+    {
+        return;
+    }
+    struct dirent *item;
+    while ((item = readdir(dir)) != 0)
+    {
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0)
+        {
+            continue;
+        }
+
+        char child_path[512];
+        if (relative_path[0])
+        {
+            snprintf(child_path, sizeof(child_path), "%s/%s", relative_path, item->d_name);
+        }
+        else
+        {
+            snprintf(child_path, sizeof(child_path), "%s", item->d_name);
+        }
+
+        b8 is_directory = item->d_type == DT_DIR;
+        if (item->d_type == DT_UNKNOWN)
+        {
+            char child_full_path[1536];
+            struct stat info;
+            snprintf(child_full_path, sizeof(child_full_path), "%s/%s", full_path, item->d_name);
+            is_directory = stat(child_full_path, &info) == 0 && S_ISDIR(info.st_mode);
+        }
+        if (is_directory)
+        {
+            watch_directory_tree(state, child_path);
+        }
+    }
+    closedir(dir);
+}
+
+b8 filesystem_watcher_create(const char *directory, file_watcher *out_watcher)
+{
+    out_watcher->internal_data = 0;
+
+    s32 fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        DERROR("filesystem_watcher_create - inotify is unavailable.");
+        return false;
+    }
+
+    watcher_state *state = dallocate(sizeof(watcher_state), MEMORY_TAG_ARRAY);
+    state->fd            = fd;
+    state->directories   = darray_create(watched_directory);
+    snprintf(state->root, sizeof(state->root), "%s", directory);
+    watch_directory_tree(state, "");
+    if (darray_length(state->directories) == 0)
+    {
+        DERROR("filesystem_watcher_create - Unable to watch directory '%s'.", directory);
+        close(fd);
+        darray_destroy(state->directories);
+        dfree(state, sizeof(watcher_state), MEMORY_TAG_ARRAY);
+        return false;
+    }
+
+    out_watcher->internal_data = state;
+    return true;
+}
+
+void filesystem_watcher_destroy(file_watcher *watcher)
+{
+    watcher_state *state = watcher->internal_data;
+    if (!state)
+    {
+        return;
+    }
+
+    // Closing the descriptor removes every watch.
+    close(state->fd);
+    darray_destroy(state->directories);
+    dfree(state, sizeof(watcher_state), MEMORY_TAG_ARRAY);
+    watcher->internal_data = 0;
+}
+
+u32 filesystem_watcher_poll(file_watcher *watcher, PFN_file_changed callback, void *user_data)
+{
+    watcher_state *state = watcher->internal_data;
+    if (!state)
+    {
+        return 0;
+    }
+
+    u32 count = 0;
+    _Alignas(struct inotify_event) u8 buffer[4096];
+    for (;;)
+    {
+        // Non-blocking, so this fails with EAGAIN once everything has been read.
+        ssize_t length = read(state->fd, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            break;
+        }
+
+        u64 offset = 0;
+        while (offset < (u64)length)
+        {
+            const struct inotify_event *event = (const struct inotify_event *)(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                DWARN("filesystem_watcher_poll - Too many changes at once; some were missed.");
+                continue;
+            }
+
+            u64 index                    = 0;
+            watched_directory *directory = find_watched_directory(state, event->wd, &index);
+            if (!directory)
+            {
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                // The directory was removed.
+                watched_directory removed;
+                darray_pop_at(state->directories, index, &removed);
+                continue;
+            }
+            if (event->len == 0)
+            {
+                continue;
+            }
+
+            char path[512];
+            if (directory->path[0])
+            {
+                snprintf(path, sizeof(path), "%s/%s", directory->path, event->name);
+            }
+            else
+            {
+                snprintf(path, sizeof(path), "%s", event->name);
+            }
+
+            if (event->mask & IN_ISDIR)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    watch_directory_tree(state, path);
+                }
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                callback(path, user_data);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+#endif
@@ -16,6 +16,99 @@ typedef enum file_modes
     FILE_MODE_WRITE = 0x2
 } file_modes;
 
+// A read-only view of a whole file's contents, mapped into memory.
+typedef struct file_mapping
+{
+    // Null for an empty file.
+    const void *data;
+    u64 size;
+} file_mapping;
+
+// One file read by filesystem_read_batch.
+typedef struct file_read_request
+{
+    // The path of the file to read. Required.
+    const char *path;
+    // Where to read the file to. If 0/NULL, a buffer the size of the file is allocated with
+    // MEMORY_TAG_ARRAY, which the caller must free.
+    void *buffer;
+    // The size of buffer. Reading stops at the end of the file or of the buffer, whichever comes first.
+    // Set to the size of the allocation when buffer is allocated.
+    u64 buffer_size;
+    // Set by filesystem_read_batch.
+    u64 bytes_read;
+    b8 success;
+} file_read_request;
+
+/**
+ * @brief Called by filesystem_watcher_poll for each file that changed.
+ *
+ * @param path The file's path relative to the watched directory, with '/' separators.
+ * @param user_data The user data passed to filesystem_watcher_poll.
+ */
+typedef void (*PFN_file_changed)(const char *path, void *user_data);
+
+// Watches a directory, and everything under it, for files being written or moved into place.
+typedef struct file_watcher
+{
+    void *internal_data;
+} file_watcher;
+
+// Used by filesystem_writer_open when no buffer size is given.
+#define FILE_WRITER_DEFAULT_BUFFER_SIZE (64 * 1024)
+
+// Determines when a file_writer writes its buffered data out to the file. Combine as flags.
+typedef enum file_flush_policy
+{
+    // Buffered data is only written on an explicit flush and on close. The buffer grows as
+    // needed, so a whole file can be assembled in memory and written at once.
+    FILE_FLUSH_ON_CLOSE = 0x0,
+    // Buffered data is written out whenever the buffer fills.
+    FILE_FLUSH_ON_SIZE = 0x1,
+    // Buffered data is written out once flush_interval_ms has passed since it was buffered.
+    // Checked on each write and by filesystem_writer_update.
+    FILE_FLUSH_ON_INTERVAL = 0x2,
+    // Buffered data is written out by filesystem_writer_notify_fatal, so it survives the crash that usually follows.
+    FILE_FLUSH_ON_FATAL = 0x4
+} file_flush_policy;
+
+typedef struct file_writer_config
+{
+    // The initial size of the buffer. 0 uses FILE_WRITER_DEFAULT_BUFFER_SIZE.
+    u64 buffer_size;
+    // A combination of file_flush_policy flags.
+    u32 flush_policy;
+    // Only used with FILE_FLUSH_ON_INTERVAL.
+    u32 flush_interval_ms;
+    // If true, the file is written next to path under a temporary name, and moved over path on close
+    // if every write succeeded. Anything reading or mapping the old file keeps seeing it whole, and
+    // watchers see the new file appear at once.
+    b8 replace_on_close;
+} file_writer_config;
+
+/**
+ * @brief Batches small writes into a buffer, so write-heavy code such as logging or asset
+ * cooking does not make a system call per write. Not thread-safe; each writer should be
+ * used by one thread at a time.
+ */
+typedef struct file_writer
+{
+    file_handle handle;
+    u8 *buffer;
+    u64 capacity;
+    u64 length;
+    u32 flush_policy;
+    u32 flush_interval_ms;
+    // The time the oldest byte in the buffer was written, in seconds.
+    f64 buffered_since;
+    // Set with replace_on_close: the file to replace, and the temporary file being written instead.
+    char *path;
+    char *temp_path;
+    // If a write has failed since the writer was opened.
+    b8 failed;
+    b8 is_valid;
+} file_writer;
+
 /**
  * Checks if a file with the given path exists.
  * @param path The path of the file to be checked.
@@ -40,11 +133,12 @@ DAPI b8 filesystem_open(const char *path, file_modes mode, b8 binary, file_handl
 DAPI void filesystem_close(file_handle *handle);
 
 /**
- * @brief Attempts to read the size of the file to which handle is attached.
+ * @brief Attempts to read the size of the file to which handle is attached. Queries the OS, so the
+ * stream position is not moved. Writes still buffered in the handle are not counted.
  *
  * @param handle The file handle.
  * @param out_size A pointer to hold the file size.
- * @return DAPI
+ * @return True if successful; otherwise false.
  */
 DAPI b8 filesystem_size(file_handle *handle, u64 *out_size);
 
@@ -79,7 +173,23 @@ DAPI b8 filesystem_write_line(file_handle *handle, const char *text);
 DAPI b8 filesystem_read(file_handle *handle, u64 data_size, void *out_data, u64 *out_bytes_read);
 
 /**
- * Reads all bytes of data into out_bytes.
+ * @brief Reads data_size bytes starting at offset, without using or moving the stream position
+ * (pread on Linux). Several threads can therefore read different parts of one handle at once without
+ * locking. Bypasses the handle's buffering, so flush any writes before reading them back this way.
+ * On Windows, the OS file pointer is moved, though the stream's own position is not.
+ *
+ * @param handle A pointer to a file_handle structure.
+ * @param offset The offset from the start of the file to read from.
+ * @param data_size The number of bytes to read.
+ * @param out_data A block of memory of at least data_size bytes to read into.
+ * @param out_bytes_read A pointer to hold the number of bytes actually read, which is less than data_size
+ * if the file ends first.
+ * @return True if data_size bytes were read; otherwise false.
+ */
+DAPI b8 filesystem_read_at(file_handle *handle, u64 offset, u64 data_size, void *out_data, u64 *out_bytes_read);
+
+/**
+ * Reads all bytes of data into out_bytes, from the start of the file wherever the stream position is.
  * @param handle A pointer to a file_handle structure.
  * @param out_bytes A byte array which will be populated by this method.
  * @param out_bytes_read A pointer to a number which will be populated with the number of bytes actually read from the
@@ -108,3 +218,115 @@ DAPI b8 filesystem_read_all_text(file_handle *handle, char *out_text, u64 *out_b
  * @returns True if successful; otherwise false.
  */
 DAPI b8 filesystem_write(file_handle *handle, u64 data_size, const void *data, u64 *out_bytes_written);
+
+/**
+ * @brief Creates or wipes the file at path, and opens it for buffered writing. With config.replace_on_close,
+ * path is left alone until the writer is closed.
+ *
+ * @param path The path of the file to be written.
+ * @param binary Indicates if the file should be opened in binary mode.
+ * @param config The buffer size and flush policy to use.
+ * @param out_writer A pointer to the writer to be initialized.
+ * @return True if opened successfully; otherwise false.
+ */
+DAPI b8 filesystem_writer_open(const char *path, b8 binary, file_writer_config config, file_writer *out_writer);
+
+/**
+ * @brief Flushes any buffered data, then closes the file and frees the buffer. With replace_on_close, the
+ * written file then replaces the original, unless a write failed, in which case it is deleted.
+ *
+ * @param writer A pointer to the writer to be closed.
+ */
+DAPI void filesystem_writer_close(file_writer *writer);
+
+/**
+ * @brief Buffers data to be written to the file, writing out according to the writer's flush policy.
+ *
+ * @param writer A pointer to the writer.
+ * @param data_size The size of the data in bytes.
+ * @param data The data to be written.
+ * @return True if successful; false if the data, or earlier buffered data, could not be written.
+ */
+DAPI b8 filesystem_writer_write(file_writer *writer, u64 data_size, const void *data);
+
+/**
+ * @brief Writes all buffered data out to the file, regardless of the flush policy.
+ *
+ * @param writer A pointer to the writer.
+ * @return True if successful; otherwise false.
+ */
+DAPI b8 filesystem_writer_flush(file_writer *writer);
+
+/**
+ * @brief Applies FILE_FLUSH_ON_INTERVAL without writing anything new. Call this periodically
+ * on writers that may go idle with data still buffered.
+ *
+ * @param writer A pointer to the writer.
+ * @return True if successful; otherwise false.
+ */
+DAPI b8 filesystem_writer_update(file_writer *writer);
+
+/**
+ * @brief Signals that a fatal error has been reported. Flushes the writer if its policy includes FILE_FLUSH_ON_FATAL.
+ *
+ * @param writer A pointer to the writer.
+ * @return True if successful; otherwise false.
+ */
+DAPI b8 filesystem_writer_notify_fatal(file_writer *writer);
+
+/**
+ * @brief Maps the whole file at path into memory for reading, without copying it. The OS is
+ * told the file will be read from start to end soon, so it can read ahead.
+ *
+ * @param path The path of the file to be mapped.
+ * @param out_mapping A pointer to hold the mapping. The contents are not null-terminated.
+ * @return True if mapped successfully; otherwise false.
+ */
+DAPI b8 filesystem_map(const char *path, file_mapping *out_mapping);
+
+/**
+ * @brief Unmaps a file mapped by filesystem_map. Its data must no longer be used.
+ *
+ * @param mapping A pointer to the mapping to be released.
+ */
+DAPI void filesystem_unmap(file_mapping *mapping);
+
+/**
+ * @brief Reads many files at once, each from the start. On Linux, the opens and reads are all queued
+ * to the kernel together with io_uring, so the storage device sees many requests in flight rather than
+ * one at a time. Elsewhere, or if io_uring is unavailable, the files are read one after another.
+ * Blocks until every file is read, so call it from a worker thread.
+ *
+ * @param count The number of requests.
+ * @param requests The files to read. Each one's bytes_read and success are set on return.
+ * @return True if every file was read successfully; otherwise false.
+ */
+DAPI b8 filesystem_read_batch(u32 count, file_read_request *requests);
+
+/**
+ * @brief Starts watching a directory and all of its subdirectories, including ones created later.
+ * Uses inotify on Linux and ReadDirectoryChangesW on Windows.
+ *
+ * @param directory The path of the directory to watch.
+ * @param out_watcher A pointer to the watcher to be initialized.
+ * @return True if the directory is being watched; otherwise false.
+ */
+DAPI b8 filesystem_watcher_create(const char *directory, file_watcher *out_watcher);
+
+/**
+ * @brief Stops watching and frees the watcher.
+ *
+ * @param watcher A pointer to the watcher to be destroyed.
+ */
+DAPI void filesystem_watcher_destroy(file_watcher *watcher);
+
+/**
+ * @brief Reports the files that finished being written, or were moved into place, since the last
+ * poll. Never blocks. A file saved several times between polls may be reported more than once.
+ *
+ * @param watcher A pointer to the watcher.
+ * @param callback Called once per changed file.
+ * @param user_data Passed along to callback.
+ * @return The number of changes reported.
+ */
+DAPI u32 filesystem_watcher_poll(file_watcher *watcher, PFN_file_changed callback, void *user_data);
@@ -25,3 +25,103 @@ void platform_get_window_dimensions(u32 *width, u32 *height);
 // Should only be used for giving time back to the OS for unused update power.
 // Therefore it is not exported.
 void platform_sleep(u64 ms);
+
+// Holds a handle to an OS thread.
+typedef struct platform_thread
+{
+    // Opaque handle to internal thread data.
+    void *internal_data;
+    u64 thread_id;
+} platform_thread;
+
+// Holds a handle to an OS mutex.
+typedef struct platform_mutex
+{
+    void *internal_data;
+} platform_mutex;
+
+// Holds a handle to an OS condition variable.
+typedef struct platform_condition
+{
+    void *internal_data;
+} platform_condition;
+
+// Holds a handle to an OS counting semaphore.
+typedef struct platform_semaphore
+{
+    void *internal_data;
+} platform_semaphore;
+
+// The entry point of a thread. The return value is the thread's exit code.
+typedef u32 (*PFN_thread_start)(void *params);
+
+/**
+ * @brief Creates and immediately starts a new thread.
+ *
+ * @param start_function The function to be run on the new thread.
+ * @param params Data passed to start_function. Must outlive the thread. Can be 0/NULL.
+ * @param out_thread A pointer to hold the created thread.
+ * @return True if the thread was created; otherwise false.
+ */
+DAPI b8 platform_thread_create(PFN_thread_start start_function, void *params, platform_thread *out_thread);
+
+/**
+ * @brief Blocks until the provided thread exits, then releases its resources.
+ *
+ * @param thread A pointer to the thread to be joined.
+ */
+DAPI void platform_thread_join(platform_thread *thread);
+
+// Returns an identifier for the calling thread.
+DAPI u64 platform_current_thread_id();
+
+// Gives up the rest of the calling thread's time slice.
+DAPI void platform_thread_yield();
+
+// Returns the number of logical processors available to this process.
+DAPI u32 platform_get_processor_count();
+
+DAPI b8 platform_mutex_create(platform_mutex *out_mutex);
+DAPI void platform_mutex_destroy(platform_mutex *mutex);
+DAPI b8 platform_mutex_lock(platform_mutex *mutex);
+DAPI b8 platform_mutex_unlock(platform_mutex *mutex);
+
+DAPI b8 platform_condition_create(platform_condition *out_condition);
+DAPI void platform_condition_destroy(platform_condition *condition);
+
+/**
+ * @brief Atomically unlocks mutex and blocks until the condition is signalled, then re-locks mutex.
+ * Wakeups may be spurious, so always re-check the awaited state in a loop.
+ *
+ * @param condition The condition to wait on.
+ * @param mutex A mutex that must be locked by the calling thread.
+ * @return True on success; otherwise false.
+ */
+DAPI b8 platform_condition_wait(platform_condition *condition, platform_mutex *mutex);
+/**
+ * @brief Like platform_condition_wait, but gives up after timeout_ms milliseconds.
+ *
+ * @param condition The condition to wait on.
+ * @param mutex A mutex that must be locked by the calling thread.
+ * @param timeout_ms The longest time to wait, in milliseconds.
+ * @return True if woken before the timeout; false on timeout or error. The mutex is re-locked either way.
+ */
+DAPI b8 platform_condition_wait_timeout(platform_condition *condition, platform_mutex *mutex, u64 timeout_ms);
+// Wakes one thread waiting on the condition.
+DAPI b8 platform_condition_signal(platform_condition *condition);
+// Wakes all threads waiting on the condition.
+DAPI b8 platform_condition_broadcast(platform_condition *condition);
+
+/**
+ * @brief Creates a counting semaphore.
+ *
+ * @param initial_count The count the semaphore starts with.
+ * @param out_semaphore A pointer to hold the created semaphore.
+ * @return True if the semaphore was created; otherwise false.
+ */
+DAPI b8 platform_semaphore_create(u32 initial_count, platform_semaphore *out_semaphore);
+DAPI void platform_semaphore_destroy(platform_semaphore *semaphore);
+// Increments the count, waking one waiter if there are any.
+DAPI b8 platform_semaphore_signal(platform_semaphore *semaphore);
+// Blocks until the count is non-zero, then decrements it.
+DAPI b8 platform_semaphore_wait(platform_semaphore *semaphore);
@@ -9,10 +9,15 @@
 // Linux platform layer.
 #ifdef DPLATFORM_LINUX
 
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h> // sched_yield
+#include <semaphore.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
+#include <unistd.h> // sysconf
 
 #if _POSIX_C_SOURCE >= 199309L
 #include <time.h> // nanosleep
@@ -239,7 +244,7 @@ b8 platform_pump_messages()
             // The application layer can decide what to do with this.
             xcb_configure_notify_event_t *configure_event = (xcb_configure_notify_event_t *)event;
 
-            // Fire the event. The application layer should pick this up, but not handle it
+            // Post the event. The application layer should pick this up, but not handle it
             // as it shouldn be visible to other parts of the application.
             event_context context;
 
@@ -249,7 +254,7 @@ b8 platform_pump_messages()
             context.data.u32[0] = configure_event->width;
             context.data.u32[1] = configure_event->height;
 
-            event_fire(EVENT_CODE_RESIZED, 0, context);
+            event_post(EVENT_CODE_RESIZED, 0, context);
         }
         break;
 
@@ -735,7 +740,7 @@ static void xdg_toplevel_configure(void *data, struct xdg_toplevel *xdg_toplevel
     context.data.u32[0]   = width;
     context.data.u32[1]   = height;
 
-    event_fire(EVENT_CODE_RESIZED, 0, context);
+    event_post(EVENT_CODE_RESIZED, 0, context);
 }
 
 static void xdg_toplevel_close(void *data, struct xdg_toplevel *xdg_toplevel)
@@ -1121,4 +1126,250 @@ void platform_sleep(u64 ms)
 #endif
 }
 
+typedef struct linux_thread
+{
+    pthread_t handle;
+    PFN_thread_start start_function;
+    void *params;
+} linux_thread;
+
+// pthreads expects a void*(void*) entry point, so adapt it to PFN_thread_start here.
+static void *linux_thread_trampoline(void *arg)
+{
+    linux_thread *t = arg;
+    u32 result      = t->start_function(t->params);
+    return (void *)(u64)result;
+}
+
+b8 platform_thread_create(PFN_thread_start start_function, void *params, platform_thread *out_thread)
+{
+    if (!start_function || !out_thread)
+    {
+        return false;
+    }
+
+    linux_thread *t   = platform_allocate(sizeof(linux_thread), false);
+    t->start_function = start_function;
+    t->params         = params;
+    s32 result        = pthread_create(&t->handle, 0, linux_thread_trampoline, t);
+    if (result != 0)
+    {
+        DERROR("platform_thread_create - pthread_create failed with error: %d", result);
+        platform_free(t, false);
+        out_thread->internal_data = 0;
+        return false;
+    }
+
+    out_thread->internal_data = t;
+    out_thread->thread_id     = (u64)t->handle;
+    return true;
+}
+
+void platform_thread_join(platform_thread *thread)
+{
+    if (thread && thread->internal_data)
+    {
+        linux_thread *t = thread->internal_data;
+        pthread_join(t->handle, 0);
+        platform_free(t, false);
+        thread->internal_data = 0;
+        thread->thread_id     = 0;
+    }
+}
+
+u64 platform_current_thread_id()
+{
+    return (u64)pthread_self();
+}
+
+void platform_thread_yield()
+{
+    sched_yield();
+}
+
+u32 platform_get_processor_count()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+b8 platform_mutex_create(platform_mutex *out_mutex)
+{
+    if (!out_mutex)
+    {
+        return false;
+    }
+
+    pthread_mutex_t *mutex = platform_allocate(sizeof(pthread_mutex_t), false);
+    if (pthread_mutex_init(mutex, 0) != 0)
+    {
+        DERROR("platform_mutex_create - pthread_mutex_init failed.");
+        platform_free(mutex, false);
+        out_mutex->internal_data = 0;
+        return false;
+    }
+
+    out_mutex->internal_data = mutex;
+    return true;
+}
+
+void platform_mutex_destroy(platform_mutex *mutex)
+{
+    if (mutex && mutex->internal_data)
+    {
+        pthread_mutex_destroy(mutex->internal_data);
+        platform_free(mutex->internal_data, false);
+        mutex->internal_data = 0;
+    }
+}
+
+b8 platform_mutex_lock(platform_mutex *mutex)
+{
+    if (!mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    return pthread_mutex_lock(mutex->internal_data) == 0;
+}
+
+b8 platform_mutex_unlock(platform_mutex *mutex)
+{
+    if (!mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    return pthread_mutex_unlock(mutex->internal_data) == 0;
+}
+
+b8 platform_condition_create(platform_condition *out_condition)
+{
+    if (!out_condition)
+    {
+        return false;
+    }
+
+    pthread_cond_t *condition = platform_allocate(sizeof(pthread_cond_t), false);
+    if (pthread_cond_init(condition, 0) != 0)
+    {
+        DERROR("platform_condition_create - pthread_cond_init failed.");
+        platform_free(condition, false);
+        out_condition->internal_data = 0;
+        return false;
+    }
+
+    out_condition->internal_data = condition;
+    return true;
+}
+
+void platform_condition_destroy(platform_condition *condition)
+{
+    if (condition && condition->internal_data)
+    {
+        pthread_cond_destroy(condition->internal_data);
+        platform_free(condition->internal_data, false);
+        condition->internal_data = 0;
+    }
+}
+
+b8 platform_condition_wait(platform_condition *condition, platform_mutex *mutex)
+{
+    if (!condition || !condition->internal_data || !mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    return pthread_cond_wait(condition->internal_data, mutex->internal_data) == 0;
+}
+
+b8 platform_condition_wait_timeout(platform_condition *condition, platform_mutex *mutex, u64 timeout_ms)
+{
+    if (!condition || !condition->internal_data || !mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    // Condition variables are created with the default clock, which is CLOCK_REALTIME.
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000 * 1000;
+    if (deadline.tv_nsec >= 1000 * 1000 * 1000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000 * 1000 * 1000;
+    }
+    return pthread_cond_timedwait(condition->internal_data, mutex->internal_data, &deadline) == 0;
+}
+
+b8 platform_condition_signal(platform_condition *condition)
+{
+    if (!condition || !condition->internal_data)
+    {
+        return false;
+    }
+    return pthread_cond_signal(condition->internal_data) == 0;
+}
+
+b8 platform_condition_broadcast(platform_condition *condition)
+{
+    if (!condition || !condition->internal_data)
+    {
+        return false;
+    }
+    return pthread_cond_broadcast(condition->internal_data) == 0;
+}
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore *out_semaphore)
+{
+    if (!out_semaphore)
+    {
+        return false;
+    }
+
+    sem_t *semaphore = platform_allocate(sizeof(sem_t), false);
+    if (sem_init(semaphore, 0, initial_count) != 0)
+    {
+        DERROR("platform_semaphore_create - sem_init failed.");
+        platform_free(semaphore, false);
+        out_semaphore->internal_data = 0;
+        return false;
+    }
+
+    out_semaphore->internal_data = semaphore;
+    return true;
+}
+
+void platform_semaphore_destroy(platform_semaphore *semaphore)
+{
+    if (semaphore && semaphore->internal_data)
+    {
+        sem_destroy(semaphore->internal_data);
+        platform_free(semaphore->internal_data, false);
+        semaphore->internal_data = 0;
+    }
+}
+
+b8 platform_semaphore_signal(platform_semaphore *semaphore)
+{
+    if (!semaphore || !semaphore->internal_data)
+    {
+        return false;
+    }
+    return sem_post(semaphore->internal_data) == 0;
+}
+
+b8 platform_semaphore_wait(platform_semaphore *semaphore)
+{
+    if (!semaphore || !semaphore->internal_data)
+    {
+        return false;
+    }
+
+    // Retry if interrupted by a signal handler.
+    s32 result;
+    do
+    {
+        result = sem_wait(semaphore->internal_data);
+    } while (result != 0 && errno == EINTR);
+    return result == 0;
+}
+
 #endif
@@ -280,7 +280,7 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
         platform_state_ptr->width  = width;
         platform_state_ptr->height = height;
 
-        event_fire(EVENT_CODE_RESIZED, 0, context);
+        event_post(EVENT_CODE_RESIZED, 0, context);
     }
     break;
     case WM_KEYDOWN:
@@ -350,4 +350,225 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
     return DefWindowProcA(hwnd, msg, w_param, l_param);
 }
 
+typedef struct win32_thread
+{
+    HANDLE handle;
+    PFN_thread_start start_function;
+    void *params;
+} win32_thread;
+
+// Adapts PFN_thread_start to the signature CreateThread expects.
+static DWORD WINAPI win32_thread_trampoline(LPVOID arg)
+{
+    win32_thread *t = arg;
+    return t->start_function(t->params);
+}
+
+b8 platform_thread_create(PFN_thread_start start_function, void *params, platform_thread *out_thread)
+{
+    if (!start_function || !out_thread)
+    {
+        return false;
+    }
+
+    win32_thread *t   = platform_allocate(sizeof(win32_thread), false);
+    t->start_function = start_function;
+    t->params         = params;
+    DWORD thread_id   = 0;
+    t->handle         = CreateThread(0, 0, win32_thread_trampoline, t, 0, &thread_id);
+    if (!t->handle)
+    {
+        DERROR("platform_thread_create - CreateThread failed.");
+        platform_free(t, false);
+        out_thread->internal_data = 0;
+        return false;
+    }
+
+    out_thread->internal_data = t;
+    out_thread->thread_id     = thread_id;
+    return true;
+}
+
+void platform_thread_join(platform_thread *thread)
+{
+    if (thread && thread->internal_data)
+    {
+        win32_thread *t = thread->internal_data;
+        WaitForSingleObject(t->handle, INFINITE);
+        CloseHandle(t->handle);
+        platform_free(t, false);
+        thread->internal_data = 0;
+        thread->thread_id     = 0;
+    }
+}
+
+u64 platform_current_thread_id()
+{
+    return (u64)GetCurrentThreadId();
+}
+
+void platform_thread_yield()
+{
+    SwitchToThread();
+}
+
+u32 platform_get_processor_count()
+{
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return sysinfo.dwNumberOfProcessors > 0 ? sysinfo.dwNumberOfProcessors : 1;
+}
+
+b8 platform_mutex_create(platform_mutex *out_mutex)
+{
+    if (!out_mutex)
+    {
+        return false;
+    }
+
+    CRITICAL_SECTION *section = platform_allocate(sizeof(CRITICAL_SECTION), false);
+    InitializeCriticalSection(section);
+    out_mutex->internal_data = section;
+    return true;
+}
+
+void platform_mutex_destroy(platform_mutex *mutex)
+{
+    if (mutex && mutex->internal_data)
+    {
+        DeleteCriticalSection(mutex->internal_data);
+        platform_free(mutex->internal_data, false);
+        mutex->internal_data = 0;
+    }
+}
+
+b8 platform_mutex_lock(platform_mutex *mutex)
+{
+    if (!mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    EnterCriticalSection(mutex->internal_data);
+    return true;
+}
+
+b8 platform_mutex_unlock(platform_mutex *mutex)
+{
+    if (!mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    LeaveCriticalSection(mutex->internal_data);
+    return true;
+}
+
+b8 platform_condition_create(platform_condition *out_condition)
+{
+    if (!out_condition)
+    {
+        return false;
+    }
+
+    CONDITION_VARIABLE *condition = platform_allocate(sizeof(CONDITION_VARIABLE), false);
+    InitializeConditionVariable(condition);
+    out_condition->internal_data = condition;
+    return true;
+}
+
+void platform_condition_destroy(platform_condition *condition)
+{
+    // NOTE: Windows condition variables have no destroy function.
+    if (condition && condition->internal_data)
+    {
+        platform_free(condition->internal_data, false);
+        condition->internal_data = 0;
+    }
+}
+
+b8 platform_condition_wait(platform_condition *condition, platform_mutex *mutex)
+{
+    if (!condition || !condition->internal_data || !mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    return SleepConditionVariableCS(condition->internal_data, mutex->internal_data, INFINITE) != 0;
+}
+
+b8 platform_condition_wait_timeout(platform_condition *condition, platform_mutex *mutex, u64 timeout_ms)
+{
+    if (!condition || !condition->internal_data || !mutex || !mutex->internal_data)
+    {
+        return false;
+    }
+    // INFINITE is 0xFFFFFFFF, so keep long timeouts just under it.
+    DWORD timeout = timeout_ms < INFINITE ? (DWORD)timeout_ms : INFINITE - 1;
+    return SleepConditionVariableCS(condition->internal_data, mutex->internal_data, timeout) != 0;
+}
+
+b8 platform_condition_signal(platform_condition *condition)
+{
+    if (!condition || !condition->internal_data)
+    {
+        return false;
+    }
+    WakeConditionVariable(condition->internal_data);
+    return true;
+}
+
+b8 platform_condition_broadcast(platform_condition *condition)
+{
+    if (!condition || !condition->internal_data)
+    {
+        return false;
+    }
+    WakeAllConditionVariable(condition->internal_data);
+    return true;
+}
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore *out_semaphore)
+{
+    if (!out_semaphore)
+    {
+        return false;
+    }
+
+    HANDLE semaphore = CreateSemaphoreA(0, initial_count, 0x7FFFFFFF, 0);
+    if (!semaphore)
+    {
+        DERROR("platform_semaphore_create - CreateSemaphoreA failed.");
+        out_semaphore->internal_data = 0;
+        return false;
+    }
+
+    out_semaphore->internal_data = semaphore;
+    return true;
+}
+
+void platform_semaphore_destroy(platform_semaphore *semaphore)
+{
+    if (semaphore && semaphore->internal_data)
+    {
+        CloseHandle(semaphore->internal_data);
+        semaphore->internal_data = 0;
+    }
+}
+
+b8 platform_semaphore_signal(platform_semaphore *semaphore)
+{
+    if (!semaphore || !semaphore->internal_data)
+    {
+        return false;
+    }
+    return ReleaseSemaphore(semaphore->internal_data, 1, 0) != 0;
+}
+
+b8 platform_semaphore_wait(platform_semaphore *semaphore)
+{
+    if (!semaphore || !semaphore->internal_data)
+    {
+        return false;
+    }
+    return WaitForSingleObject(semaphore->internal_data, INFINITE) == WAIT_OBJECT_0;
+}
+
 #endif // DPLATFORM_WINDOWS
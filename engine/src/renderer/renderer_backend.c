@@ -8,15 +8,20 @@ b8 renderer_backend_create(renderer_backend_type type, renderer_backend *out_ren
     {
         out_renderer_backend->initialize          = vulkan_renderer_backend_initialize;
         out_renderer_backend->shutdown            = vulkan_renderer_backend_shutdown;
+        out_renderer_backend->prepare_frame       = vulkan_renderer_backend_prepare_frame;
+        out_renderer_backend->acquire_frame       = vulkan_renderer_backend_acquire_frame;
         out_renderer_backend->begin_frame         = vulkan_renderer_backend_begin_frame;
         out_renderer_backend->update_global_state = vulkan_renderer_update_global_state;
         out_renderer_backend->end_frame           = vulkan_renderer_backend_end_frame;
+        out_renderer_backend->present_frame       = vulkan_renderer_backend_present_frame;
         out_renderer_backend->resized             = vulkan_renderer_backend_on_resized;
         out_renderer_backend->draw_geometry       = vulkan_renderer_draw_geometry;
         out_renderer_backend->create_texture      = vulkan_renderer_create_texture;
+        out_renderer_backend->create_textures     = vulkan_renderer_create_textures;
         out_renderer_backend->destroy_texture     = vulkan_renderer_destroy_texture;
         out_renderer_backend->create_material     = vulkan_renderer_create_material;
         out_renderer_backend->destroy_material    = vulkan_renderer_destroy_material;
+        out_renderer_backend->reload_shaders      = vulkan_renderer_reload_shaders;
         out_renderer_backend->create_geometry     = vulkan_renderer_create_geometry;
         out_renderer_backend->destroy_geometry    = vulkan_renderer_destroy_geometry;
 
@@ -30,15 +35,20 @@ void renderer_backend_destroy(renderer_backend *renderer_backend)
 {
     renderer_backend->initialize          = 0;
     renderer_backend->shutdown            = 0;
+    renderer_backend->prepare_frame       = 0;
+    renderer_backend->acquire_frame       = 0;
     renderer_backend->begin_frame         = 0;
     renderer_backend->update_global_state = 0;
     renderer_backend->end_frame           = 0;
+    renderer_backend->present_frame       = 0;
     renderer_backend->resized             = 0;
     renderer_backend->draw_geometry       = 0;
     renderer_backend->create_texture      = 0;
+    renderer_backend->create_textures     = 0;
     renderer_backend->destroy_texture     = 0;
     renderer_backend->create_material     = 0;
     renderer_backend->destroy_material    = 0;
+    renderer_backend->reload_shaders      = 0;
     renderer_backend->create_geometry     = 0;
     renderer_backend->destroy_geometry    = 0;
 }
\ No newline at end of file
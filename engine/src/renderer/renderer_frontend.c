@@ -5,6 +5,7 @@
 #include "core/dmemory.h"
 #include "core/logger.h"
 #include "math/dmath.h"
+#include "platform/platform.h"
 
 #include "resources/resource_types.h"
 #include "systems/material_system.h"
@@ -21,8 +22,10 @@ typedef struct renderer_system_state
     renderer_backend backend;
     mat4 projection;
     mat4 view;
+    f32 fov;
     f32 near_clip;
     f32 far_clip;
+    u16 framebuffer_height;
 } renderer_system_state;
 
 static renderer_system_state *state_ptr;
@@ -46,10 +49,11 @@ b8 renderer_system_initialize(u64 *memory_requirement, void *state, const char *
         return false;
     }
 
-    state_ptr->near_clip = 0.1f;
-    state_ptr->far_clip  = 1000.0f;
-    state_ptr->projection =
-        mat4_perspective(deg_to_rad(45.0f), 1280 / 720.0f, state_ptr->near_clip, state_ptr->far_clip);
+    state_ptr->fov                = deg_to_rad(45.0f);
+    state_ptr->near_clip          = 0.1f;
+    state_ptr->far_clip           = 1000.0f;
+    state_ptr->framebuffer_height = 720;
+    state_ptr->projection = mat4_perspective(state_ptr->fov, 1280 / 720.0f, state_ptr->near_clip, state_ptr->far_clip);
 
     state_ptr->view = mat4_translation((vec3){0, 0, -30.0f});
     state_ptr->view = mat4_inverse(state_ptr->view);
@@ -91,7 +95,8 @@ void renderer_on_resized(u16 width, u16 height)
     if (state_ptr)
     {
         state_ptr->projection =
-            mat4_perspective(deg_to_rad(45.0f), width / (f32)height, state_ptr->near_clip, state_ptr->far_clip);
+            mat4_perspective(state_ptr->fov, width / (f32)height, state_ptr->near_clip, state_ptr->far_clip);
+        state_ptr->framebuffer_height = height;
         state_ptr->backend.resized(&state_ptr->backend, width, height);
     }
     else
@@ -100,12 +105,73 @@ void renderer_on_resized(u16 width, u16 height)
     }
 }
 
-b8 renderer_draw_frame(render_packet *packet)
+// Tells the texture system roughly how large each texture is drawn, from how large its geometry appears,
+// so the levels it needs can be streamed in.
+static void report_texture_sizes(render_packet *packet)
 {
+    mat4 camera           = mat4_inverse(packet->view);
+    vec3 camera_position  = (vec3){camera.data[12], camera.data[13], camera.data[14]};
+    f32 pixels_per_radian = state_ptr->framebuffer_height / (2.0f * dtan(state_ptr->fov * 0.5f));
+    for (u32 i = 0; i < packet->geometry_count; ++i)
+    {
+        geometry_render_data *data = &packet->geometries[i];
+        material *m                = data->geometry->material;
+        if (!m || !m->diffuse_map.texture)
+        {
+            continue;
+        }
+
+        // The model's scale along its first axis stands in for its overall scale.
+        mat4 *model  = &data->model;
+        f32 scale    = vec3_length((vec3){model->data[0], model->data[1], model->data[2]});
+        f32 radius   = data->geometry->radius * scale;
+        vec3 offset  = (vec3){model->data[12] - camera_position.x, model->data[13] - camera_position.y,
+                             model->data[14] - camera_position.z};
+        f32 distance = vec3_length(offset);
+        if (distance < radius)
+        {
+            distance = radius;
+        }
+        if (distance <= 0)
+        {
+            continue;
+        }
+
+        // The diameter, in pixels, the geometry spans at its distance.
+        texture_system_report_usage(m->diffuse_map.texture, 2.0f * radius / distance * pixels_per_radian);
+    }
+}
+
+b8 renderer_draw_frame(render_packet *packet, platform_mutex *resource_mutex)
+{
+    // A resize recreates what frames are drawn into, so it is handled under the lock.
+    if (resource_mutex)
+    {
+        platform_mutex_lock(resource_mutex);
+    }
+    b8 ready = state_ptr->backend.prepare_frame(&state_ptr->backend);
+    if (resource_mutex)
+    {
+        platform_mutex_unlock(resource_mutex);
+    }
+
+    // Waiting for the GPU and the display is left out of the lock, so resources can be created and destroyed
+    // meanwhile.
+    if (!ready || !state_ptr->backend.acquire_frame(&state_ptr->backend))
+    {
+        return true;
+    }
+
+    if (resource_mutex)
+    {
+        platform_mutex_lock(resource_mutex);
+    }
     // If the begin frame returned successfully, mid-frame operations may continue.
+    b8 result = true;
     if (renderer_begin_frame(packet->delta_time))
     {
-        state_ptr->backend.update_global_state(state_ptr->projection, state_ptr->view, vec3_zero(), vec4_one(), 0);
+        state_ptr->backend.update_global_state(state_ptr->projection, packet->view, vec3_zero(), vec4_one(), 0);
+        report_texture_sizes(packet);
 
         u32 count = packet->geometry_count;
         for (u32 i = 0; i < count; ++i)
@@ -114,16 +180,19 @@ b8 renderer_draw_frame(render_packet *packet)
         }
 
         // End the frame. If this fails, it is likely unrecoverable.
-        b8 result = renderer_end_frame(packet->delta_time);
-
-        if (!result)
-        {
-            DERROR("renderer_end_frame failed. Application shutting down...");
-            return false;
-        }
+        result = renderer_end_frame(packet->delta_time);
+    }
+    if (resource_mutex)
+    {
+        platform_mutex_unlock(resource_mutex);
     }
 
-    return true;
+    if (!result)
+    {
+        DERROR("renderer_end_frame failed. Application shutting down...");
+        return false;
+    }
+    return state_ptr->backend.present_frame(&state_ptr->backend);
 }
 
 void renderer_set_view(mat4 view)
@@ -131,11 +200,21 @@ void renderer_set_view(mat4 view)
     state_ptr->view = view;
 }
 
+mat4 renderer_get_view()
+{
+    return state_ptr->view;
+}
+
 void renderer_create_texture(const u8 *pixels, struct texture *texture)
 {
     state_ptr->backend.create_texture(pixels, texture);
 }
 
+void renderer_create_textures(u32 count, const u8 ***mips, struct texture **textures)
+{
+    state_ptr->backend.create_textures(count, mips, textures);
+}
+
 void renderer_destroy_texture(struct texture *texture)
 {
     state_ptr->backend.destroy_texture(texture);
@@ -151,6 +230,11 @@ void renderer_destroy_material(struct material *material)
     state_ptr->backend.destroy_material(material);
 }
 
+b8 renderer_reload_shaders()
+{
+    return state_ptr->backend.reload_shaders();
+}
+
 b8 renderer_create_geometry(geometry *geometry, u32 vertex_count, const vertex_3d *vertices, u32 index_count,
                             const u32 *indices)
 {
@@ -2,23 +2,53 @@
 
 #include "renderer_types.h"
 
+struct platform_mutex;
+
 b8 renderer_system_initialize(u64 *memory_requirement, void *state, const char *application_name);
 void renderer_system_shutdown(void *state);
 
 void renderer_on_resized(u16 width, u16 height);
 
-b8 renderer_draw_frame(render_packet *packet);
+/**
+ * @brief Draws a frame.
+ *
+ * @param packet What to draw.
+ * @param resource_mutex Optional. Held only while the frame uses renderer resources, and not while waiting for
+ * the GPU or the display, so another thread holding it may create and destroy them meanwhile. Can be 0/NULL.
+ * @return False if drawing failed in a way that is likely unrecoverable; otherwise true.
+ */
+b8 renderer_draw_frame(render_packet *packet, struct platform_mutex *resource_mutex);
 
 // HACK: this should not be exposed outside the engine.
 DAPI void renderer_set_view(mat4 view);
 
+// Returns the view last set with renderer_set_view. Used to fill in render packets.
+mat4 renderer_get_view();
+
 void renderer_create_texture(const u8 *pixels, struct texture *texture);
 
+/**
+ * @brief Creates several textures at once. The uploads are submitted to the GPU
+ * together, rather than waiting for each texture in turn.
+ *
+ * @param count The number of textures.
+ * @param mips An array of count arrays, each holding the pixels of each of a texture's mip levels, largest first.
+ * @param textures An array of count textures with their dimensions and mip_count filled in.
+ */
+void renderer_create_textures(u32 count, const u8 ***mips, struct texture **textures);
+
 void renderer_destroy_texture(struct texture *texture);
 
 b8 renderer_create_material(struct material *material);
 void renderer_destroy_material(struct material *material);
 
+/**
+ * @brief Reloads the shaders from their files, for hot reload. Waits for the GPU to go idle.
+ *
+ * @return True if reloaded; false if they could not be, in which case the current shaders stay in use.
+ */
+b8 renderer_reload_shaders();
+
 b8 renderer_create_geometry(geometry *geometry, u32 vertex_count, const vertex_3d *vertices, u32 index_count,
                             const u32 *indices);
 void renderer_destroy_geometry(geometry *geometry);
@@ -43,17 +43,27 @@ typedef struct renderer_backend
 
     void (*resized)(struct renderer_backend *backend, u16 width, u16 height);
 
+    // A frame is drawn in stages. Only begin_frame to end_frame use resources made by the functions below, so
+    // the rest may run while those are created or destroyed on another thread.
+    // Handles resizes. Returns false if the frame is to be skipped.
+    b8 (*prepare_frame)(struct renderer_backend *backend);
+    // Waits for the GPU to finish with the frame's resources, and for an image to draw to.
+    b8 (*acquire_frame)(struct renderer_backend *backend);
     b8 (*begin_frame)(struct renderer_backend *backend, f32 delta_time);
     void (*update_global_state)(mat4 projection, mat4 view, vec3 view_position, vec4 ambient_colour, s32 mode);
+    // Submits the frame.
     b8 (*end_frame)(struct renderer_backend *backend, f32 delta_time);
+    b8 (*present_frame)(struct renderer_backend *backend);
 
     void (*draw_geometry)(geometry_render_data data);
 
     void (*create_texture)(const u8 *pixels, struct texture *texture);
+    void (*create_textures)(u32 count, const u8 ***mips, struct texture **textures);
     void (*destroy_texture)(struct texture *texture);
 
     b8 (*create_material)(struct material *material);
     void (*destroy_material)(struct material *material);
+    b8 (*reload_shaders)();
 
     b8 (*create_geometry)(geometry *geometry, u32 vertex_count, const vertex_3d *vertices, u32 index_count,
                           const u32 *indices);
@@ -64,6 +74,9 @@ typedef struct render_packet
 {
     f32 delta_time;
 
+    // The camera view for this frame, captured when the packet is built.
+    mat4 view;
+
     u32 geometry_count;
     geometry_render_data *geometries;
 } render_packet;
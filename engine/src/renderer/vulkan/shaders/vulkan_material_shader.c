@@ -6,6 +6,7 @@
 #include "math/math_types.h"
 
 #include "renderer/vulkan/vulkan_buffer.h"
+#include "renderer/vulkan/vulkan_device.h"
 #include "renderer/vulkan/vulkan_pipeline.h"
 #include "renderer/vulkan/vulkan_shader_utils.h"
 
@@ -13,6 +14,66 @@
 
 #define BUILTIN_SHADER_NAME_MATERIAL "Builtin.MaterialShader"
 
+// Creates the pipeline from the given stages, using the shader's descriptor set layouts.
+static b8 create_pipeline(vulkan_context *context, const vulkan_material_shader *shader,
+                          const vulkan_shader_stage *stages, vulkan_pipeline *out_pipeline)
+{
+    VkViewport viewport;
+    viewport.x        = 0.0f;
+    viewport.y        = (f32)context->framebuffer_height;
+    viewport.width    = (f32)context->framebuffer_width;
+    viewport.height   = -(f32)context->framebuffer_height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    // Scissor
+    VkRect2D scissor;
+    scissor.offset.x = scissor.offset.y = 0;
+    scissor.extent.width                = context->framebuffer_width;
+    scissor.extent.height               = context->framebuffer_height;
+
+    // Attributes
+    u32 offset = 0;
+#define ATTRIBUTE_COUNT 2
+    VkVertexInputAttributeDescription attribute_descriptions[ATTRIBUTE_COUNT];
+    // Position, texcoord
+    VkFormat formats[ATTRIBUTE_COUNT] = {VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32_SFLOAT};
+    u64 sizes[ATTRIBUTE_COUNT]        = {sizeof(vec3), sizeof(vec2)};
+    for (u32 i = 0; i < ATTRIBUTE_COUNT; ++i)
+    {
+        attribute_descriptions[i].binding  = 0; // binding index - should match binding desc
+        attribute_descriptions[i].location = i; // attrib location
+        attribute_descriptions[i].format   = formats[i];
+        attribute_descriptions[i].offset   = offset;
+        offset += sizes[i];
+    }
+
+    // Desciptor set layouts.
+    const s32 descriptor_set_layout_count = 2;
+    VkDescriptorSetLayout layouts[2]      = {shader->global_descriptor_set_layout,
+                                             shader->object_descriptor_set_layout};
+
+    // Stages
+    // NOTE: Should match the number of shader->stages.
+    VkPipelineShaderStageCreateInfo stage_create_infos[MATERIAL_SHADER_STAGE_COUNT];
+    dzero_memory(stage_create_infos, sizeof(stage_create_infos));
+    for (u32 i = 0; i < MATERIAL_SHADER_STAGE_COUNT; ++i)
+    {
+        stage_create_infos[i].sType = stages[i].shader_stage_create_info.sType;
+        stage_create_infos[i]       = stages[i].shader_stage_create_info;
+    }
+
+    if (!vulkan_graphics_pipeline_create(context, &context->main_renderpass, ATTRIBUTE_COUNT, attribute_descriptions,
+                                         descriptor_set_layout_count, layouts, MATERIAL_SHADER_STAGE_COUNT,
+                                         stage_create_infos, viewport, scissor, false, out_pipeline))
+    {
+        DERROR("Failed to load graphics pipeline for object shader.");
+        return false;
+    }
+
+    return true;
+}
+
 b8 vulkan_material_shader_create(vulkan_context *context, vulkan_material_shader *out_shader)
 {
     // Shader module init per stage.
@@ -100,56 +161,8 @@ b8 vulkan_material_shader_create(vulkan_context *context, vulkan_material_shader
                                     &out_shader->object_descriptor_pool));
 
     // Pipeline creation
-    VkViewport viewport;
-    viewport.x        = 0.0f;
-    viewport.y        = (f32)context->framebuffer_height;
-    viewport.width    = (f32)context->framebuffer_width;
-    viewport.height   = -(f32)context->framebuffer_height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    // Scissor
-    VkRect2D scissor;
-    scissor.offset.x = scissor.offset.y = 0;
-    scissor.extent.width                = context->framebuffer_width;
-    scissor.extent.height               = context->framebuffer_height;
-
-    // Attributes
-    u32 offset = 0;
-#define ATTRIBUTE_COUNT 2
-    VkVertexInputAttributeDescription attribute_descriptions[ATTRIBUTE_COUNT];
-    // Position, texcoord
-    VkFormat formats[ATTRIBUTE_COUNT] = {VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32_SFLOAT};
-    u64 sizes[ATTRIBUTE_COUNT]        = {sizeof(vec3), sizeof(vec2)};
-    for (u32 i = 0; i < ATTRIBUTE_COUNT; ++i)
-    {
-        attribute_descriptions[i].binding  = 0; // binding index - should match binding desc
-        attribute_descriptions[i].location = i; // attrib location
-        attribute_descriptions[i].format   = formats[i];
-        attribute_descriptions[i].offset   = offset;
-        offset += sizes[i];
-    }
-
-    // Desciptor set layouts.
-    const s32 descriptor_set_layout_count = 2;
-    VkDescriptorSetLayout layouts[2]      = {out_shader->global_descriptor_set_layout,
-                                             out_shader->object_descriptor_set_layout};
-
-    // Stages
-    // NOTE: Should match the number of shader->stages.
-    VkPipelineShaderStageCreateInfo stage_create_infos[MATERIAL_SHADER_STAGE_COUNT];
-    dzero_memory(stage_create_infos, sizeof(stage_create_infos));
-    for (u32 i = 0; i < MATERIAL_SHADER_STAGE_COUNT; ++i)
-    {
-        stage_create_infos[i].sType = out_shader->stages[i].shader_stage_create_info.sType;
-        stage_create_infos[i]       = out_shader->stages[i].shader_stage_create_info;
-    }
-
-    if (!vulkan_graphics_pipeline_create(context, &context->main_renderpass, ATTRIBUTE_COUNT, attribute_descriptions,
-                                         descriptor_set_layout_count, layouts, MATERIAL_SHADER_STAGE_COUNT,
-                                         stage_create_infos, viewport, scissor, false, &out_shader->pipeline))
+    if (!create_pipeline(context, out_shader, out_shader->stages, &out_shader->pipeline))
     {
-        DERROR("Failed to load graphics pipeline for object shader.");
         return false;
     }
 
@@ -218,6 +231,56 @@ void vulkan_material_shader_destroy(vulkan_context *context, struct vulkan_mater
     }
 }
 
+b8 vulkan_material_shader_reload(vulkan_context *context, struct vulkan_material_shader *shader)
+{
+    // Build the new modules and pipeline alongside the current ones, so a shader that fails to load
+    // leaves the current one in use.
+    char stage_type_strs[MATERIAL_SHADER_STAGE_COUNT][5]           = {"vert", "frag"};
+    VkShaderStageFlagBits stage_types[MATERIAL_SHADER_STAGE_COUNT] = {VK_SHADER_STAGE_VERTEX_BIT,
+                                                                      VK_SHADER_STAGE_FRAGMENT_BIT};
+    vulkan_shader_stage stages[MATERIAL_SHADER_STAGE_COUNT];
+    dzero_memory(stages, sizeof(stages));
+
+    b8 result = true;
+    for (u32 i = 0; i < MATERIAL_SHADER_STAGE_COUNT && result; ++i)
+    {
+        result = create_shader_module(context, BUILTIN_SHADER_NAME_MATERIAL, stage_type_strs[i], stage_types[i], i,
+                                      stages);
+    }
+
+    vulkan_pipeline pipeline = {0};
+    if (result)
+    {
+        result = create_pipeline(context, shader, stages, &pipeline);
+    }
+
+    if (!result)
+    {
+        DERROR("Unable to reload shader '%s'; keeping the current one.", BUILTIN_SHADER_NAME_MATERIAL);
+        for (u32 i = 0; i < MATERIAL_SHADER_STAGE_COUNT; ++i)
+        {
+            if (stages[i].handle)
+            {
+                vkDestroyShaderModule(context->device.logical_device, stages[i].handle, context->allocator);
+            }
+        }
+        return false;
+    }
+
+    // The current pipeline may still be in use by frames in flight.
+    vulkan_device_wait_idle(&context->device);
+    vulkan_pipeline_destroy(context, &shader->pipeline);
+    for (u32 i = 0; i < MATERIAL_SHADER_STAGE_COUNT; ++i)
+    {
+        vkDestroyShaderModule(context->device.logical_device, shader->stages[i].handle, context->allocator);
+        shader->stages[i] = stages[i];
+    }
+    shader->pipeline = pipeline;
+
+    DINFO("Reloaded shader '%s'.", BUILTIN_SHADER_NAME_MATERIAL);
+    return true;
+}
+
 void vulkan_material_shader_use(vulkan_context *context, struct vulkan_material_shader *shader)
 {
     u32 image_index = context->image_index;
@@ -444,7 +507,7 @@ void vulkan_material_shader_release_resources(vulkan_context *context, struct vu
     const u32 descriptor_set_count = 3;
 
     // Wait for any pending operations using the descriptor set to finish.
-    vkDeviceWaitIdle(context->device.logical_device);
+    vulkan_device_wait_idle(&context->device);
 
     // Release object descriptor sets.
     VkResult result = vkFreeDescriptorSets(context->device.logical_device, shader->object_descriptor_pool,
@@ -7,6 +7,10 @@ b8 vulkan_material_shader_create(vulkan_context *context, vulkan_material_shader
 
 void vulkan_material_shader_destroy(vulkan_context *context, struct vulkan_material_shader *shader);
 
+// Recreates the shader modules and pipeline from the current shader files, keeping descriptor state.
+// On failure, the current modules and pipeline stay in use.
+b8 vulkan_material_shader_reload(vulkan_context *context, struct vulkan_material_shader *shader);
+
 void vulkan_material_shader_use(vulkan_context *context, struct vulkan_material_shader *shader);
 
 void vulkan_material_shader_update_global_state(vulkan_context *context, struct vulkan_material_shader *shader,
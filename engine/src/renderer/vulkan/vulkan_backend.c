@@ -44,6 +44,7 @@ b8 create_buffers(vulkan_context *context);
 void create_command_buffers(renderer_backend *backend);
 void regenerate_framebuffers(renderer_backend *backend, vulkan_swapchain *swapchain, vulkan_renderpass *renderpass);
 b8 recreate_swapchain(renderer_backend *backend);
+static void release_textures(u32 finished_frame, b8 all);
 
 void upload_data_range(vulkan_context *context, VkCommandPool pool, VkFence fence, VkQueue queue, vulkan_buffer *buffer,
                        u64 offset, u64 size, const void *data)
@@ -241,6 +242,8 @@ b8 vulkan_renderer_backend_initialize(renderer_backend *backend, const char *app
         context.images_in_flight[i] = 0;
     }
 
+    context.texture_releases = darray_create(vulkan_texture_release);
+
     // Create builtin shaders
     if (!vulkan_material_shader_create(&context, &context.material_shader))
     {
@@ -262,9 +265,14 @@ b8 vulkan_renderer_backend_initialize(renderer_backend *backend, const char *app
 
 void vulkan_renderer_backend_shutdown(renderer_backend *backend)
 {
-    vkDeviceWaitIdle(context.device.logical_device);
+    vulkan_device_wait_idle(&context.device);
 
     // Destroy in the opposite order of creation.
+    // Textures waiting for their frames, which are now finished.
+    release_textures(0, true);
+    darray_destroy(context.texture_releases);
+    context.texture_releases = 0;
+
     // Destroy buffers
     vulkan_buffer_destroy(&context, &context.object_vertex_buffer);
     vulkan_buffer_destroy(&context, &context.object_index_buffer);
@@ -358,18 +366,17 @@ void vulkan_renderer_backend_on_resized(renderer_backend *backend, u16 width, u1
     DINFO("Vulkan renderer backend->resized: w/h/gen: %i/%i/%llu", width, height, context.framebuffer_size_generation);
 }
 
-b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time)
+b8 vulkan_renderer_backend_prepare_frame(renderer_backend *backend)
 {
-    context.frame_delta_time = delta_time;
-    vulkan_device *device    = &context.device;
+    vulkan_device *device = &context.device;
 
     // Check if recreating swap chain and boot out.
     if (context.recreating_swapchain)
     {
-        VkResult result = vkDeviceWaitIdle(device->logical_device);
+        VkResult result = vulkan_device_wait_idle(device);
         if (!vulkan_result_is_success(result))
         {
-            DERROR("vulkan_renderer_backend_begin_frame vkDeviceWaitIdle (1) failed: '%s'",
+            DERROR("vulkan_renderer_backend_prepare_frame vkDeviceWaitIdle (1) failed: '%s'",
                    vulkan_result_string(result, true));
             return false;
         }
@@ -380,10 +387,10 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time
     // Check if the framebuffer has been resized. If so, a new swapchain must be created.
     if (context.framebuffer_size_generation != context.framebuffer_size_last_generation)
     {
-        VkResult result = vkDeviceWaitIdle(device->logical_device);
+        VkResult result = vulkan_device_wait_idle(device);
         if (!vulkan_result_is_success(result))
         {
-            DERROR("vulkan_renderer_backend_begin_frame vkDeviceWaitIdle (2) failed: '%s'",
+            DERROR("vulkan_renderer_backend_prepare_frame vkDeviceWaitIdle (2) failed: '%s'",
                    vulkan_result_string(result, true));
             return false;
         }
@@ -399,6 +406,11 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time
         return false;
     }
 
+    return true;
+}
+
+b8 vulkan_renderer_backend_acquire_frame(renderer_backend *backend)
+{
     // Wait for the execution of the current frame to complete. The fence being free will allow this one to move on.
     if (!vulkan_fence_wait(&context, &context.in_flight_fences[context.current_frame], UINT64_MAX))
     {
@@ -415,6 +427,22 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time
         return false;
     }
 
+    // Make sure the previous frame is not using this image (i.e. its fence is being waited on)
+    if (context.images_in_flight[context.image_index] != VK_NULL_HANDLE)
+    { // was frame
+        vulkan_fence_wait(&context, context.images_in_flight[context.image_index], UINT64_MAX);
+    }
+
+    return true;
+}
+
+b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time)
+{
+    context.frame_delta_time = delta_time;
+
+    // The frame last using this frame's fence has finished, so it can no longer be using any destroyed texture.
+    release_textures(context.current_frame, false);
+
     // Begin recording commands.
     vulkan_command_buffer *command_buffer = &context.graphics_command_buffers[context.image_index];
     vulkan_command_buffer_reset(command_buffer);
@@ -471,12 +499,6 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend *backend, f32 delta_time)
 
     vulkan_command_buffer_end(command_buffer);
 
-    // Make sure the previous frame is not using this image (i.e. its fence is being waited on)
-    if (context.images_in_flight[context.image_index] != VK_NULL_HANDLE)
-    { // was frame
-        vulkan_fence_wait(&context, context.images_in_flight[context.image_index], UINT64_MAX);
-    }
-
     // Mark the image fence as in-use by this frame.
     context.images_in_flight[context.image_index] = &context.in_flight_fences[context.current_frame];
 
@@ -505,8 +527,8 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend *backend, f32 delta_time)
     VkPipelineStageFlags flags[1] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
     submit_info.pWaitDstStageMask = flags;
 
-    VkResult result = vkQueueSubmit(context.device.graphics_queue, 1, &submit_info,
-                                    context.in_flight_fences[context.current_frame].handle);
+    VkResult result = vulkan_device_queue_submit(&context.device, context.device.graphics_queue, 1, &submit_info,
+                                                 context.in_flight_fences[context.current_frame].handle);
     if (result != VK_SUCCESS)
     {
         DERROR("vkQueueSubmit failed with result: %s", vulkan_result_string(result, true));
@@ -516,10 +538,14 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend *backend, f32 delta_time)
     vulkan_command_buffer_update_submitted(command_buffer);
     // End queue submission
 
+    return true;
+}
+
+b8 vulkan_renderer_backend_present_frame(renderer_backend *backend)
+{
     // Give the image back to the swapchain.
     vulkan_swapchain_present(&context, &context.swapchain, context.device.graphics_queue, context.device.present_queue,
                              context.queue_complete_semaphores[context.current_frame], context.image_index);
-
     return true;
 }
 
@@ -625,7 +651,10 @@ b8 recreate_swapchain(renderer_backend *backend)
     context.recreating_swapchain = true;
 
     // Wait for any operations to complete.
-    vkDeviceWaitIdle(context.device.logical_device);
+    vulkan_device_wait_idle(&context.device);
+
+    // Nothing is in flight.
+    release_textures(0, true);
 
     // Clear these out just in case.
     for (u32 i = 0; i < context.swapchain.image_count; ++i)
@@ -708,96 +737,182 @@ b8 create_buffers(vulkan_context *context)
     return true;
 }
 
+// Gets the size in bytes of a mip level of a texture.
+static VkDeviceSize mip_size(const texture *texture, u32 level)
+{
+    u32 width  = texture->width >> level ? texture->width >> level : 1;
+    u32 height = texture->height >> level ? texture->height >> level : 1;
+    return (VkDeviceSize)width * height * texture->channel_count;
+}
+
 void vulkan_renderer_create_texture(const u8 *pixels, texture *texture)
 {
-    // Internal data creation.
-    // TODO: Use an allocator for this.
-    texture->internal_data    = (vulkan_texture_data *)dallocate(sizeof(vulkan_texture_data), MEMORY_TAG_TEXTURE);
-    vulkan_texture_data *data = (vulkan_texture_data *)texture->internal_data;
-    VkDeviceSize image_size   = texture->width * texture->height * texture->channel_count;
+    const u8 **mips    = &pixels;
+    texture->mip_count = 1;
+    vulkan_renderer_create_textures(1, &mips, &texture);
+}
+
+void vulkan_renderer_create_textures(u32 count, const u8 ***mips, texture **textures)
+{
+    if (count == 0)
+    {
+        return;
+    }
 
     // NOTE: Assumes 8 bits per channel.
     VkFormat image_format = VK_FORMAT_R8G8B8A8_UNORM;
 
-    // Create a staging buffer and load data into it.
-    VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    VkMemoryPropertyFlags memory_prop_flags =
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    vulkan_buffer staging;
-    vulkan_buffer_create(&context, image_size, usage, memory_prop_flags, true, &staging);
+    // One staging buffer per texture, all kept alive until the single submit below completes.
+    vulkan_buffer *staging = dallocate(sizeof(vulkan_buffer) * count, MEMORY_TAG_RENDERER);
 
-    vulkan_buffer_load_data(&context, &staging, 0, image_size, 0, pixels);
+    for (u32 i = 0; i < count; ++i)
+    {
+        texture *texture = textures[i];
+
+        // Internal data creation.
+        // TODO: Use an allocator for this.
+        texture->internal_data    = (vulkan_texture_data *)dallocate(sizeof(vulkan_texture_data), MEMORY_TAG_TEXTURE);
+        vulkan_texture_data *data = (vulkan_texture_data *)texture->internal_data;
+        u32 mip_count             = texture->mip_count ? texture->mip_count : 1;
+        VkDeviceSize image_size   = 0;
+        for (u32 level = 0; level < mip_count; ++level)
+        {
+            image_size += mip_size(texture, level);
+        }
 
-    // NOTE: Lots of assumptions here, different texture types will require
-    // different options here.
-    vulkan_image_create(&context, VK_IMAGE_TYPE_2D, texture->width, texture->height, image_format,
-                        VK_IMAGE_TILING_OPTIMAL,
-                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
-                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true, VK_IMAGE_ASPECT_COLOR_BIT, &data->image);
+        // Create a staging buffer and load each level into it, back to back.
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        VkMemoryPropertyFlags memory_prop_flags =
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        vulkan_buffer_create(&context, image_size, usage, memory_prop_flags, true, &staging[i]);
+
+        VkDeviceSize offset = 0;
+        for (u32 level = 0; level < mip_count; ++level)
+        {
+            vulkan_buffer_load_data(&context, &staging[i], offset, mip_size(texture, level), 0, mips[i][level]);
+            offset += mip_size(texture, level);
+        }
+
+        // NOTE: Lots of assumptions here, different texture types will require
+        // different options here.
+        vulkan_image_create(&context, VK_IMAGE_TYPE_2D, texture->width, texture->height, mip_count, image_format,
+                            VK_IMAGE_TILING_OPTIMAL,
+                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true, VK_IMAGE_ASPECT_COLOR_BIT, &data->image);
+    }
 
+    // Record every copy into one command buffer, so the queue is only waited on once.
     vulkan_command_buffer temp_buffer;
     VkCommandPool pool = context.device.graphics_command_pool;
     VkQueue queue      = context.device.graphics_queue;
     vulkan_command_buffer_allocate_and_begin_single_use(&context, pool, &temp_buffer);
 
-    // Transition the layout from whatever it is currently to optimal for recieving data.
-    vulkan_image_transition_layout(&context, &temp_buffer, &data->image, image_format, VK_IMAGE_LAYOUT_UNDEFINED,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    for (u32 i = 0; i < count; ++i)
+    {
+        vulkan_texture_data *data = (vulkan_texture_data *)textures[i]->internal_data;
+
+        // Transition the layout from whatever it is currently to optimal for recieving data.
+        vulkan_image_transition_layout(&context, &temp_buffer, &data->image, image_format, VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-    // Copy the data from the buffer.
-    vulkan_image_copy_from_buffer(&context, &data->image, staging.handle, &temp_buffer);
+        // Copy the data from the buffer.
+        vulkan_image_copy_from_buffer(&context, &data->image, staging[i].handle, &temp_buffer);
 
-    // Transition from optimal for data reciept to shader-read-only optimal layout.
-    vulkan_image_transition_layout(&context, &temp_buffer, &data->image, image_format,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        // Transition from optimal for data reciept to shader-read-only optimal layout.
+        vulkan_image_transition_layout(&context, &temp_buffer, &data->image, image_format,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
 
     vulkan_command_buffer_end_single_use(&context, pool, &temp_buffer, queue);
 
-    vulkan_buffer_destroy(&context, &staging);
-
-    // Create a sampler for the texture
-    VkSamplerCreateInfo sampler_info = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
-    // TODO: These filters should be configurable.
-    sampler_info.magFilter               = VK_FILTER_LINEAR;
-    sampler_info.minFilter               = VK_FILTER_LINEAR;
-    sampler_info.addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    sampler_info.addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    sampler_info.addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    sampler_info.anisotropyEnable        = VK_TRUE;
-    sampler_info.maxAnisotropy           = 16;
-    sampler_info.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    sampler_info.unnormalizedCoordinates = VK_FALSE;
-    sampler_info.compareEnable           = VK_FALSE;
-    sampler_info.compareOp               = VK_COMPARE_OP_ALWAYS;
-    sampler_info.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    sampler_info.mipLodBias              = 0.0f;
-    sampler_info.minLod                  = 0.0f;
-    sampler_info.maxLod                  = 0.0f;
-
-    VkResult result = vkCreateSampler(context.device.logical_device, &sampler_info, context.allocator, &data->sampler);
-    if (!vulkan_result_is_success(VK_SUCCESS))
-    {
-        DERROR("Error creating texture sampler: %s", vulkan_result_string(result, true));
-        return;
+    for (u32 i = 0; i < count; ++i)
+    {
+        vulkan_buffer_destroy(&context, &staging[i]);
+    }
+    dfree(staging, sizeof(vulkan_buffer) * count, MEMORY_TAG_RENDERER);
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        vulkan_texture_data *data = (vulkan_texture_data *)textures[i]->internal_data;
+
+        // Create a sampler for the texture
+        VkSamplerCreateInfo sampler_info = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+        // TODO: These filters should be configurable.
+        sampler_info.magFilter               = VK_FILTER_LINEAR;
+        sampler_info.minFilter               = VK_FILTER_LINEAR;
+        sampler_info.addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.anisotropyEnable        = VK_TRUE;
+        sampler_info.maxAnisotropy           = 16;
+        sampler_info.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        sampler_info.unnormalizedCoordinates = VK_FALSE;
+        sampler_info.compareEnable           = VK_FALSE;
+        sampler_info.compareOp               = VK_COMPARE_OP_ALWAYS;
+        sampler_info.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        sampler_info.mipLodBias              = 0.0f;
+        sampler_info.minLod                  = 0.0f;
+        sampler_info.maxLod                  = (f32)data->image.mip_levels;
+
+        VkResult result =
+            vkCreateSampler(context.device.logical_device, &sampler_info, context.allocator, &data->sampler);
+        if (!vulkan_result_is_success(result))
+        {
+            DERROR("Error creating texture sampler: %s", vulkan_result_string(result, true));
+            continue;
+        }
+
+        textures[i]->generation++;
     }
+}
 
-    texture->generation++;
+static void destroy_texture_data(vulkan_texture_data *data)
+{
+    vulkan_image_destroy(&context, &data->image);
+    dzero_memory(&data->image, sizeof(vulkan_image));
+    vkDestroySampler(context.device.logical_device, data->sampler, context.allocator);
+    data->sampler = 0;
+
+    dfree(data, sizeof(vulkan_texture_data), MEMORY_TAG_TEXTURE);
 }
 
-void vulkan_renderer_destroy_texture(struct texture *texture)
+// Destroys the released textures no frame in flight can still be using, now that finished_frame has finished.
+// With all, destroys every one; only when the device is idle.
+static void release_textures(u32 finished_frame, b8 all)
 {
-    vkDeviceWaitIdle(context.device.logical_device);
+    u64 length    = darray_length(context.texture_releases);
+    u64 remaining = 0;
+    for (u64 i = 0; i < length; ++i)
+    {
+        vulkan_texture_release release = context.texture_releases[i];
+        // Also drops frames beyond those in flight, which a recreated swapchain may have fewer of.
+        release.pending_frames &= ((1u << context.swapchain.max_frames_in_flight) - 1) & ~(1u << finished_frame);
+        if (all || release.pending_frames == 0)
+        {
+            destroy_texture_data(release.data);
+        }
+        else
+        {
+            context.texture_releases[remaining++] = release;
+        }
+    }
+    darray_length_set(context.texture_releases, remaining);
+}
 
+void vulkan_renderer_destroy_texture(struct texture *texture)
+{
+    // Frames already submitted may still sample the texture, so it is destroyed once each of them has finished,
+    // rather than stalling on the device.
     vulkan_texture_data *data = (vulkan_texture_data *)texture->internal_data;
     if (data)
     {
-        vulkan_image_destroy(&context, &data->image);
-        dzero_memory(&data->image, sizeof(vulkan_image));
-        vkDestroySampler(context.device.logical_device, data->sampler, context.allocator);
-        data->sampler = 0;
-
-        dfree(texture->internal_data, sizeof(vulkan_texture_data), MEMORY_TAG_TEXTURE);
+        // Pending on every frame index. Those beyond the frames in flight are dropped when released, since the
+        // render thread may change how many there are.
+        vulkan_texture_release release = {0};
+        release.data                   = data;
+        release.pending_frames         = ~0u;
+        darray_push(context.texture_releases, release);
     }
     dzero_memory(texture, sizeof(struct texture));
 }
@@ -830,15 +945,21 @@ void vulkan_renderer_destroy_material(struct material *material)
         }
         else
         {
-            DWARN("vulkan_renderer_destroy_material called with internal_id=INVALID_ID. Nothing was done.");
+            DLOG_RATE_LIMITED(LOG_LEVEL_WARN,
+                              "vulkan_renderer_destroy_material called with internal_id=INVALID_ID. Nothing was done.");
         }
     }
     else
     {
-        DWARN("vulkan_renderer_destroy_material called with nullptr. Nothing was done.");
+        DLOG_RATE_LIMITED(LOG_LEVEL_WARN, "vulkan_renderer_destroy_material called with nullptr. Nothing was done.");
     }
 }
 
+b8 vulkan_renderer_reload_shaders()
+{
+    return vulkan_material_shader_reload(&context, &context.material_shader);
+}
+
 b8 vulkan_renderer_create_geometry(geometry *geometry, u32 vertex_count, const vertex_3d *vertices, u32 index_count,
                                    const u32 *indices)
 {
@@ -940,7 +1061,7 @@ void vulkan_renderer_destroy_geometry(geometry *geometry)
 {
     if (geometry && geometry->internal_id != INVALID_ID)
     {
-        vkDeviceWaitIdle(context.device.logical_device);
+        vulkan_device_wait_idle(&context.device);
         vulkan_geometry_data *internal_data = &context.geometries[geometry->internal_id];
 
         // Free vertex data
@@ -987,6 +1108,10 @@ void vulkan_renderer_draw_geometry(geometry_render_data data)
     }
     vulkan_material_shader_apply_material(&context, &context.material_shader, m);
 
+    // Logged for every draw, so without formatting.
+    DLOG_BINARY(LOG_LEVEL_TRACE, "Drawing geometry %u with material %u: %u vertices, %u indices.", data.geometry->id,
+                m->id, buffer_data->vertex_count, buffer_data->index_count);
+
     // Bind vertex buffer at offset.
     VkDeviceSize offsets[1] = {buffer_data->vertex_buffer_offset};
     vkCmdBindVertexBuffers(command_buffer->handle, 0, 1, &context.object_vertex_buffer.handle, (VkDeviceSize *)offsets);
@@ -8,17 +8,22 @@ void vulkan_renderer_backend_shutdown(renderer_backend *backend);
 
 void vulkan_renderer_backend_on_resized(renderer_backend *backend, u16 width, u16 height);
 
+b8 vulkan_renderer_backend_prepare_frame(renderer_backend *backend);
+b8 vulkan_renderer_backend_acquire_frame(renderer_backend *backend);
 b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time);
 void vulkan_renderer_update_global_state(mat4 projection, mat4 view, vec3 view_position, vec4 ambient_colour, s32 mode);
 b8 vulkan_renderer_backend_end_frame(renderer_backend *backend, f32 delta_time);
+b8 vulkan_renderer_backend_present_frame(renderer_backend *backend);
 
 void vulkan_renderer_draw_geometry(geometry_render_data data);
 
 void vulkan_renderer_create_texture(const u8 *pixels, texture *texture);
+void vulkan_renderer_create_textures(u32 count, const u8 ***mips, texture **textures);
 void vulkan_renderer_destroy_texture(texture *texture);
 
 b8 vulkan_renderer_create_material(struct material *material);
 void vulkan_renderer_destroy_material(struct material *material);
+b8 vulkan_renderer_reload_shaders();
 
 b8 vulkan_renderer_create_geometry(geometry *geometry, u32 vertex_count, const vertex_3d *vertices, u32 index_count,
                                    const u32 *indices);
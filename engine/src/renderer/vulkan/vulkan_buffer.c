@@ -109,7 +109,7 @@ b8 vulkan_buffer_resize(vulkan_context *context, u64 new_size, vulkan_buffer *bu
     vulkan_buffer_copy_to(context, pool, 0, queue, buffer->handle, 0, new_buffer, 0, buffer->total_size);
 
     // Make sure anything potentially using these is finished.
-    vkDeviceWaitIdle(context->device.logical_device);
+    vulkan_device_wait_idle(&context->device);
 
     // Destroy the old
     if (buffer->memory)
@@ -160,7 +160,7 @@ void vulkan_buffer_load_data(vulkan_context *context, vulkan_buffer *buffer, u64
 void vulkan_buffer_copy_to(vulkan_context *context, VkCommandPool pool, VkFence fence, VkQueue queue, VkBuffer source,
                            u64 source_offset, VkBuffer dest, u64 dest_offset, u64 size)
 {
-    vkQueueWaitIdle(queue);
+    vulkan_device_queue_wait_idle(&context->device, queue);
     // Create a one-time-use command buffer.
     vulkan_command_buffer temp_command_buffer;
     vulkan_command_buffer_allocate_and_begin_single_use(context, pool, &temp_command_buffer);
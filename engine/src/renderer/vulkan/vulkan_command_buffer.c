@@ -1,4 +1,5 @@
 #include "vulkan_command_buffer.h"
+#include "vulkan_device.h"
 
 #include "core/dmemory.h"
 
@@ -84,10 +85,10 @@ void vulkan_command_buffer_end_single_use(vulkan_context *context, VkCommandPool
     VkSubmitInfo submit_info       = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers    = &command_buffer->handle;
-    VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, 0));
+    VK_CHECK(vulkan_device_queue_submit(&context->device, queue, 1, &submit_info, 0));
 
     // Wait for it to finish
-    VK_CHECK(vkQueueWaitIdle(queue));
+    VK_CHECK(vulkan_device_queue_wait_idle(&context->device, queue));
 
     // Free the command buffer.
     vulkan_command_buffer_free(context, pool, command_buffer);
@@ -140,6 +140,12 @@ b8 vulkan_device_create(vulkan_context *context)
                      &context->device.transfer_queue);
     DINFO("Queues obtained.");
 
+    if (!platform_mutex_create(&context->device.queue_mutex))
+    {
+        DERROR("Failed to create the queue mutex.");
+        return false;
+    }
+
     // Create command pool for graphics queue.
     VkCommandPoolCreateInfo pool_create_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
     pool_create_info.queueFamilyIndex        = context->device.graphics_queue_index;
@@ -157,6 +163,7 @@ void vulkan_device_destroy(vulkan_context *context)
     context->device.graphics_queue = 0;
     context->device.present_queue  = 0;
     context->device.transfer_queue = 0;
+    platform_mutex_destroy(&context->device.queue_mutex);
 
     DINFO("Destroying command pools...");
     vkDestroyCommandPool(context->device.logical_device, context->device.graphics_command_pool, context->allocator);
@@ -197,6 +204,39 @@ void vulkan_device_destroy(vulkan_context *context)
     context->device.transfer_queue_index = -1;
 }
 
+VkResult vulkan_device_queue_submit(vulkan_device *device, VkQueue queue, u32 submit_count, const VkSubmitInfo *submits,
+                                    VkFence fence)
+{
+    platform_mutex_lock(&device->queue_mutex);
+    VkResult result = vkQueueSubmit(queue, submit_count, submits, fence);
+    platform_mutex_unlock(&device->queue_mutex);
+    return result;
+}
+
+VkResult vulkan_device_queue_wait_idle(vulkan_device *device, VkQueue queue)
+{
+    platform_mutex_lock(&device->queue_mutex);
+    VkResult result = vkQueueWaitIdle(queue);
+    platform_mutex_unlock(&device->queue_mutex);
+    return result;
+}
+
+VkResult vulkan_device_queue_present(vulkan_device *device, VkQueue queue, const VkPresentInfoKHR *present_info)
+{
+    platform_mutex_lock(&device->queue_mutex);
+    VkResult result = vkQueuePresentKHR(queue, present_info);
+    platform_mutex_unlock(&device->queue_mutex);
+    return result;
+}
+
+VkResult vulkan_device_wait_idle(vulkan_device *device)
+{
+    platform_mutex_lock(&device->queue_mutex);
+    VkResult result = vkDeviceWaitIdle(device->logical_device);
+    platform_mutex_unlock(&device->queue_mutex);
+    return result;
+}
+
 void vulkan_device_query_swapchain_support(VkPhysicalDevice physical_device, VkSurfaceKHR surface,
                                            vulkan_swapchain_support_info *out_support_info)
 {
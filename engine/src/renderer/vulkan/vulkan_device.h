@@ -9,4 +9,11 @@ void vulkan_device_destroy(vulkan_context *context);
 void vulkan_device_query_swapchain_support(VkPhysicalDevice physical_device, VkSurfaceKHR surface,
                                            vulkan_swapchain_support_info *out_support_info);
 
-b8 vulkan_device_detect_depth_format(vulkan_device *device);
\ No newline at end of file
+b8 vulkan_device_detect_depth_format(vulkan_device *device);
+
+// Queues and device waits go through these, which hold the device's queue mutex.
+VkResult vulkan_device_queue_submit(vulkan_device *device, VkQueue queue, u32 submit_count, const VkSubmitInfo *submits,
+                                    VkFence fence);
+VkResult vulkan_device_queue_wait_idle(vulkan_device *device, VkQueue queue);
+VkResult vulkan_device_queue_present(vulkan_device *device, VkQueue queue, const VkPresentInfoKHR *present_info);
+VkResult vulkan_device_wait_idle(vulkan_device *device);
\ No newline at end of file
@@ -5,14 +5,16 @@
 #include "core/dmemory.h"
 #include "core/logger.h"
 
-void vulkan_image_create(vulkan_context *context, VkImageType image_type, u32 width, u32 height, VkFormat format,
-                         VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags memory_flags,
-                         b32 create_view, VkImageAspectFlags view_aspect_flags, vulkan_image *out_image)
+void vulkan_image_create(vulkan_context *context, VkImageType image_type, u32 width, u32 height, u32 mip_levels,
+                         VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
+                         VkMemoryPropertyFlags memory_flags, b32 create_view, VkImageAspectFlags view_aspect_flags,
+                         vulkan_image *out_image)
 {
 
     // Copy params
-    out_image->width  = width;
-    out_image->height = height;
+    out_image->width      = width;
+    out_image->height     = height;
+    out_image->mip_levels = mip_levels;
 
     // Creation info.
     VkImageCreateInfo image_create_info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
@@ -20,7 +22,7 @@ void vulkan_image_create(vulkan_context *context, VkImageType image_type, u32 wi
     image_create_info.extent.width      = width;
     image_create_info.extent.height     = height;
     image_create_info.extent.depth      = 1; // TODO: Support configurable depth.
-    image_create_info.mipLevels         = 4; // TODO: Support mip mapping
+    image_create_info.mipLevels         = mip_levels;
     image_create_info.arrayLayers       = 1; // TODO: Support number of layers in the image.
     image_create_info.format            = format;
     image_create_info.tiling            = tiling;
@@ -71,7 +73,7 @@ void vulkan_image_view_create(vulkan_context *context, VkFormat format, vulkan_i
 
     // TODO: Make configurable
     view_create_info.subresourceRange.baseMipLevel   = 0;
-    view_create_info.subresourceRange.levelCount     = 1;
+    view_create_info.subresourceRange.levelCount     = image->mip_levels;
     view_create_info.subresourceRange.baseArrayLayer = 0;
     view_create_info.subresourceRange.layerCount     = 1;
 
@@ -89,7 +91,7 @@ void vulkan_image_transition_layout(vulkan_context *context, vulkan_command_buff
     barrier.image                           = image->handle;
     barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel   = 0;
-    barrier.subresourceRange.levelCount     = 1;
+    barrier.subresourceRange.levelCount     = image->mip_levels;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount     = 1;
 
@@ -133,24 +135,31 @@ void vulkan_image_transition_layout(vulkan_context *context, vulkan_command_buff
 void vulkan_image_copy_from_buffer(vulkan_context *context, vulkan_image *image, VkBuffer buffer,
                                    vulkan_command_buffer *command_buffer)
 {
-    // Region to copy
-    VkBufferImageCopy region;
-    dzero_memory(&region, sizeof(VkBufferImageCopy));
-    region.bufferOffset      = 0;
-    region.bufferRowLength   = 0;
-    region.bufferImageHeight = 0;
-
-    region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel       = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount     = 1;
-
-    region.imageExtent.width  = image->width;
-    region.imageExtent.height = image->height;
-    region.imageExtent.depth  = 1;
-
-    vkCmdCopyBufferToImage(command_buffer->handle, buffer, image->handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                           &region);
+    // One region to copy per mip level.
+    VkBufferImageCopy regions[TEXTURE_MAX_MIP_COUNT];
+    dzero_memory(regions, sizeof(VkBufferImageCopy) * image->mip_levels);
+    VkDeviceSize offset = 0;
+    for (u32 i = 0; i < image->mip_levels; ++i)
+    {
+        VkBufferImageCopy *region = &regions[i];
+        region->bufferOffset      = offset;
+        region->bufferRowLength   = 0;
+        region->bufferImageHeight = 0;
+
+        region->imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region->imageSubresource.mipLevel       = i;
+        region->imageSubresource.baseArrayLayer = 0;
+        region->imageSubresource.layerCount     = 1;
+
+        region->imageExtent.width  = image->width >> i ? image->width >> i : 1;
+        region->imageExtent.height = image->height >> i ? image->height >> i : 1;
+        region->imageExtent.depth  = 1;
+
+        offset += (VkDeviceSize)region->imageExtent.width * region->imageExtent.height * 4;
+    }
+
+    vkCmdCopyBufferToImage(command_buffer->handle, buffer, image->handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           image->mip_levels, regions);
 }
 
 void vulkan_image_destroy(vulkan_context *context, vulkan_image *image)
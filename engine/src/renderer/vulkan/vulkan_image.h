@@ -2,9 +2,10 @@
 
 #include "vulkan_types.h"
 
-void vulkan_image_create(vulkan_context *context, VkImageType image_type, u32 width, u32 height, VkFormat format,
-                         VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags memory_flags,
-                         b32 create_view, VkImageAspectFlags view_aspect_flags, vulkan_image *out_image);
+void vulkan_image_create(vulkan_context *context, VkImageType image_type, u32 width, u32 height, u32 mip_levels,
+                         VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
+                         VkMemoryPropertyFlags memory_flags, b32 create_view, VkImageAspectFlags view_aspect_flags,
+                         vulkan_image *out_image);
 
 void vulkan_image_view_create(vulkan_context *context, VkFormat format, vulkan_image *image,
                               VkImageAspectFlags aspect_flags);
@@ -16,7 +17,8 @@ void vulkan_image_transition_layout(vulkan_context *context, vulkan_command_buff
                                     VkFormat format, VkImageLayout old_layout, VkImageLayout new_layout);
 
 /**
- * Copies data in buffer to provided image.
+ * Copies data in buffer to provided image. The buffer holds every mip level of the image, largest first,
+ * back to back, at 4 bytes per texel.
  * @param context The Vulkan context.
  * @param image The image to copy the buffer's data to.
  * @param buffer The buffer whose data will be copied.
@@ -59,7 +59,7 @@ void vulkan_swapchain_present(vulkan_context *context, vulkan_swapchain *swapcha
     present_info.pImageIndices      = &present_image_index;
     present_info.pResults           = 0;
 
-    VkResult result = vkQueuePresentKHR(present_queue, &present_info);
+    VkResult result = vulkan_device_queue_present(&context->device, present_queue, &present_info);
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
     {
         // Swapchain is out of date, suboptimal or a framebuffer resize has occurred. Trigger swapchain recreation.
@@ -210,7 +210,7 @@ void create(vulkan_context *context, u32 width, u32 height, vulkan_swapchain *sw
     }
 
     // Create depth image and its view.
-    vulkan_image_create(context, VK_IMAGE_TYPE_2D, swapchain_extent.width, swapchain_extent.height,
+    vulkan_image_create(context, VK_IMAGE_TYPE_2D, swapchain_extent.width, swapchain_extent.height, 1,
                         context->device.depth_format, VK_IMAGE_TILING_OPTIMAL,
                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true,
                         VK_IMAGE_ASPECT_DEPTH_BIT, &swapchain->depth_attachment);
@@ -220,7 +220,7 @@ void create(vulkan_context *context, u32 width, u32 height, vulkan_swapchain *sw
 
 void destroy(vulkan_context *context, vulkan_swapchain *swapchain)
 {
-    vkDeviceWaitIdle(context->device.logical_device);
+    vulkan_device_wait_idle(&context->device);
     vulkan_image_destroy(context, &swapchain->depth_attachment);
 
     // Only destroy the views, not the images, since those are owned by the swapchain and are thus
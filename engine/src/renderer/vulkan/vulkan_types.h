@@ -2,6 +2,7 @@
 
 #include "core/asserts.h"
 #include "defines.h"
+#include "platform/platform.h"
 #include "renderer/renderer_types.h"
 
 #include <vulkan/vulkan.h>
@@ -48,6 +49,10 @@ typedef struct vulkan_device
 
     VkCommandPool graphics_command_pool;
 
+    // Held while using a queue or waiting for the device to go idle, which must not happen on two threads at once.
+    // The render thread presents while resources are created on the main thread. See vulkan_device_queue_submit.
+    platform_mutex queue_mutex;
+
     VkPhysicalDeviceProperties properties;
     VkPhysicalDeviceFeatures features;
     VkPhysicalDeviceMemoryProperties memory;
@@ -62,6 +67,7 @@ typedef struct vulkan_image
     VkImageView view;
     u32 width;
     u32 height;
+    u32 mip_levels;
 } vulkan_image;
 
 typedef enum vulkan_render_pass_state
@@ -222,6 +228,14 @@ typedef struct vulkan_material_shader
 
 } vulkan_material_shader;
 
+// The resources of a destroyed texture, kept until no frame that may use them is still in flight.
+typedef struct vulkan_texture_release
+{
+    struct vulkan_texture_data *data;
+    // A bit per in-flight frame index, set while the frame submitted before the texture was destroyed has not finished.
+    u32 pending_frames;
+} vulkan_texture_release;
+
 typedef struct vulkan_context
 {
     f32 frame_delta_time;
@@ -274,6 +288,9 @@ typedef struct vulkan_context
     u32 image_index;
     u32 current_frame;
 
+    // darray. Textures destroyed while frames using them may still be in flight.
+    vulkan_texture_release *texture_releases;
+
     b8 recreating_swapchain;
 
     vulkan_material_shader material_shader;
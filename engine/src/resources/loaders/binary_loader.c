@@ -16,42 +16,22 @@ b8 binary_loader_load(struct resource_loader *self, const char *name, resource *
         return false;
     }
 
-    char *format_str = "%s/%s/%s%s";
     char full_file_path[512];
-    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, "");
+    resource_system_find_file(self, name, full_file_path);
 
-    // TODO: Should be using an allocator here.
-    out_resource->full_path = string_duplicate(full_file_path);
+    resource_system_create_arena(out_resource, full_file_path, 0);
 
-    file_handle f;
-    if (!filesystem_open(full_file_path, FILE_MODE_READ, true, &f))
+    // Rather than reading into a copy, hand out a view of the mapped file or pack.
+    file_mapping mapping;
+    if (!resource_system_map_file(full_file_path, &mapping))
     {
-        DERROR("binary_loader_load - unable to open file for binary reading: '%s'.", full_file_path);
+        DERROR("binary_loader_load - unable to map file for binary reading: '%s'.", full_file_path);
         return false;
     }
 
-    u64 file_size = 0;
-    if (!filesystem_size(&f, &file_size))
-    {
-        DERROR("Unable to binary read file: %s.", full_file_path);
-        filesystem_close(&f);
-        return false;
-    }
-
-    // TODO: Should be using an allocator here.
-    u8 *resource_data = dallocate(sizeof(u8) * file_size, MEMORY_TAG_ARRAY);
-    u64 read_size     = 0;
-    if (!filesystem_read_all_bytes(&f, resource_data, &read_size))
-    {
-        DERROR("Unable to binary read file: %s.", full_file_path);
-        filesystem_close(&f);
-        return false;
-    }
-
-    filesystem_close(&f);
-
-    out_resource->data      = resource_data;
-    out_resource->data_size = read_size;
+    // Read-only, and not null-terminated.
+    out_resource->data      = (void *)mapping.data;
+    out_resource->data_size = mapping.size;
     out_resource->name      = name;
 
     return true;
@@ -65,15 +45,13 @@ void binary_loader_unload(struct resource_loader *self, resource *resource)
         return;
     }
 
-    u32 path_length = string_length(resource->full_path);
-    if (path_length)
-    {
-        dfree(resource->full_path, sizeof(char) * path_length + 1, MEMORY_TAG_STRING);
-    }
-
+    // The path goes with the resource's arena.
     if (resource->data)
     {
-        dfree(resource->data, resource->data_size, MEMORY_TAG_ARRAY);
+        file_mapping mapping;
+        mapping.data = resource->data;
+        mapping.size = resource->data_size;
+        resource_system_unmap_file(&mapping);
         resource->data      = 0;
         resource->data_size = 0;
         resource->loader_id = INVALID_ID;
@@ -83,11 +61,15 @@ void binary_loader_unload(struct resource_loader *self, resource *resource)
 resource_loader binary_resource_loader_create()
 {
     resource_loader loader;
-    loader.type        = RESOURCE_TYPE_BINARY;
-    loader.custom_type = 0;
-    loader.load        = binary_loader_load;
-    loader.unload      = binary_loader_unload;
-    loader.type_path   = "";
+    loader.type             = RESOURCE_TYPE_BINARY;
+    loader.custom_type      = 0;
+    loader.load             = binary_loader_load;
+    loader.load_from_memory = 0;
+    loader.unload           = binary_loader_unload;
+    loader.memory_size      = 0;
+    loader.type_path        = "";
+    loader.extensions[0]    = "";
+    loader.extension_count  = 1;
 
     return loader;
 }
\ No newline at end of file
@@ -3,27 +3,117 @@
 #include "core/dmemory.h"
 #include "core/dstring.h"
 #include "core/logger.h"
+#include "platform/filesystem.h"
 #include "resources/resource_types.h"
+#include "resources/texture_file.h"
 #include "systems/resource_system.h"
 
 // TODO: resource loader.
 #define STB_IMAGE_IMPLEMENTATION
 #include "vendor/stb_image.h"
 
-b8 image_loader_load(struct resource_loader *self, const char *name, resource *out_resource)
+// Where an image's pixels live, so they can be released the same way.
+typedef enum image_pixel_storage
 {
-    if (!self || !name || !out_resource)
+    // Decoded by stb_image.
+    IMAGE_PIXELS_DECODED,
+    // Copied out of a cooked texture that was read into memory, into the resource's arena.
+    IMAGE_PIXELS_COPIED,
+    // Pointing into a mapped cooked texture.
+    IMAGE_PIXELS_MAPPED
+} image_pixel_storage;
+
+// What the loader allocates for each image. The resource's users only see the image.
+typedef struct image_loader_data
+{
+    image_resource_data image;
+    image_pixel_storage storage;
+    file_mapping mapping;
+} image_loader_data;
+
+// Gets the size in bytes of all of an image's mip levels.
+static u64 image_pixels_size(const image_resource_data *image)
+{
+    u64 size = 0;
+    for (u32 i = 0; i < image->mip_count; ++i)
     {
+        u32 width  = image->width >> i ? image->width >> i : 1;
+        u32 height = image->height >> i ? image->height >> i : 1;
+        size += (u64)width * height * image->channel_count;
+    }
+    return size;
+}
+
+// Creates the resource's arena, with room for pixels_size bytes of pixels after the image.
+static image_loader_data *create_image_data(const char *name, const char *full_file_path, u64 pixels_size,
+                                            resource *out_resource)
+{
+    resource_system_create_arena(out_resource, full_file_path, sizeof(image_loader_data) + pixels_size);
+    image_loader_data *data = linear_allocator_allocate(&out_resource->arena, sizeof(image_loader_data));
+    out_resource->data      = data;
+    out_resource->data_size = sizeof(image_loader_data);
+    out_resource->name      = name;
+    return data;
+}
+
+// Loads a cooked texture. If mapping is given, the pixels are used in place and the image takes over the
+// mapping; otherwise they are copied out of file_data.
+static b8 load_cooked_image(const char *name, const char *full_file_path, const void *file_data, u64 file_size,
+                            file_mapping *mapping, resource *out_resource)
+{
+    const texture_file_header *header;
+    if (!texture_file_parse(file_data, file_size, &header))
+    {
+        DERROR("Image resource loader failed to load file '%s'.", full_file_path);
         return false;
     }
 
-    char *format_str                 = "%s/%s/%s%s";
-    const s32 required_channel_count = 4;
-    stbi_set_flip_vertically_on_load(true);
-    char full_file_path[512];
+    // Mapped pixels are used in place; otherwise they are copied into the arena.
+    u64 pixels_size = 0;
+    for (u32 i = 0; !mapping && i < header->mip_count; ++i)
+    {
+        pixels_size += header->mip_sizes[i];
+    }
 
-    // TODO: try different extensions
-    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, ".png");
+    image_loader_data *data      = create_image_data(name, full_file_path, pixels_size, out_resource);
+    data->image.width            = header->width;
+    data->image.height           = header->height;
+    data->image.channel_count    = header->channel_count;
+    data->image.has_transparency = (header->flags & TEXTURE_FILE_FLAG_HAS_TRANSPARENCY) != 0;
+    data->image.mip_count        = header->mip_count;
+    if (mapping)
+    {
+        for (u32 i = 0; i < header->mip_count; ++i)
+        {
+            data->image.mip_pixels[i] = texture_file_mip(header, i);
+        }
+        data->image.pixels = (u8 *)data->image.mip_pixels[0];
+        data->storage      = IMAGE_PIXELS_MAPPED;
+        data->mapping      = *mapping;
+    }
+    else
+    {
+        // Every level goes back to back.
+        data->image.pixels = linear_allocator_allocate(&out_resource->arena, pixels_size);
+        data->storage      = IMAGE_PIXELS_COPIED;
+        u8 *level          = data->image.pixels;
+        for (u32 i = 0; i < header->mip_count; ++i)
+        {
+            dcopy_memory(level, texture_file_mip(header, i), header->mip_sizes[i]);
+            data->image.mip_pixels[i] = level;
+            level += header->mip_sizes[i];
+        }
+    }
+    return true;
+}
+
+// Decodes an image from the contents of its file, whether mapped or already read into memory.
+static b8 decode_image(const char *name, const char *full_file_path, const void *file_data, u64 file_size,
+                       resource *out_resource)
+{
+    const s32 required_channel_count = 4;
+    // Per-thread, since images may be decoded on worker threads.
+    stbi_set_flip_vertically_on_load_thread(true);
 
     s32 width;
     s32 height;
@@ -31,7 +121,8 @@ b8 image_loader_load(struct resource_loader *self, const char *name, resource *o
 
     // For now, assume 8 bits per channel, 4 channels.
     // TODO: extend this to make it configurable.
-    u8 *data = stbi_load(full_file_path, &width, &height, &channel_count, required_channel_count);
+    u8 *data = stbi_load_from_memory(file_data, (s32)file_size, &width, &height, &channel_count,
+                                     required_channel_count);
 
     // Check for a failure reason. If there is one, abort, clear memory if allocated, return false.
     const char *fail_reason = stbi_failure_reason();
@@ -54,23 +145,82 @@ b8 image_loader_load(struct resource_loader *self, const char *name, resource *o
         return false;
     }
 
-    // TODO: Should be using an allocator here.
-    out_resource->full_path = string_duplicate(full_file_path);
-
-    // TODO: Should be using an allocator here.
-    image_resource_data *resource_data = dallocate(sizeof(image_resource_data), MEMORY_TAG_TEXTURE);
-    resource_data->pixels              = data;
-    resource_data->width               = width;
-    resource_data->height              = height;
-    resource_data->channel_count       = required_channel_count;
+    // Check for transparency here rather than at upload time, so the scan runs on
+    // whichever thread decoded the image.
+    b8 has_transparency = false;
+    u64 total_size      = (u64)width * height * required_channel_count;
+    for (u64 i = 0; i < total_size; i += required_channel_count)
+    {
+        if (data[i + 3] < 255)
+        {
+            has_transparency = true;
+            break;
+        }
+    }
 
-    out_resource->data      = resource_data;
-    out_resource->data_size = sizeof(image_resource_data);
-    out_resource->name      = name;
+    image_loader_data *resource_data      = create_image_data(name, full_file_path, 0, out_resource);
+    resource_data->image.pixels           = data;
+    resource_data->image.width            = width;
+    resource_data->image.height           = height;
+    resource_data->image.channel_count    = required_channel_count;
+    resource_data->image.has_transparency = has_transparency;
+    resource_data->image.mip_count        = 1;
+    resource_data->image.mip_pixels[0]    = data;
+    resource_data->storage                = IMAGE_PIXELS_DECODED;
 
     return true;
 }
 
+b8 image_loader_load(struct resource_loader *self, const char *name, resource *out_resource)
+{
+    if (!self || !name || !out_resource)
+    {
+        return false;
+    }
+
+    // Use whichever of the supported formats exists. If none does, opening the first one fails below.
+    char full_file_path[512];
+    resource_system_find_file(self, name, full_file_path);
+
+    // Decode straight out of the mapped file rather than through stdio.
+    file_mapping mapping;
+    if (!resource_system_map_file(full_file_path, &mapping))
+    {
+        DERROR("Image resource loader failed to open file '%s'.", full_file_path);
+        return false;
+    }
+
+    // Cooked pixels are used straight out of the mapping, which the image then holds until unloaded.
+    if (texture_file_is_cooked(mapping.data, mapping.size))
+    {
+        b8 result = load_cooked_image(name, full_file_path, mapping.data, mapping.size, &mapping, out_resource);
+        if (!result)
+        {
+            resource_system_unmap_file(&mapping);
+        }
+        return result;
+    }
+
+    b8 result = decode_image(name, full_file_path, mapping.data, mapping.size, out_resource);
+    resource_system_unmap_file(&mapping);
+    return result;
+}
+
+b8 image_loader_load_from_memory(struct resource_loader *self, const char *name, const char *full_file_path,
+                                 const void *data, u64 data_size, resource *out_resource)
+{
+    if (!self || !name || !full_file_path || !data || !out_resource)
+    {
+        return false;
+    }
+
+    if (texture_file_is_cooked(data, data_size))
+    {
+        return load_cooked_image(name, full_file_path, data, data_size, 0, out_resource);
+    }
+    return decode_image(name, full_file_path, data, data_size, out_resource);
+}
+
 void image_loader_unload(struct resource_loader *self, resource *resource)
 {
     if (!self || !resource)
@@ -79,29 +229,49 @@ void image_loader_unload(struct resource_loader *self, resource *resource)
         return;
     }
 
-    u32 path_length = string_length(resource->full_path);
-    if (path_length)
-    {
-        dfree(resource->full_path, sizeof(char) * path_length + 1, MEMORY_TAG_STRING);
-    }
-
+    // The image itself, its path and any copied pixels go with the resource's arena.
     if (resource->data)
     {
-        dfree(resource->data, resource->data_size, MEMORY_TAG_TEXTURE);
+        image_loader_data *data = resource->data;
+        switch (data->storage)
+        {
+        case IMAGE_PIXELS_DECODED:
+            stbi_image_free(data->image.pixels);
+            break;
+        case IMAGE_PIXELS_COPIED:
+            break;
+        case IMAGE_PIXELS_MAPPED:
+            resource_system_unmap_file(&data->mapping);
+            break;
+        }
         resource->data      = 0;
         resource->data_size = 0;
         resource->loader_id = INVALID_ID;
     }
 }
 
+u64 image_loader_memory_size(struct resource_loader *self, const resource *resource)
+{
+    const image_resource_data *resource_data = resource->data;
+    return resource->data_size + image_pixels_size(resource_data);
+}
+
 resource_loader image_resource_loader_create()
 {
     resource_loader loader;
-    loader.type        = RESOURCE_TYPE_IMAGE;
-    loader.custom_type = 0;
-    loader.load        = image_loader_load;
-    loader.unload      = image_loader_unload;
-    loader.type_path   = "textures";
+    loader.type             = RESOURCE_TYPE_IMAGE;
+    loader.custom_type      = 0;
+    loader.load             = image_loader_load;
+    loader.load_from_memory = image_loader_load_from_memory;
+    loader.unload           = image_loader_unload;
+    loader.memory_size      = image_loader_memory_size;
+    loader.type_path        = "textures";
+    // Cooked textures first, since they load without decoding.
+    loader.extensions[0]    = ".dtex";
+    loader.extensions[1]    = ".png";
+    loader.extensions[2]    = ".jpg";
+    loader.extensions[3]    = ".tga";
+    loader.extension_count  = 4;
 
     return loader;
 }
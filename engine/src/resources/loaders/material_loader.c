@@ -3,12 +3,39 @@
 #include "core/dmemory.h"
 #include "core/dstring.h"
 #include "core/logger.h"
-#include "math/dmath.h"
+#include "resources/material_file.h"
 #include "resources/resource_types.h"
 #include "systems/resource_system.h"
 
 #include "platform/filesystem.h"
 
+// Reads the contents of a material file, whether mapped or already read into memory, and cooked or not.
+static b8 read_material(const char *name, const char *full_file_path, const void *data, u64 size,
+                        resource *out_resource)
+{
+    // The config and path share the resource's arena, which the resource system frees if this fails.
+    resource_system_create_arena(out_resource, full_file_path, sizeof(material_config));
+    material_config *resource_data = linear_allocator_allocate(&out_resource->arena, sizeof(material_config));
+    if (material_file_is_cooked(data, size))
+    {
+        if (!material_file_read(data, size, resource_data))
+        {
+            DERROR("material_loader - Unable to read cooked material '%s'.", full_file_path);
+            return false;
+        }
+    }
+    else
+    {
+        material_file_parse_text(name, full_file_path, data, size, resource_data);
+    }
+
+    out_resource->data      = resource_data;
+    out_resource->data_size = sizeof(material_config);
+    out_resource->name      = name;
+
+    return true;
+}
+
 b8 material_loader_load(struct resource_loader *self, const char *name, resource *out_resource)
 {
     if (!self || !name || !out_resource)
@@ -16,107 +43,31 @@ b8 material_loader_load(struct resource_loader *self, const char *name, resource
         return false;
     }
 
-    char *format_str = "%s/%s/%s%s";
     char full_file_path[512];
-    string_format(full_file_path, format_str, resource_system_base_path(), self->type_path, name, ".kmt");
+    resource_system_find_file(self, name, full_file_path);
 
-    // TODO: Should be using an allocator here.
-    out_resource->full_path = string_duplicate(full_file_path);
-
-    file_handle f;
-    if (!filesystem_open(full_file_path, FILE_MODE_READ, false, &f))
+    // Read the whole file in place, rather than reading and copying it a line at a time.
+    file_mapping mapping;
+    if (!resource_system_map_file(full_file_path, &mapping))
     {
         DERROR("material_loader_load - unable to open material file for reading: '%s'.", full_file_path);
         return false;
     }
 
-    // TODO: Should be using an allocator here.
-    material_config *resource_data = dallocate(sizeof(material_config), MEMORY_TAG_MATERIAL_INSTANCE);
-    // Set some defaults.
-    resource_data->auto_release        = true;
-    resource_data->diffuse_colour      = vec4_one(); // white.
-    resource_data->diffuse_map_name[0] = 0;
-    string_ncopy(resource_data->name, name, MATERIAL_NAME_MAX_LENGTH);
-
-    // Read each line of the file.
-    char line_buf[512] = "";
-    char *p            = &line_buf[0];
-    u64 line_length    = 0;
-    u32 line_number    = 1;
-    while (filesystem_read_line(&f, 511, &p, &line_length))
-    {
-        // Trim the string.
-        char *trimmed = string_trim(line_buf);
-
-        // Get the trimmed length.
-        line_length = string_length(trimmed);
-
-        // Skip blank lines and comments.
-        if (line_length < 1 || trimmed[0] == '#')
-        {
-            line_number++;
-            continue;
-        }
-
-        // Split into var/value
-        s32 equal_index = string_index_of(trimmed, '=');
-        if (equal_index == -1)
-        {
-            DWARN("Potential formatting issue found in file '%s': '=' token not found. Skipping line %ui.",
-                  full_file_path, line_number);
-            line_number++;
-            continue;
-        }
-
-        // Assume a max of 64 characters for the variable name.
-        char raw_var_name[64];
-        dzero_memory(raw_var_name, sizeof(char) * 64);
-        string_mid(raw_var_name, trimmed, 0, equal_index);
-        char *trimmed_var_name = string_trim(raw_var_name);
-
-        // Assume a max of 511-65 (446) for the max length of the value to account for the variable name and the '='.
-        char raw_value[446];
-        dzero_memory(raw_value, sizeof(char) * 446);
-        string_mid(raw_value, trimmed, equal_index + 1, -1); // Read the rest of the line
-        char *trimmed_value = string_trim(raw_value);
-
-        // Process the variable.
-        if (strings_equali(trimmed_var_name, "version"))
-        {
-            // TODO: version
-        }
-        else if (strings_equali(trimmed_var_name, "name"))
-        {
-            string_ncopy(resource_data->name, trimmed_value, MATERIAL_NAME_MAX_LENGTH);
-        }
-        else if (strings_equali(trimmed_var_name, "diffuse_map_name"))
-        {
-            string_ncopy(resource_data->diffuse_map_name, trimmed_value, TEXTURE_NAME_MAX_LENGTH);
-        }
-        else if (strings_equali(trimmed_var_name, "diffuse_colour"))
-        {
-            // Parse the colour
-            if (!string_to_vec4(trimmed_value, &resource_data->diffuse_colour))
-            {
-                DWARN("Error parsing diffuse_colour in file '%s'. Using default of white instead.", full_file_path);
-                // NOTE: already assigned above, no need to have it here.
-            }
-        }
-
-        // TODO: more fields.
+    b8 result = read_material(name, full_file_path, mapping.data, mapping.size, out_resource);
+    resource_system_unmap_file(&mapping);
+    return result;
+}
 
-        // Clear the line buffer.
-        dzero_memory(line_buf, sizeof(char) * 512);
-        line_number++;
+b8 material_loader_load_from_memory(struct resource_loader *self, const char *name, const char *full_file_path,
+                                    const void *data, u64 data_size, resource *out_resource)
+{
+    if (!self || !name || !full_file_path || !data || !out_resource)
+    {
+        return false;
     }
 
-    filesystem_close(&f);
-
-    out_resource->data      = resource_data;
-    out_resource->data_size = sizeof(material_config);
-    out_resource->name      = name;
-
-    return true;
+    return read_material(name, full_file_path, data, data_size, out_resource);
 }
 
 void material_loader_unload(struct resource_loader *self, resource *resource)
@@ -127,29 +78,34 @@ void material_loader_unload(struct resource_loader *self, resource *resource)
         return;
     }
 
-    u32 path_length = string_length(resource->full_path);
-    if (path_length)
-    {
-        dfree(resource->full_path, sizeof(char) * path_length + 1, MEMORY_TAG_STRING);
-    }
-
+    // The config and path go with the resource's arena.
     if (resource->data)
     {
-        dfree(resource->data, resource->data_size, MEMORY_TAG_MATERIAL_INSTANCE);
         resource->data      = 0;
         resource->data_size = 0;
         resource->loader_id = INVALID_ID;
     }
 }
 
+u64 material_loader_memory_size(struct resource_loader *self, const resource *resource)
+{
+    return resource->data_size;
+}
+
 resource_loader material_resource_loader_create()
 {
     resource_loader loader;
-    loader.type        = RESOURCE_TYPE_MATERIAL;
-    loader.custom_type = 0;
-    loader.load        = material_loader_load;
-    loader.unload      = material_loader_unload;
-    loader.type_path   = "materials";
+    loader.type             = RESOURCE_TYPE_MATERIAL;
+    loader.custom_type      = 0;
+    loader.load             = material_loader_load;
+    loader.load_from_memory = material_loader_load_from_memory;
+    loader.unload           = material_loader_unload;
+    loader.memory_size      = material_loader_memory_size;
+    loader.type_path        = "materials";
+    // Cooked materials are preferred; the source is still loaded if none has been cooked.
+    loader.extensions[0]    = ".dmt";
+    loader.extensions[1]    = ".kmt";
+    loader.extension_count  = 2;
 
     return loader;
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "mesh_loader.h"
+
+#include "core/dmemory.h"
+#include "core/logger.h"
+#include "resources/mesh_file.h"
+#include "resources/resource_types.h"
+#include "systems/resource_system.h"
+
+#include "platform/filesystem.h"
+
+// What the loader allocates for each mesh. The resource's users only see the mesh.
+typedef struct mesh_loader_data
+{
+    mesh_resource_data mesh;
+    // The file the submeshes point into, if it was mapped. Otherwise they point into the arena.
+    file_mapping mapping;
+} mesh_loader_data;
+
+// Reads a cooked mesh. If mapping is given, the submeshes point into it and the mesh takes it over;
+// otherwise file_data is copied into the resource's arena first, since it does not outlive the load.
+static b8 read_mesh(const char *name, const char *full_file_path, const void *file_data, u64 file_size,
+                    file_mapping *mapping, resource *out_resource)
+{
+    u32 submesh_count = 0;
+    if (!mesh_file_parse(file_data, file_size, 0, 0, &submesh_count))
+    {
+        DERROR("mesh_loader - Unable to read cooked mesh '%s'.", full_file_path);
+        return false;
+    }
+
+    // The submesh table, and the file if it is copied, share the resource's arena.
+    u64 table_size = sizeof(submesh_resource_data) * submesh_count;
+    resource_system_create_arena(out_resource, full_file_path,
+                                 sizeof(mesh_loader_data) + table_size + (mapping ? 0 : file_size));
+    mesh_loader_data *data   = linear_allocator_allocate(&out_resource->arena, sizeof(mesh_loader_data));
+    data->mesh.submesh_count = submesh_count;
+    data->mesh.submeshes     = linear_allocator_allocate(&out_resource->arena, table_size);
+    if (mapping)
+    {
+        data->mapping = *mapping;
+    }
+    else
+    {
+        void *copy = linear_allocator_allocate(&out_resource->arena, file_size);
+        dcopy_memory(copy, file_data, file_size);
+        file_data = copy;
+    }
+    mesh_file_parse(file_data, file_size, submesh_count, data->mesh.submeshes, &submesh_count);
+
+    out_resource->data      = data;
+    out_resource->data_size = sizeof(mesh_loader_data);
+    out_resource->name      = name;
+    return true;
+}
+
+b8 mesh_loader_load(struct resource_loader *self, const char *name, resource *out_resource)
+{
+    if (!self || !name || !out_resource)
+    {
+        return false;
+    }
+
+    char full_file_path[512];
+    resource_system_find_file(self, name, full_file_path);
+
+    // Vertices and indices are handed out straight from the mapping, so nothing is copied until upload.
+    file_mapping mapping;
+    if (!resource_system_map_file(full_file_path, &mapping))
+    {
+        DERROR("mesh_loader_load - unable to open mesh file for reading: '%s'.", full_file_path);
+        return false;
+    }
+
+    b8 result = read_mesh(name, full_file_path, mapping.data, mapping.size, &mapping, out_resource);
+    if (!result)
+    {
+        resource_system_unmap_file(&mapping);
+    }
+    return result;
+}
+
+b8 mesh_loader_load_from_memory(struct resource_loader *self, const char *name, const char *full_file_path,
+                                const void *data, u64 data_size, resource *out_resource)
+{
+    if (!self || !name || !full_file_path || !data || !out_resource)
+    {
+        return false;
+    }
+
+    return read_mesh(name, full_file_path, data, data_size, 0, out_resource);
+}
+
+void mesh_loader_unload(struct resource_loader *self, resource *resource)
+{
+    if (!self || !resource)
+    {
+        DWARN("mesh_loader_unload called with nullptr for self or resource.");
+        return;
+    }
+
+    // The mesh, its path and any copy of the file go with the resource's arena.
+    if (resource->data)
+    {
+        mesh_loader_data *data = resource->data;
+        if (data->mapping.data)
+        {
+            resource_system_unmap_file(&data->mapping);
+        }
+        resource->data      = 0;
+        resource->data_size = 0;
+        resource->loader_id = INVALID_ID;
+    }
+}
+
+u64 mesh_loader_memory_size(struct resource_loader *self, const resource *resource)
+{
+    const mesh_loader_data *data = resource->data;
+    return resource->arena.total_size + data->mapping.size;
+}
+
+resource_loader mesh_resource_loader_create()
+{
+    resource_loader loader;
+    loader.type             = RESOURCE_TYPE_MESH;
+    loader.custom_type      = 0;
+    loader.load             = mesh_loader_load;
+    loader.load_from_memory = mesh_loader_load_from_memory;
+    loader.unload           = mesh_loader_unload;
+    loader.memory_size      = mesh_loader_memory_size;
+    loader.type_path        = "models";
+    loader.extensions[0]    = ".dmsh";
+    loader.extension_count  = 1;
+
+    return loader;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "systems/resource_system.h"
+
+resource_loader mesh_resource_loader_create();
@@ -0,0 +1,226 @@
+#include "material_file.h"
+
+#include "core/dstring.h"
+#include "core/logger.h"
+#include "math/dmath.h"
+#include "platform/filesystem.h"
+
+b8 material_file_is_cooked(const void *data, u64 size)
+{
+    return data && size >= sizeof(material_file_header) &&
+           ((const material_file_header *)data)->magic == MATERIAL_FILE_MAGIC;
+}
+
+// Gets a string from the string table, checking that it lies within the file.
+static b8 read_string(const material_file_header *header, u32 offset, string_view *out_string)
+{
+    if (offset == 0)
+    {
+        *out_string = string_view_create("", 0);
+        return true;
+    }
+    if (offset < sizeof(material_file_header) || offset >= header->file_size)
+    {
+        return false;
+    }
+
+    const char *start = (const char *)header + offset;
+    u64 max_length    = header->file_size - offset;
+    for (u64 length = 0; length < max_length; ++length)
+    {
+        if (start[length] == 0)
+        {
+            *out_string = string_view_create(start, length);
+            return true;
+        }
+    }
+    return false;
+}
+
+b8 material_file_read(const void *data, u64 size, material_config *out_config)
+{
+    if (!material_file_is_cooked(data, size) || !out_config)
+    {
+        DERROR("material_file_read - Not a cooked material.");
+        return false;
+    }
+
+    const material_file_header *header = data;
+    string_view name;
+    string_view diffuse_map_name;
+    if (header->version != MATERIAL_FILE_VERSION || header->file_size > size ||
+        !read_string(header, header->name_offset, &name) ||
+        !read_string(header, header->diffuse_map_name_offset, &diffuse_map_name))
+    {
+        DERROR("material_file_read - The cooked material is corrupt, or from another version of the engine.");
+        return false;
+    }
+
+    out_config->auto_release = (header->flags & MATERIAL_FILE_FLAG_AUTO_RELEASE) != 0;
+    for (u32 i = 0; i < 4; ++i)
+    {
+        out_config->diffuse_colour.elements[i] = header->diffuse_colour[i];
+    }
+    string_view_copy(out_config->name, name, MATERIAL_NAME_MAX_LENGTH - 1);
+    string_view_copy(out_config->diffuse_map_name, diffuse_map_name, TEXTURE_NAME_MAX_LENGTH - 1);
+    return true;
+}
+
+void material_file_parse_text(const char *name, const char *full_file_path, const char *text, u64 length,
+                              material_config *out_config)
+{
+    // Set some defaults.
+    out_config->auto_release        = true;
+    out_config->diffuse_colour      = vec4_one(); // white.
+    out_config->diffuse_map_name[0] = 0;
+    string_view_copy(out_config->name, string_view_create(name, string_length(name)), MATERIAL_NAME_MAX_LENGTH - 1);
+
+    // Read each line of the file.
+    string_view remaining = string_view_create(text, length);
+    string_view line;
+    u32 line_number = 0;
+    while (string_view_next_line(&remaining, &line))
+    {
+        line_number++;
+
+        // Trim the line, then skip blank lines and comments.
+        string_view trimmed = string_view_trim(line);
+        if (trimmed.length < 1 || trimmed.data[0] == '#')
+        {
+            continue;
+        }
+
+        // Split into var/value
+        s64 equal_index = string_view_index_of(trimmed, '=');
+        if (equal_index == -1)
+        {
+            DWARN("Potential formatting issue found in file '%s': '=' token not found. Skipping line %u.",
+                  full_file_path, line_number);
+            continue;
+        }
+        string_view var_name = string_view_trim(string_view_mid(trimmed, 0, equal_index));
+        string_view value    = string_view_trim(string_view_mid(trimmed, equal_index + 1, -1));
+
+        // Process the variable.
+        if (string_view_equali(var_name, "version"))
+        {
+            // TODO: version
+        }
+        else if (string_view_equali(var_name, "name"))
+        {
+            string_view_copy(out_config->name, value, MATERIAL_NAME_MAX_LENGTH - 1);
+        }
+        else if (string_view_equali(var_name, "diffuse_map_name"))
+        {
+            string_view_copy(out_config->diffuse_map_name, value, TEXTURE_NAME_MAX_LENGTH - 1);
+        }
+        else if (string_view_equali(var_name, "diffuse_colour"))
+        {
+            // Parse the colour
+            char colour_string[128];
+            string_view_copy(colour_string, value, sizeof(colour_string) - 1);
+            if (!string_to_vec4(colour_string, &out_config->diffuse_colour))
+            {
+                DWARN("Error parsing diffuse_colour in file '%s'. Using default of white instead.", full_file_path);
+                out_config->diffuse_colour = vec4_one();
+            }
+        }
+
+        // TODO: more fields.
+    }
+}
+
+b8 material_file_write(const char *out_path, const material_config *config)
+{
+    if (!out_path || !config)
+    {
+        return false;
+    }
+
+    material_file_header header = {0};
+    header.magic                = MATERIAL_FILE_MAGIC;
+    header.version              = MATERIAL_FILE_VERSION;
+    header.flags                = config->auto_release ? MATERIAL_FILE_FLAG_AUTO_RELEASE : 0;
+    for (u32 i = 0; i < 4; ++i)
+    {
+        header.diffuse_colour[i] = config->diffuse_colour.elements[i];
+    }
+
+    // Lay out the string table, storing a string only once if it is used twice.
+    u64 name_size      = string_length(config->name) + 1;
+    u64 diffuse_size   = string_length(config->diffuse_map_name) + 1;
+    b8 write_diffuse   = diffuse_size > 1 && !strings_equal(config->diffuse_map_name, config->name);
+    header.name_offset = sizeof(material_file_header);
+    header.file_size   = header.name_offset + (u32)name_size;
+    if (write_diffuse)
+    {
+        header.diffuse_map_name_offset = header.file_size;
+        header.file_size += (u32)diffuse_size;
+    }
+    else if (diffuse_size > 1)
+    {
+        header.diffuse_map_name_offset = header.name_offset;
+    }
+
+    // Replaced rather than rewritten, since the cooked material may be mapped by a load.
+    file_writer_config writer_config = {0};
+    writer_config.flush_policy       = FILE_FLUSH_ON_SIZE;
+    writer_config.replace_on_close   = true;
+    file_writer writer;
+    if (!filesystem_writer_open(out_path, true, writer_config, &writer))
+    {
+        DERROR("material_file_write - Unable to open '%s' for writing.", out_path);
+        return false;
+    }
+
+    b8 result = filesystem_writer_write(&writer, sizeof(header), &header) &&
+                filesystem_writer_write(&writer, name_size, config->name);
+    if (write_diffuse)
+    {
+        result = result && filesystem_writer_write(&writer, diffuse_size, config->diffuse_map_name);
+    }
+
+    result = filesystem_writer_flush(&writer) && result;
+    filesystem_writer_close(&writer);
+    if (!result)
+    {
+        DERROR("material_file_write - Failed to write '%s'.", out_path);
+    }
+    return result;
+}
+
+b8 material_file_cook(const char *source_path, const char *out_path)
+{
+    file_mapping mapping;
+    if (!filesystem_map(source_path, &mapping))
+    {
+        return false;
+    }
+
+    // Name the material after the file, as the material loader does when it is loaded by name.
+    const char *file_name = source_path;
+    for (const char *c = source_path; *c; ++c)
+    {
+        if (*c == '/' || *c == '\\')
+        {
+            file_name = c + 1;
+        }
+    }
+    char name[MATERIAL_NAME_MAX_LENGTH];
+    u64 name_length = string_length(file_name);
+    for (u64 i = name_length; i > 0; --i)
+    {
+        if (file_name[i - 1] == '.')
+        {
+            name_length = i - 1;
+            break;
+        }
+    }
+    string_view_copy(name, string_view_create(file_name, name_length), MATERIAL_NAME_MAX_LENGTH - 1);
+
+    material_config config;
+    material_file_parse_text(name, source_path, mapping.data, mapping.size, &config);
+    filesystem_unmap(&mapping);
+
+    return material_file_write(out_path, &config);
+}
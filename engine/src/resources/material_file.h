@@ -0,0 +1,91 @@
+#pragma once
+
+#include "defines.h"
+#include "resources/resource_types.h"
+
+/*
+A cooked material (.dmt) is a fixed-size header followed by a table of null-terminated
+strings, so loading one takes a single read and no text parsing.
+
+Layout:
+    material_file_header
+    string table: the material's name and the names of the textures it uses, each stored once
+
+Strings are referred to by their offset from the start of the file. An offset of 0, which
+is inside the header, means the string is empty.
+*/
+
+#define MATERIAL_FILE_MAGIC 0x54414D44 // "DMAT"
+#define MATERIAL_FILE_VERSION 1
+
+typedef enum material_file_flags
+{
+    MATERIAL_FILE_FLAG_AUTO_RELEASE = 0x1
+} material_file_flags;
+
+typedef struct material_file_header
+{
+    u32 magic;
+    u32 version;
+    // material_file_flags.
+    u32 flags;
+    // The size of the whole file, including the string table.
+    u32 file_size;
+    f32 diffuse_colour[4];
+    // Offsets of strings in the string table.
+    u32 name_offset;
+    u32 diffuse_map_name_offset;
+} material_file_header;
+
+/**
+ * @brief Checks if file contents are a cooked material, without validating them.
+ *
+ * @param data The contents of the file.
+ * @param size The size of data in bytes.
+ * @return True if data starts with a material file header; otherwise false.
+ */
+DAPI b8 material_file_is_cooked(const void *data, u64 size);
+
+/**
+ * @brief Reads a cooked material into a material config.
+ *
+ * @param data The contents of the file.
+ * @param size The size of data in bytes.
+ * @param out_config A pointer to hold the material's configuration.
+ * @return True if data is a valid cooked material; otherwise false.
+ */
+DAPI b8 material_file_read(const void *data, u64 size, material_config *out_config);
+
+/**
+ * @brief Parses the text of a source material (.kmt) into a material config. Unknown or malformed
+ * lines are skipped with a warning.
+ *
+ * @param name The name of the material, used unless the file sets one.
+ * @param full_file_path The path of the file, for messages.
+ * @param text The contents of the file. Need not be null-terminated.
+ * @param length The length of text.
+ * @param out_config A pointer to hold the material's configuration.
+ */
+DAPI void material_file_parse_text(const char *name, const char *full_file_path, const char *text, u64 length,
+                                   material_config *out_config);
+
+/**
+ * @brief Writes a cooked material.
+ *
+ * @param out_path The path of the file to create. Replaced only once the new file is complete, so mappings of
+ * the old one stay valid.
+ * @param config A pointer to the material's configuration.
+ * @return True if written successfully; otherwise false.
+ */
+DAPI b8 material_file_write(const char *out_path, const material_config *config);
+
+/**
+ * @brief Parses a source material, e.g. a .kmt, and writes it as a cooked material. The material is
+ * named after the file unless it sets a name itself.
+ *
+ * @param source_path The path of the material to cook.
+ * @param out_path The path of the file to create. Replaced only once the new file is complete, so mappings of
+ * the old one stay valid.
+ * @return True if cooked successfully; otherwise false.
+ */
+DAPI b8 material_file_cook(const char *source_path, const char *out_path);
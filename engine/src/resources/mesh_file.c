@@ -0,0 +1,222 @@
+#include "mesh_file.h"
+
+#include "core/dmemory.h"
+#include "core/dstring.h"
+#include "core/logger.h"
+#include "platform/filesystem.h"
+
+static u64 align_offset(u64 offset)
+{
+    return (offset + MESH_FILE_ALIGNMENT - 1) & ~(u64)(MESH_FILE_ALIGNMENT - 1);
+}
+
+b8 mesh_file_is_cooked(const void *data, u64 size)
+{
+    return data && size >= sizeof(mesh_file_header) && ((const mesh_file_header *)data)->magic == MESH_FILE_MAGIC;
+}
+
+// Gets a string from the string table, checking that it lies within the file.
+static b8 read_string(const mesh_file_header *header, u32 offset, const char **out_string)
+{
+    if (offset == 0)
+    {
+        *out_string = "";
+        return true;
+    }
+    if (offset < sizeof(mesh_file_header) || offset >= header->file_size)
+    {
+        return false;
+    }
+
+    const char *start = (const char *)header + offset;
+    u64 max_length    = header->file_size - offset;
+    for (u64 length = 0; length < max_length; ++length)
+    {
+        if (start[length] == 0)
+        {
+            *out_string = start;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks that a blob of count elements of element_size bytes lies aligned within the file.
+static b8 blob_in_file(const mesh_file_header *header, u64 offset, u32 count, u64 element_size)
+{
+    return offset % MESH_FILE_ALIGNMENT == 0 && offset <= header->file_size &&
+           (u64)count * element_size <= header->file_size - offset;
+}
+
+b8 mesh_file_parse(const void *data, u64 size, u32 max_submeshes, submesh_resource_data *out_submeshes,
+                   u32 *out_submesh_count)
+{
+    if (!mesh_file_is_cooked(data, size) || !out_submesh_count)
+    {
+        DERROR("mesh_file_parse - Not a cooked mesh.");
+        return false;
+    }
+
+    const mesh_file_header *header = data;
+    b8 valid = header->version == MESH_FILE_VERSION && header->vertex_size == sizeof(vertex_3d) &&
+               header->file_size <= size && header->submesh_offset % 8 == 0 &&
+               header->submesh_offset <= header->file_size &&
+               (u64)header->submesh_count * sizeof(mesh_file_submesh) <= header->file_size - header->submesh_offset;
+    const mesh_file_submesh *table = (const mesh_file_submesh *)((const u8 *)data + header->submesh_offset);
+    for (u32 i = 0; valid && i < header->submesh_count; ++i)
+    {
+        const mesh_file_submesh *entry = &table[i];
+        submesh_resource_data submesh  = {0};
+        valid = blob_in_file(header, entry->vertex_offset, entry->vertex_count, sizeof(vertex_3d)) &&
+                blob_in_file(header, entry->index_offset, entry->index_count, sizeof(u32)) &&
+                read_string(header, entry->name_offset, &submesh.name) &&
+                read_string(header, entry->material_name_offset, &submesh.material_name);
+        if (valid && out_submeshes && i < max_submeshes)
+        {
+            submesh.vertex_count = entry->vertex_count;
+            submesh.vertices     = (const vertex_3d *)((const u8 *)data + entry->vertex_offset);
+            submesh.index_count  = entry->index_count;
+            submesh.indices      = (const u32 *)((const u8 *)data + entry->index_offset);
+            out_submeshes[i]     = submesh;
+        }
+    }
+    if (!valid)
+    {
+        DERROR("mesh_file_parse - The cooked mesh is corrupt, or from another version of the engine.");
+        return false;
+    }
+
+    *out_submesh_count = header->submesh_count;
+    return !out_submeshes || header->submesh_count <= max_submeshes;
+}
+
+// Pads the file from position up to offset, then writes a blob there.
+static b8 write_blob(file_writer *writer, u64 *position, u64 offset, u64 size, const void *data)
+{
+    static const u8 zeros[MESH_FILE_ALIGNMENT] = {0};
+    b8 result                                  = true;
+    if (offset > *position)
+    {
+        result = filesystem_writer_write(writer, offset - *position, zeros);
+    }
+    if (size > 0)
+    {
+        result = result && filesystem_writer_write(writer, size, data);
+    }
+    *position = offset + size;
+    return result;
+}
+
+b8 mesh_file_write(const char *out_path, u32 submesh_count, const submesh_resource_data *submeshes)
+{
+    if (!out_path || (submesh_count > 0 && !submeshes))
+    {
+        return false;
+    }
+
+    // Out of range indices would read past the end of the vertex buffer, so they are caught here rather
+    // than on every load.
+    for (u32 i = 0; i < submesh_count; ++i)
+    {
+        for (u32 j = 0; j < submeshes[i].index_count; ++j)
+        {
+            if (submeshes[i].indices[j] >= submeshes[i].vertex_count)
+            {
+                DERROR("mesh_file_write - Submesh %u has index %u, but only %u vertices.", i, submeshes[i].indices[j],
+                       submeshes[i].vertex_count);
+                return false;
+            }
+        }
+    }
+
+    mesh_file_header header = {0};
+    header.magic            = MESH_FILE_MAGIC;
+    header.version          = MESH_FILE_VERSION;
+    header.submesh_count    = submesh_count;
+    header.vertex_size      = sizeof(vertex_3d);
+    header.submesh_offset   = sizeof(mesh_file_header);
+
+    // Lay out the strings straight after the table, so their offsets stay small however large the mesh,
+    // then the blobs.
+    u64 table_size           = sizeof(mesh_file_submesh) * submesh_count;
+    mesh_file_submesh *table = dallocate(table_size ? table_size : 1, MEMORY_TAG_ARRAY);
+    u64 offset               = header.submesh_offset + table_size;
+    for (u32 i = 0; i < submesh_count; ++i)
+    {
+        u64 name_length          = submeshes[i].name ? string_length(submeshes[i].name) : 0;
+        u64 material_name_length = submeshes[i].material_name ? string_length(submeshes[i].material_name) : 0;
+        if (name_length)
+        {
+            table[i].name_offset = (u32)offset;
+            offset += name_length + 1;
+        }
+        if (material_name_length)
+        {
+            table[i].material_name_offset = (u32)offset;
+            offset += material_name_length + 1;
+        }
+    }
+    for (u32 i = 0; i < submesh_count; ++i)
+    {
+        table[i].vertex_count  = submeshes[i].vertex_count;
+        table[i].vertex_offset = align_offset(offset);
+        offset                 = table[i].vertex_offset + sizeof(vertex_3d) * submeshes[i].vertex_count;
+    }
+    for (u32 i = 0; i < submesh_count; ++i)
+    {
+        table[i].index_count  = submeshes[i].index_count;
+        table[i].index_offset = align_offset(offset);
+        offset                = table[i].index_offset + sizeof(u32) * submeshes[i].index_count;
+    }
+    header.file_size = offset;
+
+    // Replaced rather than rewritten, since the mesh may be mapped by a load.
+    file_writer_config config = {0};
+    config.flush_policy       = FILE_FLUSH_ON_SIZE;
+    config.replace_on_close   = true;
+    file_writer writer;
+    if (!filesystem_writer_open(out_path, true, config, &writer))
+    {
+        DERROR("mesh_file_write - Unable to open '%s' for writing.", out_path);
+        dfree(table, table_size ? table_size : 1, MEMORY_TAG_ARRAY);
+        return false;
+    }
+
+    b8 result = filesystem_writer_write(&writer, sizeof(header), &header) &&
+                filesystem_writer_write(&writer, table_size, table);
+    u64 position = header.submesh_offset + table_size;
+    for (u32 i = 0; i < submesh_count && result; ++i)
+    {
+        if (table[i].name_offset)
+        {
+            u64 size = string_length(submeshes[i].name) + 1;
+            result   = filesystem_writer_write(&writer, size, submeshes[i].name);
+            position += size;
+        }
+        if (result && table[i].material_name_offset)
+        {
+            u64 size = string_length(submeshes[i].material_name) + 1;
+            result   = filesystem_writer_write(&writer, size, submeshes[i].material_name);
+            position += size;
+        }
+    }
+    for (u32 i = 0; i < submesh_count && result; ++i)
+    {
+        result = write_blob(&writer, &position, table[i].vertex_offset, sizeof(vertex_3d) * submeshes[i].vertex_count,
+                            submeshes[i].vertices);
+    }
+    for (u32 i = 0; i < submesh_count && result; ++i)
+    {
+        result = write_blob(&writer, &position, table[i].index_offset, sizeof(u32) * submeshes[i].index_count,
+                            submeshes[i].indices);
+    }
+    dfree(table, table_size ? table_size : 1, MEMORY_TAG_ARRAY);
+
+    result = filesystem_writer_flush(&writer) && result;
+    filesystem_writer_close(&writer);
+    if (!result)
+    {
+        DERROR("mesh_file_write - Failed to write '%s'.", out_path);
+    }
+    return result;
+}
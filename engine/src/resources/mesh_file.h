@@ -0,0 +1,85 @@
+#pragma once
+
+#include "defines.h"
+#include "resources/resource_types.h"
+
+/*
+A cooked mesh (.dmsh) holds vertices and indices ready to be copied into staging buffers, so
+loading one costs a map and no parsing, and the loader hands out pointers into the file.
+
+Layout:
+    mesh_file_header
+    submesh table: submesh_count mesh_file_submesh entries
+    string table: the name and material name of each submesh, null-terminated
+    vertex blobs, one per submesh, each aligned to MESH_FILE_ALIGNMENT
+    index blobs, one per submesh, each aligned to MESH_FILE_ALIGNMENT
+
+Vertices are stored as vertex_3d and indices as u32, exactly as the renderer takes them.
+Strings are referred to by their offset from the start of the file. An offset of 0, which
+is inside the header, means the string is empty.
+*/
+
+#define MESH_FILE_MAGIC 0x48534D44 // "DMSH"
+#define MESH_FILE_VERSION 1
+// Vertex and index blobs start on this boundary.
+#define MESH_FILE_ALIGNMENT 16
+
+typedef struct mesh_file_header
+{
+    u32 magic;
+    u32 version;
+    // The size of the whole file.
+    u64 file_size;
+    u32 submesh_count;
+    // The size of a vertex, so files from an engine with another vertex layout are rejected.
+    u32 vertex_size;
+    // Offset from the start of the file of the submesh table.
+    u64 submesh_offset;
+} mesh_file_header;
+
+typedef struct mesh_file_submesh
+{
+    u32 vertex_count;
+    u32 index_count;
+    // Offsets from the start of the file.
+    u64 vertex_offset;
+    u64 index_offset;
+    u32 name_offset;
+    u32 material_name_offset;
+} mesh_file_submesh;
+
+/**
+ * @brief Checks if file contents are a cooked mesh, without validating them.
+ *
+ * @param data The contents of the file.
+ * @param size The size of data in bytes.
+ * @return True if data starts with a mesh file header; otherwise false.
+ */
+DAPI b8 mesh_file_is_cooked(const void *data, u64 size);
+
+/**
+ * @brief Validates a cooked mesh and gets its submeshes, pointing into data rather than copying it.
+ * Only the header, submesh table and strings are checked, so this takes time independent of the size
+ * of the vertices and indices; indices are checked against the vertex count when the file is written.
+ *
+ * @param data The contents of the file. Must stay valid while the submeshes are used.
+ * @param size The size of data in bytes.
+ * @param max_submeshes The number of elements in out_submeshes.
+ * @param out_submeshes An array of at least the mesh's submesh count to hold the submeshes. Can be 0/NULL
+ * to only validate the file.
+ * @param out_submesh_count A pointer to hold the number of submeshes.
+ * @return True if data is a valid cooked mesh and its submeshes fit in out_submeshes; otherwise false.
+ */
+DAPI b8 mesh_file_parse(const void *data, u64 size, u32 max_submeshes, submesh_resource_data *out_submeshes,
+                        u32 *out_submesh_count);
+
+/**
+ * @brief Writes a cooked mesh.
+ *
+ * @param out_path The path of the file to create. Replaced only once the new file is complete, so mappings of
+ * the old one stay valid.
+ * @param submesh_count The number of submeshes.
+ * @param submeshes The submeshes. Names may be 0/NULL for empty ones.
+ * @return True if written successfully; otherwise false, including if an index is out of range.
+ */
+DAPI b8 mesh_file_write(const char *out_path, u32 submesh_count, const submesh_resource_data *submeshes);
@@ -0,0 +1,224 @@
+#include "resource_pack.h"
+
+#include "core/dmemory.h"
+#include "core/dstring.h"
+#include "core/logger.h"
+
+#include <string.h> // memcmp
+
+u64 resource_pack_hash(const char *path, u64 length)
+{
+    // 64-bit FNV-1a.
+    u64 hash = 0xcbf29ce484222325ull;
+    for (u64 i = 0; i < length; ++i)
+    {
+        hash ^= (u8)path[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+b8 resource_pack_open(const char *path, resource_pack *out_pack)
+{
+    dzero_memory(out_pack, sizeof(resource_pack));
+    if (!filesystem_map(path, &out_pack->mapping))
+    {
+        return false;
+    }
+
+    const u8 *data                     = out_pack->mapping.data;
+    u64 size                           = out_pack->mapping.size;
+    const resource_pack_header *header = (const resource_pack_header *)data;
+    if (size < sizeof(resource_pack_header) || header->magic != RESOURCE_PACK_MAGIC ||
+        header->version != RESOURCE_PACK_VERSION)
+    {
+        DERROR("resource_pack_open - '%s' is not a version %i resource pack.", path, RESOURCE_PACK_VERSION);
+        filesystem_unmap(&out_pack->mapping);
+        return false;
+    }
+
+    // Check everything the table of contents points at up front, so lookups need no bounds checks.
+    u64 toc_size = (u64)header->slot_count * sizeof(resource_pack_entry);
+    b8 valid     = header->slot_count != 0 && (header->slot_count & (header->slot_count - 1)) == 0;
+    valid        = valid && header->toc_offset <= size && toc_size <= size - header->toc_offset;
+    valid        = valid && header->paths_offset <= size;
+    const resource_pack_entry *slots = (const resource_pack_entry *)(data + header->toc_offset);
+    for (u32 i = 0; valid && i < header->slot_count; ++i)
+    {
+        const resource_pack_entry *entry = &slots[i];
+        if (entry->path_length == 0)
+        {
+            continue;
+        }
+        valid = entry->offset <= size && entry->size <= size - entry->offset &&
+                (u64)entry->path_offset + entry->path_length <= size - header->paths_offset;
+    }
+    if (!valid)
+    {
+        DERROR("resource_pack_open - The table of contents of '%s' is corrupt.", path);
+        filesystem_unmap(&out_pack->mapping);
+        return false;
+    }
+
+    out_pack->header = header;
+    out_pack->slots  = slots;
+    out_pack->paths  = (const char *)(data + header->paths_offset);
+    return true;
+}
+
+void resource_pack_close(resource_pack *pack)
+{
+    filesystem_unmap(&pack->mapping);
+    dzero_memory(pack, sizeof(resource_pack));
+}
+
+b8 resource_pack_find(const resource_pack *pack, const char *path, file_mapping *out_view)
+{
+    if (!pack->header)
+    {
+        return false;
+    }
+
+    u64 length = string_length(path);
+    u64 hash   = resource_pack_hash(path, length);
+    u32 mask   = pack->header->slot_count - 1;
+    for (u32 probe = 0; probe <= mask; ++probe)
+    {
+        const resource_pack_entry *entry = &pack->slots[(hash + probe) & mask];
+        if (entry->path_length == 0)
+        {
+            // Reached an empty slot, so the path is not in the pack.
+            return false;
+        }
+        if (entry->hash == hash && entry->path_length == length &&
+            memcmp(pack->paths + entry->path_offset, path, length) == 0)
+        {
+            out_view->data = (const u8 *)pack->mapping.data + entry->offset;
+            out_view->size = entry->size;
+            return true;
+        }
+    }
+    return false;
+}
+
+b8 resource_pack_contains(const resource_pack *pack, const void *data)
+{
+    const u8 *start = pack->mapping.data;
+    return start && (const u8 *)data >= start && (const u8 *)data < start + pack->mapping.size;
+}
+
+// Pads the file with zeros up to the next multiple of RESOURCE_PACK_ALIGNMENT.
+static b8 write_padding(file_writer *writer, u64 *position)
+{
+    static const u8 zeros[RESOURCE_PACK_ALIGNMENT] = {0};
+    u64 padding = (RESOURCE_PACK_ALIGNMENT - (*position % RESOURCE_PACK_ALIGNMENT)) % RESOURCE_PACK_ALIGNMENT;
+    *position += padding;
+    return padding == 0 || filesystem_writer_write(writer, padding, zeros);
+}
+
+b8 resource_pack_build(const char *out_path, u32 count, const char **entry_paths, const char **source_paths)
+{
+    // Keep the table at most half full, so probe sequences stay short.
+    u32 slot_count = 16;
+    while (slot_count < count * 2)
+    {
+        slot_count *= 2;
+    }
+    resource_pack_entry *slots = dallocate(sizeof(resource_pack_entry) * slot_count, MEMORY_TAG_ARRAY);
+    file_mapping *sources      = dallocate(sizeof(file_mapping) * (count ? count : 1), MEMORY_TAG_ARRAY);
+
+    // Map every source first. Their sizes decide where each one goes.
+    b8 result  = true;
+    u32 mapped = 0;
+    for (; mapped < count && result; ++mapped)
+    {
+        result = filesystem_map(source_paths[mapped], &sources[mapped]);
+    }
+
+    // Place the table of contents and paths right after the header, and the contents after them.
+    resource_pack_header header = {0};
+    header.magic                = RESOURCE_PACK_MAGIC;
+    header.version              = RESOURCE_PACK_VERSION;
+    header.slot_count           = slot_count;
+    header.entry_count          = count;
+    header.toc_offset           = sizeof(resource_pack_header);
+    header.paths_offset         = header.toc_offset + sizeof(resource_pack_entry) * slot_count;
+
+    u64 paths_size = 0;
+    for (u32 i = 0; i < count && result; ++i)
+    {
+        paths_size += string_length(entry_paths[i]);
+    }
+    u64 position = header.paths_offset + paths_size;
+    position += (RESOURCE_PACK_ALIGNMENT - (position % RESOURCE_PACK_ALIGNMENT)) % RESOURCE_PACK_ALIGNMENT;
+
+    u32 path_offset = 0;
+    for (u32 i = 0; i < count && result; ++i)
+    {
+        u64 path_length = string_length(entry_paths[i]);
+        u64 hash        = resource_pack_hash(entry_paths[i], path_length);
+        u32 slot        = hash & (slot_count - 1);
+        while (slots[slot].path_length != 0)
+        {
+            if (slots[slot].hash == hash && slots[slot].path_length == path_length)
+            {
+                DERROR("resource_pack_build - '%s' is listed more than once, or collides with another path.",
+                       entry_paths[i]);
+                result = false;
+                break;
+            }
+            slot = (slot + 1) & (slot_count - 1);
+        }
+
+        slots[slot].hash        = hash;
+        slots[slot].offset      = position;
+        slots[slot].size        = sources[i].size;
+        slots[slot].path_offset = path_offset;
+        slots[slot].path_length = (u32)path_length;
+        path_offset += (u32)path_length;
+        position += sources[i].size;
+        position += (RESOURCE_PACK_ALIGNMENT - (position % RESOURCE_PACK_ALIGNMENT)) % RESOURCE_PACK_ALIGNMENT;
+    }
+
+    // Then write it all out in order.
+    file_writer_config config = {0};
+    config.flush_policy       = FILE_FLUSH_ON_SIZE;
+    file_writer writer;
+    if (result && filesystem_writer_open(out_path, true, config, &writer))
+    {
+        result = filesystem_writer_write(&writer, sizeof(header), &header) &&
+                 filesystem_writer_write(&writer, sizeof(resource_pack_entry) * slot_count, slots);
+        position = header.paths_offset;
+        for (u32 i = 0; i < count && result; ++i)
+        {
+            u64 path_length = string_length(entry_paths[i]);
+            result          = filesystem_writer_write(&writer, path_length, entry_paths[i]);
+            position += path_length;
+        }
+        for (u32 i = 0; i < count && result; ++i)
+        {
+            result = write_padding(&writer, &position) &&
+                     (sources[i].size == 0 || filesystem_writer_write(&writer, sources[i].size, sources[i].data));
+            position += sources[i].size;
+        }
+        result = filesystem_writer_flush(&writer) && result;
+        filesystem_writer_close(&writer);
+    }
+    else
+    {
+        result = false;
+    }
+
+    for (u32 i = 0; i < mapped; ++i)
+    {
+        filesystem_unmap(&sources[i]);
+    }
+    dfree(sources, sizeof(file_mapping) * (count ? count : 1), MEMORY_TAG_ARRAY);
+    dfree(slots, sizeof(resource_pack_entry) * slot_count, MEMORY_TAG_ARRAY);
+
+    if (!result)
+    {
+        DERROR("resource_pack_build - Failed to build '%s'.", out_path);
+    }
+    return result;
+}
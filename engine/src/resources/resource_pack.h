@@ -0,0 +1,111 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/filesystem.h"
+
+/*
+A resource pack holds many asset files in one, so loading them costs a single open
+and a single mapping rather than one per file.
+
+Layout:
+    resource_pack_header
+    table of contents: header.slot_count resource_pack_entry slots
+    paths of the entries, not null-terminated
+    file contents, each aligned to RESOURCE_PACK_ALIGNMENT
+
+The table of contents is an open-addressed hash table keyed by resource_pack_hash of
+each entry's path, which is relative to the asset base path and uses '/' separators
+(e.g. "textures/paving.png"). Collisions are resolved by probing linearly.
+*/
+
+#define RESOURCE_PACK_MAGIC 0x4B415044 // "DPAK"
+#define RESOURCE_PACK_VERSION 1
+// File contents start on this boundary, so they can be used in place as any basic type.
+#define RESOURCE_PACK_ALIGNMENT 16
+
+typedef struct resource_pack_header
+{
+    u32 magic;
+    u32 version;
+    // The number of slots in the table of contents. Always a power of 2.
+    u32 slot_count;
+    u32 entry_count;
+    // Offsets from the start of the file.
+    u64 toc_offset;
+    u64 paths_offset;
+} resource_pack_header;
+
+typedef struct resource_pack_entry
+{
+    u64 hash;
+    // Offset of the contents from the start of the file.
+    u64 offset;
+    u64 size;
+    // Offset of the path from paths_offset. Slots with a path_length of 0 are empty.
+    u32 path_offset;
+    u32 path_length;
+} resource_pack_entry;
+
+// A mounted pack. Members should not be modified outside the functions below.
+typedef struct resource_pack
+{
+    file_mapping mapping;
+    const resource_pack_header *header;
+    const resource_pack_entry *slots;
+    const char *paths;
+} resource_pack;
+
+/**
+ * @brief Hashes an entry path. Used by both the reader and the builder.
+ *
+ * @param path The path, relative to the asset base path, with '/' separators.
+ * @param length The length of path.
+ * @return The hash.
+ */
+DAPI u64 resource_pack_hash(const char *path, u64 length);
+
+/**
+ * @brief Maps the pack at path and validates its table of contents.
+ *
+ * @param path The path of the pack file.
+ * @param out_pack A pointer to hold the pack.
+ * @return True if opened successfully; otherwise false.
+ */
+DAPI b8 resource_pack_open(const char *path, resource_pack *out_pack);
+
+/**
+ * @brief Unmaps the pack. Views returned by resource_pack_find must no longer be used.
+ *
+ * @param pack A pointer to the pack to be closed.
+ */
+DAPI void resource_pack_close(resource_pack *pack);
+
+/**
+ * @brief Looks up a file in the pack.
+ *
+ * @param pack A pointer to the pack.
+ * @param path The file's path, relative to the asset base path, with '/' separators.
+ * @param out_view A pointer to hold a view of the file's contents, which stays valid while the pack is open.
+ * @return True if the pack contains the file; otherwise false.
+ */
+DAPI b8 resource_pack_find(const resource_pack *pack, const char *path, file_mapping *out_view);
+
+/**
+ * @brief Checks if data points into the pack's contents.
+ *
+ * @param pack A pointer to the pack.
+ * @param data The pointer to check.
+ * @return True if data lies within the pack; otherwise false.
+ */
+DAPI b8 resource_pack_contains(const resource_pack *pack, const void *data);
+
+/**
+ * @brief Writes a new pack holding the given files.
+ *
+ * @param out_path The path of the pack to create. Overwritten if it exists.
+ * @param count The number of files.
+ * @param entry_paths The path of each file within the pack, relative to the asset base path, with '/' separators.
+ * @param source_paths The path of each file on disk.
+ * @return True if written successfully; otherwise false.
+ */
+DAPI b8 resource_pack_build(const char *out_path, u32 count, const char **entry_paths, const char **source_paths);
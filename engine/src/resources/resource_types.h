@@ -1,6 +1,7 @@
 #pragma once
 
 #include "math/math_types.h"
+#include "memory/linear_allocator.h"
 
 // Pre-defined resource types.
 typedef enum resource_type
@@ -9,7 +10,7 @@ typedef enum resource_type
     RESOURCE_TYPE_BINARY,
     RESOURCE_TYPE_IMAGE,
     RESOURCE_TYPE_MATERIAL,
-    RESOURCE_TYPE_STATIC_MESH,
+    RESOURCE_TYPE_MESH,
     RESOURCE_TYPE_CUSTOM
 } resource_type;
 
@@ -20,14 +21,26 @@ typedef struct resource
     char *full_path;
     u64 data_size;
     void *data;
+    // Holds full_path and whatever else the loader allocates for the resource, so it all takes one allocation
+    // and is freed together on unload. See resource_system_create_arena.
+    linear_allocator arena;
 } resource;
 
+// Enough levels for textures up to 32768 pixels on a side.
+#define TEXTURE_MAX_MIP_COUNT 16
+
 typedef struct image_resource_data
 {
     u8 channel_count;
     u32 width;
     u32 height;
     u8 *pixels;
+    // Set by the loader, which scans the alpha channel while decoding.
+    b8 has_transparency;
+    // The number of mip levels, each half the size of the one before. Only cooked textures have more than one.
+    u32 mip_count;
+    // The pixels of each mip level, largest first. The first is pixels.
+    const u8 *mip_pixels[TEXTURE_MAX_MIP_COUNT];
 } image_resource_data;
 
 #define TEXTURE_NAME_MAX_LENGTH 512
@@ -39,6 +52,8 @@ typedef struct texture
     u32 height;
     u8 channel_count;
     b8 has_transparency;
+    // The number of mip levels the renderer holds, the largest of which is width by height.
+    u32 mip_count;
     u32 generation;
     char name[TEXTURE_NAME_MAX_LENGTH];
     void *internal_data;
@@ -87,5 +102,25 @@ typedef struct geometry
     u32 internal_id;
     u32 generation;
     char name[GEOMETRY_NAME_MAX_LENGTH];
+    // The distance of the furthest vertex from the origin, for judging how large the geometry is drawn.
+    f32 radius;
     material *material;
 } geometry;
+
+// One part of a loaded mesh, drawn with a single material. The arrays and strings point into the mesh
+// resource, so they are only valid until it is unloaded.
+typedef struct submesh_resource_data
+{
+    u32 vertex_count;
+    const vertex_3d *vertices;
+    u32 index_count;
+    const u32 *indices;
+    const char *name;
+    const char *material_name;
+} submesh_resource_data;
+
+typedef struct mesh_resource_data
+{
+    u32 submesh_count;
+    submesh_resource_data *submeshes;
+} mesh_resource_data;
@@ -0,0 +1,208 @@
+#include "texture_file.h"
+
+#include "core/dmemory.h"
+#include "core/logger.h"
+#include "platform/filesystem.h"
+
+// The implementation is compiled into the image loader.
+#include "vendor/stb_image.h"
+
+static u64 align_offset(u64 offset)
+{
+    return (offset + TEXTURE_FILE_ALIGNMENT - 1) & ~(u64)(TEXTURE_FILE_ALIGNMENT - 1);
+}
+
+// Gets the width or height of a mip level from that of the full size image.
+static u32 mip_dimension(u32 size, u32 level)
+{
+    return size >> level ? size >> level : 1;
+}
+
+b8 texture_file_is_cooked(const void *data, u64 size)
+{
+    return data && size >= sizeof(texture_file_header) &&
+           ((const texture_file_header *)data)->magic == TEXTURE_FILE_MAGIC;
+}
+
+b8 texture_file_parse(const void *data, u64 size, const texture_file_header **out_header)
+{
+    if (!texture_file_is_cooked(data, size))
+    {
+        DERROR("texture_file_parse - Not a cooked texture.");
+        return false;
+    }
+
+    const texture_file_header *header = data;
+    b8 valid = header->version == TEXTURE_FILE_VERSION && header->format == TEXTURE_FILE_FORMAT_RGBA8 &&
+               header->channel_count == 4 && header->width > 0 && header->height > 0 && header->mip_count > 0 &&
+               header->mip_count <= TEXTURE_FILE_MAX_MIPS;
+    for (u32 i = 0; valid && i < header->mip_count; ++i)
+    {
+        u64 expected_size = (u64)mip_dimension(header->width, i) * mip_dimension(header->height, i) * 4;
+        if (header->mip_sizes[i] != expected_size || header->mip_offsets[i] > size ||
+            header->mip_sizes[i] > size - header->mip_offsets[i])
+        {
+            valid = false;
+        }
+    }
+    if (!valid)
+    {
+        DERROR("texture_file_parse - The cooked texture is corrupt, or from another version of the engine.");
+        return false;
+    }
+
+    *out_header = header;
+    return true;
+}
+
+const u8 *texture_file_mip(const texture_file_header *header, u32 level)
+{
+    if (level >= header->mip_count)
+    {
+        return 0;
+    }
+    return (const u8 *)header + header->mip_offsets[level];
+}
+
+// Halves an image, averaging each 2x2 block. Odd edges reuse their last row or column.
+static void downsample(u32 width, u32 height, const u8 *pixels, u32 out_width, u32 out_height, u8 *out_pixels)
+{
+    for (u32 y = 0; y < out_height; ++y)
+    {
+        u32 y0 = y * 2 < height ? y * 2 : height - 1;
+        u32 y1 = y * 2 + 1 < height ? y * 2 + 1 : y0;
+        for (u32 x = 0; x < out_width; ++x)
+        {
+            u32 x0 = x * 2 < width ? x * 2 : width - 1;
+            u32 x1 = x * 2 + 1 < width ? x * 2 + 1 : x0;
+            for (u32 c = 0; c < 4; ++c)
+            {
+                u32 sum = pixels[(y0 * width + x0) * 4 + c] + pixels[(y0 * width + x1) * 4 + c] +
+                          pixels[(y1 * width + x0) * 4 + c] + pixels[(y1 * width + x1) * 4 + c];
+                out_pixels[(y * out_width + x) * 4 + c] = (u8)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+b8 texture_file_write(const char *out_path, u32 width, u32 height, const u8 *pixels)
+{
+    if (!out_path || !pixels || width == 0 || height == 0)
+    {
+        return false;
+    }
+
+    texture_file_header header = {0};
+    header.magic               = TEXTURE_FILE_MAGIC;
+    header.version             = TEXTURE_FILE_VERSION;
+    header.width               = width;
+    header.height              = height;
+    header.format              = TEXTURE_FILE_FORMAT_RGBA8;
+    header.channel_count       = 4;
+
+    // Levels go all the way down to 1x1.
+    u32 largest      = width > height ? width : height;
+    header.mip_count = 1;
+    while ((largest >> header.mip_count) > 0 && header.mip_count < TEXTURE_FILE_MAX_MIPS)
+    {
+        header.mip_count++;
+    }
+
+    u64 offset = align_offset(sizeof(texture_file_header));
+    for (u32 i = 0; i < header.mip_count; ++i)
+    {
+        header.mip_offsets[i] = offset;
+        header.mip_sizes[i]   = (u64)mip_dimension(width, i) * mip_dimension(height, i) * 4;
+        offset                = align_offset(offset + header.mip_sizes[i]);
+    }
+
+    u64 pixel_count = (u64)width * height;
+    for (u64 i = 0; i < pixel_count; ++i)
+    {
+        if (pixels[i * 4 + 3] < 255)
+        {
+            header.flags |= TEXTURE_FILE_FLAG_HAS_TRANSPARENCY;
+            break;
+        }
+    }
+
+    // Replaced rather than rewritten, since the cooked texture may be mapped by a load.
+    file_writer_config config = {0};
+    config.flush_policy       = FILE_FLUSH_ON_SIZE;
+    config.replace_on_close   = true;
+    file_writer writer;
+    if (!filesystem_writer_open(out_path, true, config, &writer))
+    {
+        DERROR("texture_file_write - Unable to open '%s' for writing.", out_path);
+        return false;
+    }
+
+    static const u8 zeros[TEXTURE_FILE_ALIGNMENT] = {0};
+    b8 result                                     = filesystem_writer_write(&writer, sizeof(header), &header);
+    u64 position                                  = sizeof(header);
+
+    // Each level is made from the one before, so only two are held at once.
+    const u8 *level = pixels;
+    u8 *previous    = 0;
+    for (u32 i = 0; i < header.mip_count && result; ++i)
+    {
+        if (i > 0)
+        {
+            u8 *next = dallocate(header.mip_sizes[i], MEMORY_TAG_TEXTURE);
+            downsample(mip_dimension(width, i - 1), mip_dimension(height, i - 1), level, mip_dimension(width, i),
+                       mip_dimension(height, i), next);
+            if (previous)
+            {
+                dfree(previous, header.mip_sizes[i - 1], MEMORY_TAG_TEXTURE);
+            }
+            previous = next;
+            level    = next;
+        }
+
+        u64 padding = header.mip_offsets[i] - position;
+        if (padding > 0)
+        {
+            result = filesystem_writer_write(&writer, padding, zeros);
+        }
+        result   = result && filesystem_writer_write(&writer, header.mip_sizes[i], level);
+        position = header.mip_offsets[i] + header.mip_sizes[i];
+    }
+    if (previous)
+    {
+        dfree(previous, header.mip_sizes[header.mip_count - 1], MEMORY_TAG_TEXTURE);
+    }
+
+    result = filesystem_writer_flush(&writer) && result;
+    filesystem_writer_close(&writer);
+    if (!result)
+    {
+        DERROR("texture_file_write - Failed to write '%s'.", out_path);
+    }
+    return result;
+}
+
+b8 texture_file_cook(const char *source_path, const char *out_path)
+{
+    file_mapping mapping;
+    if (!filesystem_map(source_path, &mapping))
+    {
+        return false;
+    }
+
+    // Match the image loader, which flips images as it decodes them.
+    stbi_set_flip_vertically_on_load_thread(true);
+    s32 width;
+    s32 height;
+    s32 channel_count;
+    u8 *pixels = stbi_load_from_memory(mapping.data, (s32)mapping.size, &width, &height, &channel_count, 4);
+    filesystem_unmap(&mapping);
+    if (!pixels)
+    {
+        DERROR("texture_file_cook - Failed to decode '%s': %s", source_path, stbi_failure_reason());
+        return false;
+    }
+
+    b8 result = texture_file_write(out_path, (u32)width, (u32)height, pixels);
+    stbi_image_free(pixels);
+    return result;
+}
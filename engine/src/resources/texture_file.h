@@ -0,0 +1,101 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+A cooked texture (.dtex) holds pixels ready to be copied into a staging buffer, so loading
+one costs a read rather than a decode.
+
+Layout:
+    texture_file_header
+    mip level 0 (full size), then each level half the size of the one before, down to 1x1,
+    each aligned to TEXTURE_FILE_ALIGNMENT
+
+Pixels are stored bottom row first, as the image loader decodes source images, and the
+transparency scan is done when cooking rather than at load time.
+*/
+
+#define TEXTURE_FILE_MAGIC 0x58455444 // "DTEX"
+#define TEXTURE_FILE_VERSION 1
+// Enough levels for textures up to 32768 pixels on a side.
+#define TEXTURE_FILE_MAX_MIPS 16
+// Mip levels start on this boundary.
+#define TEXTURE_FILE_ALIGNMENT 16
+
+typedef enum texture_file_format
+{
+    // 8 bits per channel, 4 channels. The only format the renderer uploads at present.
+    TEXTURE_FILE_FORMAT_RGBA8 = 1
+} texture_file_format;
+
+typedef enum texture_file_flags
+{
+    TEXTURE_FILE_FLAG_HAS_TRANSPARENCY = 0x1
+} texture_file_flags;
+
+typedef struct texture_file_header
+{
+    u32 magic;
+    u32 version;
+    u32 width;
+    u32 height;
+    // A texture_file_format.
+    u32 format;
+    u32 channel_count;
+    u32 mip_count;
+    // texture_file_flags.
+    u32 flags;
+    // Offset from the start of the file, and size, of each mip level.
+    u64 mip_offsets[TEXTURE_FILE_MAX_MIPS];
+    u64 mip_sizes[TEXTURE_FILE_MAX_MIPS];
+} texture_file_header;
+
+/**
+ * @brief Checks if file contents are a cooked texture, without validating them.
+ *
+ * @param data The contents of the file.
+ * @param size The size of data in bytes.
+ * @return True if data starts with a texture file header; otherwise false.
+ */
+DAPI b8 texture_file_is_cooked(const void *data, u64 size);
+
+/**
+ * @brief Validates the header of a cooked texture, so its mip levels can be used without bounds checks.
+ *
+ * @param data The contents of the file. Must stay valid while the header is used.
+ * @param size The size of data in bytes.
+ * @param out_header A pointer to hold the header, which points into data.
+ * @return True if data is a valid cooked texture; otherwise false.
+ */
+DAPI b8 texture_file_parse(const void *data, u64 size, const texture_file_header **out_header);
+
+/**
+ * @brief Gets the pixels of a mip level of a parsed texture.
+ *
+ * @param header The header from texture_file_parse.
+ * @param level The mip level, where 0 is the full size image.
+ * @return A pointer to the level's pixels, or 0 if the texture has no such level.
+ */
+DAPI const u8 *texture_file_mip(const texture_file_header *header, u32 level);
+
+/**
+ * @brief Writes a cooked texture, with a full chain of mip levels, from 4 channel pixels.
+ *
+ * @param out_path The path of the file to create. Replaced only once the new file is complete, so mappings of
+ * the old one stay valid.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param pixels The image's pixels, 4 channels with 8 bits each, bottom row first.
+ * @return True if written successfully; otherwise false.
+ */
+DAPI b8 texture_file_write(const char *out_path, u32 width, u32 height, const u8 *pixels);
+
+/**
+ * @brief Decodes a source image, e.g. a .png, and writes it as a cooked texture.
+ *
+ * @param source_path The path of the image to cook.
+ * @param out_path The path of the file to create. Replaced only once the new file is complete, so mappings of
+ * the old one stay valid.
+ * @return True if cooked successfully; otherwise false.
+ */
+DAPI b8 texture_file_cook(const char *source_path, const char *out_path);
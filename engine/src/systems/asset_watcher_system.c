@@ -0,0 +1,218 @@
+#include "asset_watcher_system.h"
+
+#include "core/dmemory.h"
+#include "core/dstring.h"
+#include "core/logger.h"
+#include "platform/filesystem.h"
+#include "platform/platform.h"
+#include "renderer/renderer_frontend.h"
+#include "resources/material_file.h"
+#include "resources/texture_file.h"
+#include "systems/material_system.h"
+#include "systems/resource_system.h"
+#include "systems/texture_system.h"
+
+// The most changed assets waiting to settle at once. Further changes are dropped until some are reloaded.
+#define ASSET_WATCHER_MAX_PENDING 64
+
+typedef enum asset_kind
+{
+    ASSET_KIND_TEXTURE,
+    ASSET_KIND_MATERIAL,
+    ASSET_KIND_SHADER
+} asset_kind;
+
+// Which files map to which kind of asset. Names are the path within the directory, minus the extension.
+typedef struct asset_directory
+{
+    const char *directory;
+    const char *extension;
+    asset_kind kind;
+    // For source files the cook tool converts: the extension of the cooked copy, and how to make it.
+    const char *cooked_extension;
+    b8 (*cook)(const char *source_path, const char *out_path);
+} asset_directory;
+
+static const asset_directory asset_directories[] = {
+    {"textures", ".png", ASSET_KIND_TEXTURE, ".dtex", texture_file_cook},
+    {"textures", ".jpg", ASSET_KIND_TEXTURE, ".dtex", texture_file_cook},
+    {"textures", ".tga", ASSET_KIND_TEXTURE, ".dtex", texture_file_cook},
+    {"textures", ".dtex", ASSET_KIND_TEXTURE, 0, 0},
+    {"materials", ".kmt", ASSET_KIND_MATERIAL, ".dmt", material_file_cook},
+    {"materials", ".dmt", ASSET_KIND_MATERIAL, 0, 0},
+    {"shaders", ".spv", ASSET_KIND_SHADER, 0, 0},
+};
+
+typedef struct pending_reload
+{
+    const asset_directory *directory;
+    asset_kind kind;
+    char name[256];
+    // The path relative to the asset base path.
+    char path[512];
+    // When the file last changed, from platform_get_absolute_time.
+    f64 changed_at;
+} pending_reload;
+
+typedef struct asset_watcher_system_state
+{
+    asset_watcher_system_config config;
+    file_watcher watcher;
+    pending_reload pending[ASSET_WATCHER_MAX_PENDING];
+    u32 pending_count;
+} asset_watcher_system_state;
+
+static asset_watcher_system_state *state_ptr = 0;
+
+b8 asset_watcher_system_initialize(u64 *memory_requirement, void *state, asset_watcher_system_config config)
+{
+    *memory_requirement = sizeof(asset_watcher_system_state);
+    if (!state)
+    {
+        return true;
+    }
+
+    dzero_memory(state, sizeof(asset_watcher_system_state));
+    asset_watcher_system_state *s = state;
+    s->config                     = config;
+    if (!filesystem_watcher_create(config.asset_base_path, &s->watcher))
+    {
+        DERROR("asset_watcher_system_initialize - Unable to watch '%s'; hot reload is disabled.",
+               config.asset_base_path);
+        return false;
+    }
+
+    state_ptr = s;
+    DINFO("Watching '%s' for asset changes.", config.asset_base_path);
+    return true;
+}
+
+void asset_watcher_system_shutdown(void *state)
+{
+    if (state_ptr)
+    {
+        filesystem_watcher_destroy(&state_ptr->watcher);
+        state_ptr = 0;
+    }
+}
+
+// Maps a changed file to the asset it holds, and queues it to be reloaded once it settles.
+static void on_file_changed(const char *path, void *user_data)
+{
+    string_view view    = string_view_create(path, string_length(path));
+    u32 directory_count = sizeof(asset_directories) / sizeof(asset_directory);
+    for (u32 d = 0; d < directory_count; ++d)
+    {
+        const asset_directory *directory = &asset_directories[d];
+        u64 prefix_length                = string_length(directory->directory);
+        u64 extension_length             = string_length(directory->extension);
+        if (view.length <= prefix_length + 1 + extension_length || path[prefix_length] != '/' ||
+            !string_view_equali(string_view_mid(view, 0, prefix_length), directory->directory) ||
+            !string_view_equali(string_view_mid(view, view.length - extension_length, -1), directory->extension))
+        {
+            continue;
+        }
+
+        char name[256];
+        string_view name_view =
+            string_view_mid(view, prefix_length + 1, view.length - prefix_length - 1 - extension_length);
+        string_view_copy(name, name_view, sizeof(name) - 1);
+
+        f64 now = platform_get_absolute_time();
+        for (u32 i = 0; i < state_ptr->pending_count; ++i)
+        {
+            pending_reload *pending = &state_ptr->pending[i];
+            if (pending->kind == directory->kind && strings_equal(pending->name, name))
+            {
+                // Still changing; wait for it to settle again.
+                pending->changed_at = now;
+                return;
+            }
+        }
+
+        if (state_ptr->pending_count >= ASSET_WATCHER_MAX_PENDING)
+        {
+            DWARN("Too many changed assets at once; not reloading '%s'.", path);
+            return;
+        }
+        pending_reload *pending = &state_ptr->pending[state_ptr->pending_count++];
+        pending->directory      = directory;
+        pending->kind           = directory->kind;
+        pending->changed_at     = now;
+        string_view_copy(pending->name, name_view, sizeof(pending->name) - 1);
+        string_view_copy(pending->path, view, sizeof(pending->path) - 1);
+        return;
+    }
+}
+
+// Cooks an edited source file again if it has been cooked before, since the cooked copy takes precedence.
+// Returns true if it was, in which case the cooked copy's own change reloads the asset.
+static b8 recook(const pending_reload *pending, const char *full_path)
+{
+    const asset_directory *directory = pending->directory;
+    if (!directory->cook)
+    {
+        return false;
+    }
+
+    char cooked_path[1024];
+    string_format(cooked_path, "%s/%s/%s%s", state_ptr->config.asset_base_path, directory->directory, pending->name,
+                  directory->cooked_extension);
+    return filesystem_exists(cooked_path) && directory->cook(full_path, cooked_path);
+}
+
+void asset_watcher_system_update()
+{
+    if (!state_ptr)
+    {
+        return;
+    }
+
+    filesystem_watcher_poll(&state_ptr->watcher, on_file_changed, 0);
+
+    f64 now           = platform_get_absolute_time();
+    b8 reload_shaders = false;
+    u32 i             = 0;
+    while (i < state_ptr->pending_count)
+    {
+        pending_reload *pending = &state_ptr->pending[i];
+        if (now - pending->changed_at < state_ptr->config.settle_seconds)
+        {
+            i++;
+            continue;
+        }
+
+        // The edited file now takes precedence over any copy in a pack.
+        char full_path[1024];
+        string_format(full_path, "%s/%s", state_ptr->config.asset_base_path, pending->path);
+        resource_system_prefer_loose_file(full_path);
+
+        // Assets that are not loaded are skipped; they pick up the new file when next acquired.
+        if (!recook(pending, full_path))
+        {
+            switch (pending->kind)
+            {
+            case ASSET_KIND_TEXTURE:
+                resource_system_evict(pending->name, RESOURCE_TYPE_IMAGE);
+                texture_system_reload(pending->name);
+                break;
+            case ASSET_KIND_MATERIAL:
+                resource_system_evict(pending->name, RESOURCE_TYPE_MATERIAL);
+                material_system_reload(pending->name);
+                break;
+            case ASSET_KIND_SHADER:
+                // Every stage is rebuilt together, so changes to several of them cost one reload.
+                reload_shaders = true;
+                break;
+            }
+        }
+
+        // Swap the last entry into this one.
+        state_ptr->pending[i] = state_ptr->pending[--state_ptr->pending_count];
+    }
+
+    if (reload_shaders)
+    {
+        renderer_reload_shaders();
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Watches the asset directory and reloads assets when their files change, so edits show up
+without restarting:
+    textures/<name>.png     reloads texture <name>
+    materials/<name>.kmt    reloads material <name>
+    shaders/<name>.spv      reloads the shaders
+Reloads replace assets in place and bump their generations, so anything holding them
+picks up the change on its own. From then on, changed files are read from disk even if
+a mounted pack also holds them.
+*/
+
+typedef struct asset_watcher_system_config
+{
+    // The directory to watch. Should be the resource system's asset base path.
+    const char *asset_base_path;
+    // How long, in seconds, a file must go without changing before it is reloaded, so an editor
+    // that saves in several steps causes one reload of the finished file.
+    f64 settle_seconds;
+} asset_watcher_system_config;
+
+b8 asset_watcher_system_initialize(u64 *memory_requirement, void *state, asset_watcher_system_config config);
+void asset_watcher_system_shutdown(void *state);
+
+/**
+ * @brief Picks up file changes and starts the reloads of those that have settled. Must be called from
+ * the main thread, at a point where the renderer is not drawing.
+ */
+void asset_watcher_system_update();
@@ -3,8 +3,10 @@
 #include "core/dmemory.h"
 #include "core/dstring.h"
 #include "core/logger.h"
+#include "math/dmath.h"
 #include "renderer/renderer_frontend.h"
 #include "systems/material_system.h"
+#include "systems/resource_system.h"
 
 typedef struct geometry_reference
 {
@@ -121,6 +123,53 @@ geometry *geometry_system_acquire_from_config(geometry_config config, b8 auto_re
     return g;
 }
 
+u32 geometry_system_acquire_from_mesh(const char *name, b8 auto_release, u32 max_count, geometry **out_geometries)
+{
+    resource mesh_resource;
+    if (!resource_system_load(name, RESOURCE_TYPE_MESH, &mesh_resource))
+    {
+        DERROR("geometry_system_acquire_from_mesh - Failed to load mesh '%s'.", name);
+        return 0;
+    }
+
+    const mesh_resource_data *mesh = mesh_resource.data;
+    if (mesh->submesh_count > max_count)
+    {
+        DWARN("Mesh '%s' has %u submeshes, but room was only given for %u. Skipping the rest.", name,
+              mesh->submesh_count, max_count);
+    }
+
+    u32 count = 0;
+    for (u32 i = 0; i < mesh->submesh_count && i < max_count; ++i)
+    {
+        const submesh_resource_data *submesh = &mesh->submeshes[i];
+
+        // Point straight at the loaded data; creating the geometry only reads it.
+        geometry_config config;
+        config.vertex_count = submesh->vertex_count;
+        config.vertices     = (vertex_3d *)submesh->vertices;
+        config.index_count  = submesh->index_count;
+        config.indices      = (u32 *)submesh->indices;
+        const char *g_name  = submesh->name[0] ? submesh->name : name;
+        string_view_copy(config.name, string_view_create(g_name, string_length(g_name)),
+                         GEOMETRY_NAME_MAX_LENGTH - 1);
+        string_view_copy(config.material_name,
+                         string_view_create(submesh->material_name, string_length(submesh->material_name)),
+                         MATERIAL_NAME_MAX_LENGTH - 1);
+
+        geometry *g = geometry_system_acquire_from_config(config, auto_release);
+        if (!g)
+        {
+            DWARN("Failed to create geometry for submesh %u of mesh '%s'.", i, name);
+            continue;
+        }
+        out_geometries[count++] = g;
+    }
+
+    resource_system_unload(&mesh_resource);
+    return count;
+}
+
 void geometry_system_release(geometry *geometry)
 {
     if (geometry && geometry->id != INVALID_ID)
@@ -165,6 +214,21 @@ geometry *geometry_system_get_default()
     return 0;
 }
 
+// Gets the distance of the furthest vertex from the origin.
+static f32 geometry_radius(u32 vertex_count, const vertex_3d *vertices)
+{
+    f32 radius_squared = 0;
+    for (u32 i = 0; i < vertex_count; ++i)
+    {
+        f32 distance_squared = vec3_length_squared(vertices[i].position);
+        if (distance_squared > radius_squared)
+        {
+            radius_squared = distance_squared;
+        }
+    }
+    return dsqrt(radius_squared);
+}
+
 b8 create_geometry(geometry_system_state *state, geometry_config config, geometry *g)
 {
     // Send the geometry off to the renderer to be uploaded to the GPU.
@@ -179,6 +243,7 @@ b8 create_geometry(geometry_system_state *state, geometry_config config, geometr
 
         return false;
     }
+    g->radius = geometry_radius(config.vertex_count, config.vertices);
 
     // Acquire the material
     if (string_length(config.material_name) > 0)
@@ -245,6 +310,7 @@ b8 create_default_geometry(geometry_system_state *state)
         DFATAL("Failed to create default geometry. Application cannot continue.");
         return false;
     }
+    state->default_geometry.radius = geometry_radius(4, verts);
 
     // Acquire the default material.
     state->default_geometry.material = material_system_get_default();
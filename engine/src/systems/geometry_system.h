@@ -43,6 +43,18 @@ geometry *geometry_system_acquire_by_id(u32 id);
  */
 geometry *geometry_system_acquire_from_config(geometry_config config, b8 auto_release);
 
+/**
+ * @brief Loads a mesh and acquires a geometry for each of its submeshes. Vertices and indices go from the
+ * loaded file to the renderer's staging buffers without being copied along the way.
+ *
+ * @param name The name of the mesh to load.
+ * @param auto_release Indicates if the acquired geometries should be unloaded when their reference count reaches 0.
+ * @param max_count The number of elements in out_geometries. Submeshes beyond it are skipped.
+ * @param out_geometries An array to hold pointers to the acquired geometries.
+ * @return The number of geometries acquired, or 0 if the mesh failed to load.
+ */
+u32 geometry_system_acquire_from_mesh(const char *name, b8 auto_release, u32 max_count, geometry **out_geometries);
+
 /**
  * @brief Releases a reference to the provided geometry.
  *
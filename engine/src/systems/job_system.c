@@ -0,0 +1,447 @@
+#include "job_system.h"
+
+#include "core/datomic.h"
+#include "core/dmemory.h"
+#include "core/logger.h"
+#include "platform/platform.h"
+
+/**
+ * @brief A fixed-capacity Chase-Lev work-stealing deque. Only the owning worker
+ * pushes and pops at the bottom; any other thread may steal from the top.
+ * top and bottom live on separate cache lines so thieves don't contend with the owner.
+ */
+typedef struct job_deque
+{
+    s64 top;
+    u8 padding0[56];
+    s64 bottom;
+    u8 padding1[56];
+    job_info *jobs;
+} job_deque;
+
+// A mutex-protected ring buffer for jobs submitted from threads that are not workers.
+typedef struct job_queue
+{
+    u32 head;
+    u32 count;
+    job_info *jobs;
+} job_queue;
+
+typedef struct job_worker
+{
+    u32 index;
+    u32 random_seed;
+    platform_thread thread;
+    // One deque per priority.
+    job_deque deques[JOB_PRIORITY_MAX];
+} job_worker;
+
+typedef struct job_system_state
+{
+    job_system_config config;
+    b8 running;
+    u32 worker_count;
+    job_worker *workers;
+
+    // Shared queues for submissions from non-worker threads, one per priority.
+    platform_mutex queue_mutex;
+    job_queue queues[JOB_PRIORITY_MAX];
+
+    // Signalled once per submitted job to wake a sleeping worker.
+    platform_semaphore work_semaphore;
+} job_system_state;
+
+static job_system_state *state_ptr = 0;
+
+// The index of the worker running on the calling thread, or -1 if not a worker.
+static DTHREADLOCAL s32 current_worker_index = -1;
+// Seed used to pick steal victims from threads that are not workers.
+static DTHREADLOCAL u32 external_random_seed = 0x9E3779B9;
+
+static u32 job_worker_thread_run(void *params);
+static b8 find_job(s32 worker_index, job_info *out_job);
+static void run_job(job_info *job);
+
+static u32 job_system_worker_count_for(job_system_config config)
+{
+    // One worker per core, leaving a core for the main thread.
+    u32 processor_count = platform_get_processor_count();
+    u32 count           = processor_count > 1 ? processor_count - 1 : 1;
+    return count > config.max_worker_count ? config.max_worker_count : count;
+}
+
+b8 job_system_initialize(u64 *memory_requirement, void *state, job_system_config config)
+{
+    if (config.max_worker_count == 0)
+    {
+        DFATAL("job_system_initialize - config.max_worker_count must be > 0.");
+        return false;
+    }
+    if (config.max_job_count == 0 || (config.max_job_count & (config.max_job_count - 1)) != 0)
+    {
+        DFATAL("job_system_initialize - config.max_job_count must be a power of 2.");
+        return false;
+    }
+
+    u32 worker_count = job_system_worker_count_for(config);
+
+    // Block of memory will contain state structure, then the workers, then the job storage for
+    // each worker deque, then the job storage for the shared queues.
+    u64 struct_requirement = sizeof(job_system_state);
+    u64 worker_requirement = sizeof(job_worker) * worker_count;
+    u64 jobs_requirement   = sizeof(job_info) * config.max_job_count * JOB_PRIORITY_MAX * (worker_count + 1);
+    *memory_requirement    = struct_requirement + worker_requirement + jobs_requirement;
+
+    if (!state)
+    {
+        return true;
+    }
+
+    dzero_memory(state, *memory_requirement);
+    state_ptr               = state;
+    state_ptr->config       = config;
+    state_ptr->worker_count = worker_count;
+    state_ptr->workers      = state + struct_requirement;
+
+    job_info *job_block = state + struct_requirement + worker_requirement;
+    for (u32 i = 0; i < worker_count; ++i)
+    {
+        job_worker *worker  = &state_ptr->workers[i];
+        worker->index       = i;
+        worker->random_seed = 0x9E3779B9 ^ (i * 0x85EBCA6B);
+        for (u32 p = 0; p < JOB_PRIORITY_MAX; ++p)
+        {
+            worker->deques[p].jobs = job_block;
+            job_block += config.max_job_count;
+        }
+    }
+    for (u32 p = 0; p < JOB_PRIORITY_MAX; ++p)
+    {
+        state_ptr->queues[p].jobs = job_block;
+        job_block += config.max_job_count;
+    }
+
+    if (!platform_mutex_create(&state_ptr->queue_mutex))
+    {
+        DFATAL("job_system_initialize - Failed to create job queue mutex.");
+        return false;
+    }
+    if (!platform_semaphore_create(0, &state_ptr->work_semaphore))
+    {
+        DFATAL("job_system_initialize - Failed to create job semaphore.");
+        return false;
+    }
+
+    state_ptr->running = true;
+    for (u32 i = 0; i < worker_count; ++i)
+    {
+        if (!platform_thread_create(job_worker_thread_run, &state_ptr->workers[i], &state_ptr->workers[i].thread))
+        {
+            DFATAL("job_system_initialize - Failed to create worker thread %u.", i);
+            state_ptr->worker_count = i;
+            job_system_shutdown(state_ptr);
+            return false;
+        }
+    }
+
+    DINFO("Job system started with %u worker threads.", worker_count);
+    return true;
+}
+
+void job_system_shutdown(void *state)
+{
+    if (state_ptr)
+    {
+        // Help finish everything still queued so no counter is left waiting forever. Workers
+        // drain their own deques before going back to sleep, so anything they spawn is run too.
+        job_info job;
+        while (find_job(-1, &job))
+        {
+            run_job(&job);
+        }
+
+        datomic_store(&state_ptr->running, false, DATOMIC_RELEASE);
+
+        // Wake every worker so each one sees the flag and exits.
+        for (u32 i = 0; i < state_ptr->worker_count; ++i)
+        {
+            platform_semaphore_signal(&state_ptr->work_semaphore);
+        }
+        for (u32 i = 0; i < state_ptr->worker_count; ++i)
+        {
+            platform_thread_join(&state_ptr->workers[i].thread);
+        }
+
+        platform_semaphore_destroy(&state_ptr->work_semaphore);
+        platform_mutex_destroy(&state_ptr->queue_mutex);
+        state_ptr = 0;
+    }
+}
+
+static b8 deque_push(job_deque *deque, u32 capacity, const job_info *job)
+{
+    s64 bottom = datomic_load(&deque->bottom, DATOMIC_RELAXED);
+    s64 top    = datomic_load(&deque->top, DATOMIC_ACQUIRE);
+    if (bottom - top >= (s64)capacity)
+    {
+        return false;
+    }
+
+    deque->jobs[bottom & (capacity - 1)] = *job;
+    // Release so the job is visible to any thief that observes the new bottom.
+    datomic_store(&deque->bottom, bottom + 1, DATOMIC_RELEASE);
+    return true;
+}
+
+static b8 deque_pop(job_deque *deque, u32 capacity, job_info *out_job)
+{
+    s64 bottom = datomic_load(&deque->bottom, DATOMIC_RELAXED) - 1;
+    datomic_store(&deque->bottom, bottom, DATOMIC_RELAXED);
+    datomic_thread_fence(DATOMIC_SEQ_CST);
+    s64 top = datomic_load(&deque->top, DATOMIC_RELAXED);
+
+    if (top > bottom)
+    {
+        // Empty; restore.
+        datomic_store(&deque->bottom, bottom + 1, DATOMIC_RELAXED);
+        return false;
+    }
+
+    *out_job = deque->jobs[bottom & (capacity - 1)];
+    if (top != bottom)
+    {
+        return true;
+    }
+
+    // This was the last job, so race any thieves for it.
+    b8 won = datomic_compare_exchange(&deque->top, &top, top + 1, DATOMIC_SEQ_CST, DATOMIC_RELAXED);
+    datomic_store(&deque->bottom, bottom + 1, DATOMIC_RELAXED);
+    return won;
+}
+
+static b8 deque_steal(job_deque *deque, u32 capacity, job_info *out_job)
+{
+    s64 top = datomic_load(&deque->top, DATOMIC_ACQUIRE);
+    datomic_thread_fence(DATOMIC_SEQ_CST);
+    s64 bottom = datomic_load(&deque->bottom, DATOMIC_ACQUIRE);
+    if (top >= bottom)
+    {
+        return false;
+    }
+
+    job_info job = deque->jobs[top & (capacity - 1)];
+    if (!datomic_compare_exchange(&deque->top, &top, top + 1, DATOMIC_SEQ_CST, DATOMIC_RELAXED))
+    {
+        // Lost the race to the owner or another thief.
+        return false;
+    }
+
+    *out_job = job;
+    return true;
+}
+
+static b8 queue_push(job_priority priority, const job_info *job)
+{
+    b8 pushed        = false;
+    job_queue *queue = &state_ptr->queues[priority];
+    u32 capacity     = state_ptr->config.max_job_count;
+
+    platform_mutex_lock(&state_ptr->queue_mutex);
+    if (queue->count < capacity)
+    {
+        queue->jobs[(queue->head + queue->count) & (capacity - 1)] = *job;
+        datomic_store(&queue->count, queue->count + 1, DATOMIC_RELAXED);
+        pushed = true;
+    }
+    platform_mutex_unlock(&state_ptr->queue_mutex);
+
+    return pushed;
+}
+
+static b8 queue_pop(job_priority priority, job_info *out_job)
+{
+    job_queue *queue = &state_ptr->queues[priority];
+
+    // Cheap check to avoid taking the lock when there is obviously nothing to do.
+    if (datomic_load(&queue->count, DATOMIC_RELAXED) == 0)
+    {
+        return false;
+    }
+
+    b8 popped = false;
+    platform_mutex_lock(&state_ptr->queue_mutex);
+    if (queue->count > 0)
+    {
+        *out_job    = queue->jobs[queue->head];
+        queue->head = (queue->head + 1) & (state_ptr->config.max_job_count - 1);
+        datomic_store(&queue->count, queue->count - 1, DATOMIC_RELAXED);
+        popped = true;
+    }
+    platform_mutex_unlock(&state_ptr->queue_mutex);
+
+    return popped;
+}
+
+static u32 next_random(u32 *seed)
+{
+    // xorshift32
+    u32 x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+/**
+ * @brief Finds the next job to run, highest priority first. At each priority
+ * the worker's own deque is checked, then the shared queue, then the other
+ * workers' deques starting from a random victim.
+ */
+static b8 find_job(s32 worker_index, job_info *out_job)
+{
+    u32 capacity     = state_ptr->config.max_job_count;
+    u32 worker_count = state_ptr->worker_count;
+    u32 *seed        = worker_index >= 0 ? &state_ptr->workers[worker_index].random_seed : &external_random_seed;
+
+    for (u32 p = 0; p < JOB_PRIORITY_MAX; ++p)
+    {
+        if (worker_index >= 0 && deque_pop(&state_ptr->workers[worker_index].deques[p], capacity, out_job))
+        {
+            return true;
+        }
+
+        if (queue_pop(p, out_job))
+        {
+            return true;
+        }
+
+        u32 start = next_random(seed) % worker_count;
+        for (u32 i = 0; i < worker_count; ++i)
+        {
+            u32 victim = (start + i) % worker_count;
+            if ((s32)victim == worker_index)
+            {
+                continue;
+            }
+            if (deque_steal(&state_ptr->workers[victim].deques[p], capacity, out_job))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static void run_job(job_info *job)
+{
+    job->entry_point(job->params);
+    if (job->counter)
+    {
+        datomic_fetch_sub(&job->counter->value, 1, DATOMIC_ACQ_REL);
+    }
+}
+
+static u32 job_worker_thread_run(void *params)
+{
+    job_worker *worker   = params;
+    current_worker_index = worker->index;
+
+    while (true)
+    {
+        platform_semaphore_wait(&state_ptr->work_semaphore);
+        if (!datomic_load(&state_ptr->running, DATOMIC_ACQUIRE))
+        {
+            break;
+        }
+
+        // Drain everything reachable before going back to sleep.
+        job_info job;
+        while (find_job(worker->index, &job))
+        {
+            run_job(&job);
+        }
+    }
+
+    current_worker_index = -1;
+    return 0;
+}
+
+job_info job_create(PFN_job_entry entry_point, void *params, job_priority priority, job_counter *counter)
+{
+    job_info info;
+    info.entry_point = entry_point;
+    info.params      = params;
+    info.priority    = priority;
+    info.counter     = counter;
+    return info;
+}
+
+b8 job_system_submit(job_info info)
+{
+    if (!state_ptr || !datomic_load(&state_ptr->running, DATOMIC_ACQUIRE))
+    {
+        DERROR("job_system_submit called while the job system is not running.");
+        return false;
+    }
+    if (!info.entry_point || info.priority >= JOB_PRIORITY_MAX)
+    {
+        DERROR("job_system_submit requires an entry point and a valid priority.");
+        return false;
+    }
+
+    if (info.counter)
+    {
+        datomic_fetch_add(&info.counter->value, 1, DATOMIC_ACQ_REL);
+    }
+
+    // Workers keep their own jobs local, where they stay cache-warm and can be stolen.
+    b8 queued = false;
+    if (current_worker_index >= 0)
+    {
+        job_deque *deque = &state_ptr->workers[current_worker_index].deques[info.priority];
+        queued           = deque_push(deque, state_ptr->config.max_job_count, &info);
+    }
+    if (!queued)
+    {
+        queued = queue_push(info.priority, &info);
+    }
+
+    if (!queued)
+    {
+        // Everything is full. Rather than dropping the job, run it here so progress is guaranteed.
+        run_job(&info);
+        return true;
+    }
+
+    platform_semaphore_signal(&state_ptr->work_semaphore);
+    return true;
+}
+
+void job_system_wait(job_counter *counter)
+{
+    if (!state_ptr || !counter)
+    {
+        return;
+    }
+
+    while (datomic_load(&counter->value, DATOMIC_ACQUIRE) > 0)
+    {
+        // Help out instead of blocking.
+        job_info job;
+        if (find_job(current_worker_index, &job))
+        {
+            run_job(&job);
+        }
+        else
+        {
+            platform_thread_yield();
+        }
+    }
+}
+
+u32 job_system_worker_count()
+{
+    return state_ptr ? state_ptr->worker_count : 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "defines.h"
+
+// The function a job runs on a worker thread.
+typedef void (*PFN_job_entry)(void *params);
+
+// Jobs of a higher priority are always picked up before lower ones.
+typedef enum job_priority
+{
+    JOB_PRIORITY_HIGH   = 0,
+    JOB_PRIORITY_NORMAL = 1,
+    JOB_PRIORITY_LOW    = 2,
+
+    JOB_PRIORITY_MAX
+} job_priority;
+
+/**
+ * @brief Tracks completion of a group of jobs. Incremented once per job on
+ * submission and decremented once the job has finished running. A counter
+ * should be zeroed before first use and must outlive all jobs submitted with it.
+ */
+typedef struct job_counter
+{
+    volatile s32 value;
+} job_counter;
+
+typedef struct job_info
+{
+    PFN_job_entry entry_point;
+    // Passed as-is to entry_point. The job system does not take a copy.
+    void *params;
+    job_priority priority;
+    // Optional. Can be 0/NULL.
+    job_counter *counter;
+} job_info;
+
+typedef struct job_system_config
+{
+    // The maximum number of worker threads. The actual count is one per core
+    // (minus the main thread), clamped to this value. Must be > 0.
+    u8 max_worker_count;
+    // The maximum number of queued jobs per worker and priority. Must be a power of 2.
+    u32 max_job_count;
+} job_system_config;
+
+b8 job_system_initialize(u64 *memory_requirement, void *state, job_system_config config);
+void job_system_shutdown(void *state);
+
+/**
+ * @brief Creates a new job. Does not submit it.
+ *
+ * @param entry_point The function to be run by the job. Required.
+ * @param params Data passed to entry_point. Must stay valid until the job has run.
+ * @param priority The priority of the job.
+ * @param counter An optional counter to track completion with. Can be 0/NULL.
+ * @return The populated job info.
+ */
+DAPI job_info job_create(PFN_job_entry entry_point, void *params, job_priority priority, job_counter *counter);
+
+/**
+ * @brief Submits the provided job to be run on a worker thread. Can be called from any thread.
+ * Jobs submitted from a worker go to that worker's own queue, where idle workers can steal them.
+ * If every queue is full, the job is run immediately on the calling thread instead.
+ *
+ * @param info The job to be submitted.
+ * @return True if the job was queued or run; false if the system is not running or info is invalid.
+ */
+DAPI b8 job_system_submit(job_info info);
+
+/**
+ * @brief Blocks until the counter reaches zero. The calling thread runs queued
+ * jobs while it waits rather than sitting idle.
+ *
+ * @param counter The counter to wait on.
+ */
+DAPI void job_system_wait(job_counter *counter);
+
+// Returns the number of worker threads currently running.
+DAPI u32 job_system_worker_count();
@@ -1,6 +1,7 @@
 #include "material_system.h"
 
 #include "containers/hashtable.h"
+#include "core/dmemory.h"
 #include "core/dstring.h"
 #include "core/logger.h"
 #include "math/dmath.h"
@@ -29,11 +30,47 @@ typedef struct material_reference
     b8 auto_release;
 } material_reference;
 
+// A material of a preload, from when its file is read until it is created.
+typedef struct material_preload_entry
+{
+    char name[MATERIAL_NAME_MAX_LENGTH];
+    material_config config;
+    b8 config_loaded;
+    b8 finished;
+    // The preload texture the material waits for, or INVALID_ID if none.
+    u32 texture_index;
+} material_preload_entry;
+
+// A texture a preload waits for, shared by all of its materials that use it.
+typedef struct material_preload_texture
+{
+    struct material_preload *preload;
+    char name[TEXTURE_NAME_MAX_LENGTH];
+    // If the preload holds a reference to the texture, released once the preload is finished.
+    b8 held;
+    b8 loaded;
+} material_preload_texture;
+
+typedef struct material_preload
+{
+    PFN_material_preload_progress callback;
+    void *user_data;
+    u32 material_count;
+    u32 finished_material_count;
+    u32 texture_count;
+    u32 loaded_texture_count;
+    material_preload_entry *materials;
+    // At most one per material, since materials only have a diffuse map.
+    material_preload_texture *textures;
+} material_preload;
+
 static material_system_state *state_ptr = 0;
 
 b8 create_default_material(material_system_state *state);
 b8 load_material(material_config config, material *m);
 void destroy_material(material *m);
+static void preload_material_loaded(b8 success, resource *material_resource, void *user_data);
+static void preload_texture_loaded(b8 success, texture *t, void *user_data);
 
 b8 material_system_initialize(u64 *memory_requirement, void *state, material_system_config config)
 {
@@ -221,6 +258,179 @@ material *material_system_acquire_from_config(material_config config)
     return 0;
 }
 
+b8 material_system_preload(u32 count, const char **names, PFN_material_preload_progress callback, void *user_data)
+{
+    if (!state_ptr || count == 0 || !names)
+    {
+        return false;
+    }
+
+    // One block holds the preload, then its materials, then its textures.
+    u64 size = sizeof(material_preload) + (sizeof(material_preload_entry) + sizeof(material_preload_texture)) * count;
+    material_preload *preload = dallocate(size, MEMORY_TAG_MATERIAL_INSTANCE);
+    preload->callback         = callback;
+    preload->user_data        = user_data;
+    preload->material_count   = count;
+    preload->materials        = (material_preload_entry *)(preload + 1);
+    preload->textures         = (material_preload_texture *)(preload->materials + count);
+    for (u32 i = 0; i < count; ++i)
+    {
+        string_ncopy(preload->materials[i].name, names[i], MATERIAL_NAME_MAX_LENGTH);
+        preload->materials[i].texture_index = INVALID_ID;
+    }
+
+    if (!resource_system_load_batch_async(count, names, RESOURCE_TYPE_MATERIAL, preload_material_loaded, preload))
+    {
+        DERROR("material_system_preload - Failed to start loading materials.");
+        dfree(preload, size, MEMORY_TAG_MATERIAL_INSTANCE);
+        return false;
+    }
+    return true;
+}
+
+// Creates a preloaded material, now that its textures are ready.
+static void preload_commit(material_preload *preload, material_preload_entry *entry)
+{
+    // Its textures are loaded, so acquiring them while creating the material only adds references. Loads
+    // completed as the engine shuts down have nothing left to create the material in.
+    if (state_ptr && !material_system_acquire_from_config(entry->config))
+    {
+        DERROR("Failed to create preloaded material '%s'.", entry->name);
+    }
+    entry->finished = true;
+    preload->finished_material_count++;
+}
+
+// Reports progress, and once every material is finished, drops the preload's own texture references
+// and frees it. The preload must not be used after this.
+static void preload_report(material_preload *preload)
+{
+    if (preload->callback)
+    {
+        preload->callback(preload->finished_material_count + preload->loaded_texture_count,
+                          preload->material_count + preload->texture_count, preload->user_data);
+    }
+
+    if (preload->finished_material_count < preload->material_count)
+    {
+        return;
+    }
+
+    for (u32 i = 0; i < preload->texture_count; ++i)
+    {
+        if (preload->textures[i].held)
+        {
+            texture_system_release(preload->textures[i].name);
+        }
+    }
+    u64 size = sizeof(material_preload) +
+               (sizeof(material_preload_entry) + sizeof(material_preload_texture)) * preload->material_count;
+    dfree(preload, size, MEMORY_TAG_MATERIAL_INSTANCE);
+}
+
+static void preload_material_loaded(b8 success, resource *material_resource, void *user_data)
+{
+    material_preload *preload     = user_data;
+    material_preload_entry *entry = 0;
+    for (u32 i = 0; i < preload->material_count; ++i)
+    {
+        if (!preload->materials[i].config_loaded &&
+            strings_equali(preload->materials[i].name, material_resource->name))
+        {
+            entry = &preload->materials[i];
+            break;
+        }
+    }
+    if (!entry)
+    {
+        // Cannot happen, since each name gets exactly one result.
+        if (success)
+        {
+            resource_system_unload(material_resource);
+        }
+        return;
+    }
+
+    entry->config_loaded = true;
+    if (!success)
+    {
+        DERROR("Failed to load material resource '%s'.", entry->name);
+        entry->finished = true;
+        preload->finished_material_count++;
+        preload_report(preload);
+        return;
+    }
+    entry->config = *(material_config *)material_resource->data;
+    resource_system_unload(material_resource);
+
+    // Nothing to wait for if the material has no texture, or already exists.
+    material_reference ref;
+    hashtable_get(&state_ptr->registered_material_table, entry->config.name, &ref);
+    if (string_length(entry->config.diffuse_map_name) == 0 || ref.handle != INVALID_ID)
+    {
+        preload_commit(preload, entry);
+        preload_report(preload);
+        return;
+    }
+
+    // Wait on the texture if another material of the preload has asked for it already.
+    for (u32 i = 0; i < preload->texture_count; ++i)
+    {
+        if (strings_equali(preload->textures[i].name, entry->config.diffuse_map_name))
+        {
+            if (preload->textures[i].loaded)
+            {
+                preload_commit(preload, entry);
+                preload_report(preload);
+            }
+            else
+            {
+                entry->texture_index = i;
+            }
+            return;
+        }
+    }
+
+    u32 index                         = preload->texture_count++;
+    material_preload_texture *waiting = &preload->textures[index];
+    waiting->preload                  = preload;
+    waiting->held                     = true;
+    string_ncopy(waiting->name, entry->config.diffuse_map_name, TEXTURE_NAME_MAX_LENGTH);
+    entry->texture_index = index;
+
+    // Reports progress, possibly before returning if the texture is already loaded, so the preload must
+    // not be touched afterwards.
+    if (!texture_system_acquire_async_notify(waiting->name, true, preload_texture_loaded, waiting))
+    {
+        // Creating the material falls back to the default texture.
+        waiting->held = false;
+        preload_texture_loaded(false, 0, waiting);
+    }
+}
+
+static void preload_texture_loaded(b8 success, texture *t, void *user_data)
+{
+    material_preload_texture *waiting = user_data;
+    material_preload *preload         = waiting->preload;
+    waiting->loaded                   = true;
+    preload->loaded_texture_count++;
+    if (!success)
+    {
+        DWARN("Unable to load texture '%s' for preloaded materials, using default.", waiting->name);
+    }
+
+    u32 index = (u32)(waiting - preload->textures);
+    for (u32 i = 0; i < preload->material_count; ++i)
+    {
+        material_preload_entry *entry = &preload->materials[i];
+        if (!entry->finished && entry->texture_index == index)
+        {
+            preload_commit(preload, entry);
+        }
+    }
+    preload_report(preload);
+}
+
 void material_system_release(const char *name)
 {
     // Ignore release requests for the default material.
@@ -264,6 +474,60 @@ void material_system_release(const char *name)
     }
 }
 
+b8 material_system_reload(const char *name)
+{
+    material_reference ref;
+    if (!state_ptr || !hashtable_get(&state_ptr->registered_material_table, name, &ref) || ref.handle == INVALID_ID)
+    {
+        // Not loaded, so the next acquire reads the new file anyway.
+        return false;
+    }
+
+    resource material_resource;
+    if (!resource_system_load(name, RESOURCE_TYPE_MATERIAL, &material_resource))
+    {
+        DERROR("Failed to reload material '%s'; keeping the current one.", name);
+        return false;
+    }
+
+    material_config *config = material_resource.data;
+    material *m             = &state_ptr->registered_materials[ref.handle];
+    m->diffuse_colour       = config->diffuse_colour;
+
+    // Swap the diffuse map only if it changed, acquiring the new one before releasing the old.
+    texture *old_texture = m->diffuse_map.texture;
+    if (string_length(config->diffuse_map_name) > 0)
+    {
+        if (!old_texture || !strings_equali(old_texture->name, config->diffuse_map_name))
+        {
+            m->diffuse_map.use     = TEXTURE_USE_MAP_DIFFUSE;
+            m->diffuse_map.texture = texture_system_acquire(config->diffuse_map_name, true);
+            if (!m->diffuse_map.texture)
+            {
+                DWARN("Unable to load texture '%s' for material '%s', using default.", config->diffuse_map_name,
+                      m->name);
+                m->diffuse_map.texture = texture_system_get_default_texture();
+            }
+            if (old_texture)
+            {
+                texture_system_release(old_texture->name);
+            }
+        }
+    }
+    else if (old_texture)
+    {
+        m->diffuse_map.use     = TEXTURE_USE_UNKNOWN;
+        m->diffuse_map.texture = 0;
+        texture_system_release(old_texture->name);
+    }
+
+    m->generation = m->generation == INVALID_ID ? 0 : m->generation + 1;
+    resource_system_unload(&material_resource);
+
+    DDEBUG("Reloaded material '%s'.", name);
+    return true;
+}
+
 material *material_system_get_default()
 {
     if (state_ptr)
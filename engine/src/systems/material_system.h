@@ -16,6 +16,37 @@ void material_system_shutdown(void *state);
 
 material *material_system_acquire(const char *name);
 material *material_system_acquire_from_config(material_config config);
+
+/**
+ * @brief Invoked on the main thread as a preload progresses. completed counts the materials and textures
+ * finished so far, whether or not they loaded, out of total. total grows as materials name their textures,
+ * and the preload is finished once completed reaches it.
+ */
+typedef void (*PFN_material_preload_progress)(u32 completed, u32 total, void *user_data);
+
+/**
+ * @brief Loads several materials and their textures in the background. The material files are read in one
+ * batch, and each texture starts loading as soon as a material naming it has been read, so the textures of
+ * the whole set decode in parallel. A material is created only once its textures are uploaded, so it is never
+ * drawn with placeholders. Each material that loads holds a reference, as if acquired, which the caller
+ * releases with material_system_release. Must be called from the main thread.
+ *
+ * @param count The number of materials to load.
+ * @param names The names of the materials to load. Copied, so they need not outlive the call.
+ * @param callback Invoked from resource_system_pump_completions as each material or texture finishes. Can be 0/NULL.
+ * @param user_data Passed as-is to callback. Can be 0/NULL.
+ * @return True if the preload was started; otherwise false, in which case callback is never invoked.
+ */
+b8 material_system_preload(u32 count, const char **names, PFN_material_preload_progress callback, void *user_data);
 void material_system_release(const char *name);
 
+/**
+ * @brief Reloads a loaded material's configuration from its file, updating the material in place.
+ * Its generation is bumped so the renderer picks up the change.
+ *
+ * @param name The name of the material to reload.
+ * @return True if reloaded; false if the material is not loaded or its file could not be loaded.
+ */
+b8 material_system_reload(const char *name);
+
 material *material_system_get_default();
@@ -1,18 +1,94 @@
 #include "resource_system.h"
 
+#include "core/datomic.h"
+#include "core/dmemory.h"
 #include "core/dstring.h"
 #include "core/logger.h"
+#include "platform/filesystem.h"
+#include "platform/platform.h"
+#include "resources/resource_pack.h"
+#include "systems/job_system.h"
+
+#include <string.h> // memcmp
 
 // Known resource loaders.
 #include "resources/loaders/binary_loader.h"
 #include "resources/loaders/image_loader.h"
 #include "resources/loaders/material_loader.h"
+#include "resources/loaders/mesh_loader.h"
 #include "resources/loaders/text_loader.h"
 
+// An in-flight asynchronous load. Owned by the job until completed, then by the completion queue.
+typedef struct resource_load_request
+{
+    char *name;
+    resource_loader *loader;
+    resource resource;
+    b8 success;
+    PFN_resource_loaded callback;
+    void *user_data;
+    // The path of the file found by a batch, handed to load_from_memory.
+    char file_path[512];
+    // Set when the file was already read by a batch, or found in a pack.
+    const void *file_data;
+    u64 file_data_size;
+    // True if file_data was allocated by the batch, and must be freed once loaded.
+    b8 owns_file_data;
+    struct resource_load_request *next;
+} resource_load_request;
+
+// Loads whose files are read together, before each is handed to its own load job.
+typedef struct resource_batch_request
+{
+    u32 count;
+    resource_load_request **requests;
+} resource_batch_request;
+
+// A decoded resource kept for later loads to share. Free when name is 0.
+typedef struct resource_cache_entry
+{
+    char *name;
+    u64 hash;
+    u32 loader_id;
+    resource resource;
+    u64 memory_size;
+    // The number of loads that have not been unloaded yet. Only unreferenced entries are evicted.
+    u32 reference_count;
+    // The cache clock when last loaded. Lower values were used less recently.
+    u64 last_used;
+    // Set when evicted while still referenced. No longer found by loads, and freed once unreferenced.
+    b8 stale;
+} resource_cache_entry;
+
 typedef struct resource_system_state
 {
     resource_system_config config;
     resource_loader *registered_loaders;
+    // The loader of each type other than RESOURCE_TYPE_CUSTOM, or 0 if there is none.
+    resource_loader *type_loaders[RESOURCE_TYPE_CUSTOM];
+    // Custom loaders, in an open-addressed hash table keyed by custom_type_hash. Empty slots are 0.
+    resource_loader **custom_loaders;
+    u32 custom_slot_count;
+
+    // Loads finished on workers, waiting for the main thread to invoke their callbacks.
+    platform_mutex completed_mutex;
+    resource_load_request *completed_head;
+    resource_load_request *completed_tail;
+
+    // Searched from the last mounted to the first.
+    resource_pack packs[RESOURCE_MAX_PACKS];
+    u32 pack_count;
+
+    // Hashes of the pack paths of files to read from disk instead. Only appended to, by the main
+    // thread, so workers can read it without locking.
+    u64 loose_file_hashes[RESOURCE_MAX_LOOSE_FILES];
+    u32 loose_file_count;
+
+    // Decoded resources, shared by loads of the same name and type.
+    platform_mutex cache_mutex;
+    resource_cache_entry cache[RESOURCE_CACHE_MAX_ENTRIES];
+    u64 cache_size;
+    u64 cache_clock;
 } resource_system_state;
 
 static resource_system_state *state_ptr = 0;
@@ -27,7 +103,15 @@ b8 resource_system_initialize(u64 *memory_requirement, void *state, resource_sys
         return false;
     }
 
-    *memory_requirement = sizeof(resource_system_state) + (sizeof(resource_loader) * config.max_loader_count);
+    // Keep the custom loader table at most half full, so probe sequences stay short.
+    u32 custom_slot_count = 16;
+    while (custom_slot_count < config.max_loader_count * 2)
+    {
+        custom_slot_count *= 2;
+    }
+
+    u64 loaders_size    = sizeof(resource_loader) * config.max_loader_count;
+    *memory_requirement = sizeof(resource_system_state) + loaders_size + sizeof(resource_loader *) * custom_slot_count;
 
     if (!state)
     {
@@ -39,6 +123,23 @@ b8 resource_system_initialize(u64 *memory_requirement, void *state, resource_sys
 
     void *array_block             = state + sizeof(resource_system_state);
     state_ptr->registered_loaders = array_block;
+    state_ptr->custom_loaders     = array_block + loaders_size;
+    state_ptr->custom_slot_count  = custom_slot_count;
+    dzero_memory(state_ptr->type_loaders, sizeof(state_ptr->type_loaders));
+    dzero_memory(state_ptr->custom_loaders, sizeof(resource_loader *) * custom_slot_count);
+
+    state_ptr->completed_head   = 0;
+    state_ptr->completed_tail   = 0;
+    state_ptr->pack_count       = 0;
+    state_ptr->loose_file_count = 0;
+    state_ptr->cache_size       = 0;
+    state_ptr->cache_clock      = 0;
+    dzero_memory(state_ptr->cache, sizeof(state_ptr->cache));
+    if (!platform_mutex_create(&state_ptr->completed_mutex) || !platform_mutex_create(&state_ptr->cache_mutex))
+    {
+        DFATAL("resource_system_initialize - Failed to create mutexes.");
+        return false;
+    }
 
     // Invalidate all loaders
     u32 count = config.max_loader_count;
@@ -52,100 +153,668 @@ b8 resource_system_initialize(u64 *memory_requirement, void *state, resource_sys
     resource_system_register_loader(binary_resource_loader_create());
     resource_system_register_loader(image_resource_loader_create());
     resource_system_register_loader(material_resource_loader_create());
+    resource_system_register_loader(mesh_resource_loader_create());
 
     DINFO("Resource system initialized with base path '%s'.", config.asset_base_path);
 
     return true;
 }
 
-void resource_system_shutdown(void *state)
+// Has the loader release what it holds outside the resource's arena, such as mappings, then frees the arena.
+static void unload_resource(resource_loader *loader, resource *resource)
 {
-    if (state_ptr)
+    if (loader->unload)
     {
-        state_ptr = 0;
+        loader->unload(loader, resource);
     }
+    linear_allocator_destroy(&resource->arena);
+    resource->full_path = 0;
 }
 
-b8 resource_system_register_loader(resource_loader loader)
+// Frees a cache entry's resource. Called with the cache mutex held.
+static void cache_free_entry(resource_cache_entry *entry)
+{
+    unload_resource(&state_ptr->registered_loaders[entry->loader_id], &entry->resource);
+    state_ptr->cache_size -= entry->memory_size;
+    dfree(entry->name, string_length(entry->name) + 1, MEMORY_TAG_STRING);
+    dzero_memory(entry, sizeof(resource_cache_entry));
+}
+
+// Frees the least recently used unreferenced entry. Called with the cache mutex held.
+static b8 cache_evict_oldest()
+{
+    resource_cache_entry *oldest = 0;
+    for (u32 i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i)
+    {
+        resource_cache_entry *entry = &state_ptr->cache[i];
+        if (entry->name && entry->reference_count == 0 && (!oldest || entry->last_used < oldest->last_used))
+        {
+            oldest = entry;
+        }
+    }
+    if (!oldest)
+    {
+        return false;
+    }
+    cache_free_entry(oldest);
+    return true;
+}
+
+// Evicts unreferenced entries until the cache fits its budget. Called with the cache mutex held.
+static void cache_trim()
+{
+    while (state_ptr->cache_size > state_ptr->config.cache_budget)
+    {
+        if (!cache_evict_oldest())
+        {
+            // Everything left is in use.
+            break;
+        }
+    }
+}
+
+// Gets an unused entry, evicting one if they are all taken. Called with the cache mutex held.
+static resource_cache_entry *cache_free_slot()
+{
+    for (u32 i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i)
+    {
+        if (!state_ptr->cache[i].name)
+        {
+            return &state_ptr->cache[i];
+        }
+    }
+    if (!cache_evict_oldest())
+    {
+        return 0;
+    }
+    return cache_free_slot();
+}
+
+// Called with the cache mutex held.
+static resource_cache_entry *cache_find(u32 loader_id, const char *name, u64 hash)
+{
+    for (u32 i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i)
+    {
+        resource_cache_entry *entry = &state_ptr->cache[i];
+        if (entry->name && !entry->stale && entry->hash == hash && entry->loader_id == loader_id &&
+            strings_equal(entry->name, name))
+        {
+            return entry;
+        }
+    }
+    return 0;
+}
+
+static b8 is_cached(const resource_loader *loader)
+{
+    return state_ptr->config.cache_budget != 0 && loader->memory_size != 0;
+}
+
+// Shares a cached resource with a load. Returns false if it is not cached.
+static b8 cache_acquire(resource_loader *loader, const char *name, resource *out_resource)
+{
+    if (!is_cached(loader))
+    {
+        return false;
+    }
+
+    u64 hash = resource_pack_hash(name, string_length(name));
+    platform_mutex_lock(&state_ptr->cache_mutex);
+    resource_cache_entry *entry = cache_find(loader->id, name, hash);
+    if (entry)
+    {
+        entry->reference_count++;
+        entry->last_used   = ++state_ptr->cache_clock;
+        *out_resource      = entry->resource;
+        out_resource->name = name;
+    }
+    platform_mutex_unlock(&state_ptr->cache_mutex);
+    return entry != 0;
+}
+
+// Caches a freshly loaded resource, counting the load as its first reference. It is left uncached
+// if it cannot fit, or if another thread cached the same resource first.
+static void cache_insert(resource_loader *loader, const char *name, const resource *loaded)
+{
+    if (!is_cached(loader) || !loaded->data)
+    {
+        return;
+    }
+
+    u64 budget      = state_ptr->config.cache_budget;
+    u64 memory_size = loader->memory_size(loader, loaded);
+    if (memory_size > budget)
+    {
+        return;
+    }
+
+    u64 hash = resource_pack_hash(name, string_length(name));
+    platform_mutex_lock(&state_ptr->cache_mutex);
+    resource_cache_entry *entry = cache_find(loader->id, name, hash) ? 0 : cache_free_slot();
+    if (entry)
+    {
+        entry->name            = string_duplicate(name);
+        entry->hash            = hash;
+        entry->loader_id       = loader->id;
+        entry->resource        = *loaded;
+        entry->resource.name   = entry->name;
+        entry->memory_size     = memory_size;
+        entry->reference_count = 1;
+        entry->last_used       = ++state_ptr->cache_clock;
+        entry->stale           = false;
+        state_ptr->cache_size += memory_size;
+        cache_trim();
+    }
+    platform_mutex_unlock(&state_ptr->cache_mutex);
+}
+
+// Drops a load's reference to its cached resource. Returns false if the resource is not cached.
+static b8 cache_release(resource *resource)
+{
+    if (!state_ptr->config.cache_budget || !resource->data)
+    {
+        return false;
+    }
+
+    platform_mutex_lock(&state_ptr->cache_mutex);
+    resource_cache_entry *entry = 0;
+    for (u32 i = 0; i < RESOURCE_CACHE_MAX_ENTRIES && !entry; ++i)
+    {
+        resource_cache_entry *e = &state_ptr->cache[i];
+        entry                   = e->name && e->resource.data == resource->data ? e : 0;
+    }
+    if (entry && entry->reference_count > 0 && --entry->reference_count == 0)
+    {
+        if (entry->stale)
+        {
+            cache_free_entry(entry);
+        }
+        else
+        {
+            // Unreferenced entries only stay while everything fits.
+            cache_trim();
+        }
+    }
+    platform_mutex_unlock(&state_ptr->cache_mutex);
+
+    if (!entry)
+    {
+        return false;
+    }
+    // The cache entry holds the only copy that owns the data and arena.
+    resource->data      = 0;
+    resource->data_size = 0;
+    resource->loader_id = INVALID_ID;
+    resource->full_path = 0;
+    dzero_memory(&resource->arena, sizeof(linear_allocator));
+    return true;
+}
+
+static void free_load_request(resource_load_request *request)
+{
+    dfree(request->name, string_length(request->name) + 1, MEMORY_TAG_STRING);
+    dfree(request, sizeof(resource_load_request), MEMORY_TAG_JOB);
+}
+
+void resource_system_shutdown(void *state)
 {
     if (state_ptr)
     {
-        u32 count = state_ptr->config.max_loader_count;
-        // Ensure no loaders for the given type already exist
-        for (u32 i = 0; i < count; ++i)
+        // Anything never pumped fails, so callers can free what they passed as user_data. The job system
+        // has already drained by now.
+        resource_load_request *request = state_ptr->completed_head;
+        state_ptr->completed_head      = 0;
+        state_ptr->completed_tail      = 0;
+        while (request)
         {
-            resource_loader *l = &state_ptr->registered_loaders[i];
-            if (l->id != INVALID_ID)
+            resource_load_request *next = request->next;
+            if (request->success)
             {
-                if (l->type == loader.type)
-                {
-                    DERROR("resource_system_register_loader - Loader of type %d already exists and will not be "
-                           "registered.",
-                           loader.type);
-                    return false;
-                }
-                else if (loader.custom_type && string_length(loader.custom_type) > 0 &&
-                         strings_equali(l->custom_type, loader.custom_type))
-                {
-                    DERROR("resource_system_register_loader - Loader of custom type %s already exists and will not be "
-                           "registered.",
-                           loader.custom_type);
-                    return false;
-                }
+                resource_system_unload(&request->resource);
+                request->resource.name = request->name;
             }
+            request->callback(false, &request->resource, request->user_data);
+            free_load_request(request);
+            request = next;
         }
-        for (u32 i = 0; i < count; ++i)
+        platform_mutex_destroy(&state_ptr->completed_mutex);
+
+        for (u32 i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i)
         {
-            if (state_ptr->registered_loaders[i].id == INVALID_ID)
+            if (state_ptr->cache[i].name)
             {
-                state_ptr->registered_loaders[i]    = loader;
-                state_ptr->registered_loaders[i].id = i;
-                DTRACE("Loader registered.");
-                return true;
+                cache_free_entry(&state_ptr->cache[i]);
             }
         }
+        platform_mutex_destroy(&state_ptr->cache_mutex);
+
+        for (u32 i = 0; i < state_ptr->pack_count; ++i)
+        {
+            resource_pack_close(&state_ptr->packs[i]);
+        }
+        state_ptr->pack_count = 0;
+
+        state_ptr = 0;
     }
+}
 
-    return false;
+// Hashes a custom type ignoring case, since custom types are matched that way.
+static u64 custom_type_hash(const char *custom_type)
+{
+    // 64-bit FNV-1a.
+    u64 hash = 0xcbf29ce484222325ull;
+    for (const char *c = custom_type; *c; ++c)
+    {
+        hash ^= (u8)(*c >= 'A' && *c <= 'Z' ? *c - 'A' + 'a' : *c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
 }
 
-b8 resource_system_load(const char *name, resource_type type, resource *out_resource)
+// Gets the slot in the custom loader table that holds custom_type, or the empty slot where it would go.
+static resource_loader **custom_loader_slot(const char *custom_type)
 {
-    if (state_ptr && type != RESOURCE_TYPE_CUSTOM)
+    resource_loader **slots = state_ptr->custom_loaders;
+    u32 mask                = state_ptr->custom_slot_count - 1;
+    u32 slot                = custom_type_hash(custom_type) & mask;
+    while (slots[slot] && !strings_equali(slots[slot]->custom_type, custom_type))
     {
-        // Select loader.
-        u32 count = state_ptr->config.max_loader_count;
-        for (u32 i = 0; i < count; ++i)
+        slot = (slot + 1) & mask;
+    }
+    return &slots[slot];
+}
+
+static resource_loader *find_loader(resource_type type)
+{
+    return (u32)type < RESOURCE_TYPE_CUSTOM ? state_ptr->type_loaders[type] : 0;
+}
+
+static resource_loader *find_custom_loader(const char *custom_type)
+{
+    return custom_type && string_length(custom_type) > 0 ? *custom_loader_slot(custom_type) : 0;
+}
+
+b8 resource_system_register_loader(resource_loader loader)
+{
+    if (!state_ptr)
+    {
+        return false;
+    }
+
+    if (loader.extension_count == 0 || loader.extension_count > RESOURCE_LOADER_MAX_EXTENSIONS)
+    {
+        DERROR("resource_system_register_loader - Loaders need between 1 and %i extensions.",
+               RESOURCE_LOADER_MAX_EXTENSIONS);
+        return false;
+    }
+
+    // Ensure no loaders for the given type already exist
+    if (loader.type == RESOURCE_TYPE_CUSTOM)
+    {
+        if (!loader.custom_type || string_length(loader.custom_type) == 0)
+        {
+            DERROR("resource_system_register_loader - Custom loaders need a custom type.");
+            return false;
+        }
+        if (find_custom_loader(loader.custom_type))
+        {
+            DERROR("resource_system_register_loader - Loader of custom type %s already exists and will not be "
+                   "registered.",
+                   loader.custom_type);
+            return false;
+        }
+    }
+    else if ((u32)loader.type > RESOURCE_TYPE_CUSTOM)
+    {
+        DERROR("resource_system_register_loader - Unknown resource type %d.", loader.type);
+        return false;
+    }
+    else if (find_loader(loader.type))
+    {
+        DERROR("resource_system_register_loader - Loader of type %d already exists and will not be registered.",
+               loader.type);
+        return false;
+    }
+
+    u32 count = state_ptr->config.max_loader_count;
+    for (u32 i = 0; i < count; ++i)
+    {
+        resource_loader *l = &state_ptr->registered_loaders[i];
+        if (l->id == INVALID_ID)
         {
-            resource_loader *l = &state_ptr->registered_loaders[i];
-            if (l->id != INVALID_ID && l->type == type)
+            *l    = loader;
+            l->id = i;
+            if (loader.type == RESOURCE_TYPE_CUSTOM)
+            {
+                *custom_loader_slot(loader.custom_type) = l;
+            }
+            else
             {
-                return load(name, l, out_resource);
+                state_ptr->type_loaders[loader.type] = l;
             }
+            DTRACE("Loader registered.");
+            return true;
         }
     }
 
+    DERROR("resource_system_register_loader - All %i loader slots are taken.", count);
+    return false;
+}
+
+b8 resource_system_load(const char *name, resource_type type, resource *out_resource)
+{
+    resource_loader *loader = state_ptr ? find_loader(type) : 0;
+    if (loader)
+    {
+        return load(name, loader, out_resource);
+    }
+
     out_resource->loader_id = INVALID_ID;
     DERROR("resource_system_load - No loader for type %d was found.", type);
     return false;
 }
 
-b8 resource_system_load_custom(const char *name, const char *custom_type, resource *out_resource)
+// Queues a finished load for resource_system_pump_completions.
+static void complete_load_request(resource_load_request *request)
 {
-    if (state_ptr && custom_type && string_length(custom_type) > 0)
+    request->next = 0;
+
+    platform_mutex_lock(&state_ptr->completed_mutex);
+    if (state_ptr->completed_tail)
     {
-        // Select loader.
-        u32 count = state_ptr->config.max_loader_count;
-        for (u32 i = 0; i < count; ++i)
+        state_ptr->completed_tail->next = request;
+    }
+    else
+    {
+        state_ptr->completed_head = request;
+    }
+    state_ptr->completed_tail = request;
+    platform_mutex_unlock(&state_ptr->completed_mutex);
+}
+
+static void resource_load_job(void *params)
+{
+    resource_load_request *request = params;
+    if (request->file_data)
+    {
+        request->resource.loader_id = request->loader->id;
+        dzero_memory(&request->resource.arena, sizeof(linear_allocator));
+        request->success = request->loader->load_from_memory(request->loader, request->name, request->file_path,
+                                                             request->file_data, request->file_data_size,
+                                                             &request->resource);
+        if (request->owns_file_data)
+        {
+            dfree((void *)request->file_data, request->file_data_size, MEMORY_TAG_ARRAY);
+        }
+        request->file_data = 0;
+        if (request->success)
         {
-            resource_loader *l = &state_ptr->registered_loaders[i];
-            if (l->id != INVALID_ID && l->type == RESOURCE_TYPE_CUSTOM && strings_equali(l->custom_type, custom_type))
+            cache_insert(request->loader, request->name, &request->resource);
+        }
+        else
+        {
+            linear_allocator_destroy(&request->resource.arena);
+        }
+    }
+    else
+    {
+        request->success = load(request->name, request->loader, &request->resource);
+    }
+    complete_load_request(request);
+}
+
+// Gets a file's path within a pack, which is its path relative to the asset base path.
+static const char *pack_entry_path(const char *full_file_path)
+{
+    const char *base_path = state_ptr->config.asset_base_path;
+    u64 base_length       = string_length(base_path);
+    if (string_length(full_file_path) <= base_length || memcmp(full_file_path, base_path, base_length) != 0 ||
+        full_file_path[base_length] != '/')
+    {
+        return 0;
+    }
+    return full_file_path + base_length + 1;
+}
+
+// Looks a file up in the mounted packs, unless it is to be read from disk.
+static b8 find_in_packs(const char *full_file_path, file_mapping *out_view)
+{
+    if (!state_ptr || state_ptr->pack_count == 0)
+    {
+        return false;
+    }
+
+    const char *entry_path = pack_entry_path(full_file_path);
+    if (!entry_path)
+    {
+        return false;
+    }
+
+    u32 loose_file_count = datomic_load(&state_ptr->loose_file_count, DATOMIC_ACQUIRE);
+    if (loose_file_count)
+    {
+        u64 hash = resource_pack_hash(entry_path, string_length(entry_path));
+        for (u32 i = 0; i < loose_file_count; ++i)
+        {
+            if (state_ptr->loose_file_hashes[i] == hash)
             {
-                return load(name, l, out_resource);
+                return false;
             }
         }
     }
 
+    for (u32 i = state_ptr->pack_count; i > 0; --i)
+    {
+        if (resource_pack_find(&state_ptr->packs[i - 1], entry_path, out_view))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static resource_load_request *create_load_request(const char *name, resource_loader *loader,
+                                                  PFN_resource_loaded callback, void *user_data)
+{
+    resource_load_request *request = dallocate(sizeof(resource_load_request), MEMORY_TAG_JOB);
+    request->name                  = string_duplicate(name);
+    request->loader                = loader;
+    request->callback              = callback;
+    request->user_data             = user_data;
+    request->file_path[0]          = 0;
+    request->file_data             = 0;
+    request->file_data_size        = 0;
+    request->owns_file_data        = false;
+    request->resource.loader_id    = INVALID_ID;
+    request->resource.name         = request->name;
+    return request;
+}
+
+static void submit_load_request(resource_load_request *request)
+{
+    if (!job_system_submit(job_create(resource_load_job, request, JOB_PRIORITY_NORMAL, 0)))
+    {
+        // No workers available; load here and still complete through the pump.
+        DWARN("resource_system - Job submission failed, loading '%s' synchronously.", request->name);
+        resource_load_job(request);
+    }
+}
+
+static void resource_batch_read_job(void *params)
+{
+    resource_batch_request *batch = params;
+
+    // Cached resources need no file at all. Files found in a pack are used in place; only loose files need reading.
+    file_read_request *reads = dallocate(sizeof(file_read_request) * batch->count, MEMORY_TAG_JOB);
+    u32 *read_indices        = dallocate(sizeof(u32) * batch->count, MEMORY_TAG_JOB);
+    u32 read_count           = 0;
+    for (u32 i = 0; i < batch->count; ++i)
+    {
+        resource_load_request *request = batch->requests[i];
+        if (cache_acquire(request->loader, request->name, &request->resource))
+        {
+            request->success = true;
+            continue;
+        }
+
+        if (resource_system_find_file(request->loader, request->name, request->file_path) == INVALID_ID)
+        {
+            continue;
+        }
+
+        file_mapping view;
+        if (find_in_packs(request->file_path, &view) && view.data)
+        {
+            request->file_data      = view.data;
+            request->file_data_size = view.size;
+            continue;
+        }
+
+        read_indices[read_count]      = i;
+        reads[read_count].path        = request->file_path;
+        reads[read_count].buffer      = 0;
+        reads[read_count].buffer_size = 0;
+        read_count++;
+    }
+
+    if (read_count)
+    {
+        filesystem_read_batch(read_count, reads);
+    }
+    for (u32 r = 0; r < read_count; ++r)
+    {
+        resource_load_request *request = batch->requests[read_indices[r]];
+        if (reads[r].success && reads[r].buffer)
+        {
+            request->file_data      = reads[r].buffer;
+            request->file_data_size = reads[r].buffer_size;
+            request->owns_file_data = true;
+        }
+        else if (reads[r].buffer)
+        {
+            dfree(reads[r].buffer, reads[r].buffer_size, MEMORY_TAG_ARRAY);
+        }
+    }
+
+    // Hand each file to its own job to be parsed or decoded.
+    for (u32 i = 0; i < batch->count; ++i)
+    {
+        resource_load_request *request = batch->requests[i];
+        if (request->success)
+        {
+            complete_load_request(request);
+            continue;
+        }
+        // Anything that could not be read goes through the regular load, which reports why.
+        submit_load_request(request);
+    }
+
+    dfree(read_indices, sizeof(u32) * batch->count, MEMORY_TAG_JOB);
+    dfree(reads, sizeof(file_read_request) * batch->count, MEMORY_TAG_JOB);
+    dfree(batch->requests, sizeof(resource_load_request *) * batch->count, MEMORY_TAG_JOB);
+    dfree(batch, sizeof(resource_batch_request), MEMORY_TAG_JOB);
+}
+
+b8 resource_system_load_async(const char *name, resource_type type, PFN_resource_loaded callback, void *user_data)
+{
+    if (!state_ptr || !name || !callback || type == RESOURCE_TYPE_CUSTOM)
+    {
+        DERROR("resource_system_load_async requires a name, callback and non-custom type.");
+        return false;
+    }
+
+    resource_loader *loader = find_loader(type);
+    if (!loader)
+    {
+        DERROR("resource_system_load_async - No loader for type %d was found.", type);
+        return false;
+    }
+
+    submit_load_request(create_load_request(name, loader, callback, user_data));
+    return true;
+}
+
+b8 resource_system_load_batch_async(u32 count, const char **names, resource_type type, PFN_resource_loaded callback,
+                                    void *user_data)
+{
+    if (!state_ptr || !names || !callback || type == RESOURCE_TYPE_CUSTOM)
+    {
+        DERROR("resource_system_load_batch_async requires names, a callback and a non-custom type.");
+        return false;
+    }
+
+    resource_loader *loader = find_loader(type);
+    if (!loader)
+    {
+        DERROR("resource_system_load_batch_async - No loader for type %d was found.", type);
+        return false;
+    }
+    if (count == 0)
+    {
+        return true;
+    }
+
+    if (!loader->load_from_memory)
+    {
+        // The loader reads its own files, so there is nothing to batch.
+        for (u32 i = 0; i < count; ++i)
+        {
+            submit_load_request(create_load_request(names[i], loader, callback, user_data));
+        }
+        return true;
+    }
+
+    resource_batch_request *batch = dallocate(sizeof(resource_batch_request), MEMORY_TAG_JOB);
+    batch->count                  = count;
+    batch->requests               = dallocate(sizeof(resource_load_request *) * count, MEMORY_TAG_JOB);
+    for (u32 i = 0; i < count; ++i)
+    {
+        batch->requests[i] = create_load_request(names[i], loader, callback, user_data);
+    }
+
+    if (!job_system_submit(job_create(resource_batch_read_job, batch, JOB_PRIORITY_NORMAL, 0)))
+    {
+        DWARN("resource_system_load_batch_async - Job submission failed, reading files synchronously.");
+        resource_batch_read_job(batch);
+    }
+    return true;
+}
+
+void resource_system_pump_completions()
+{
+    if (!state_ptr)
+    {
+        return;
+    }
+
+    // Take the whole list at once so workers aren't blocked while callbacks run.
+    platform_mutex_lock(&state_ptr->completed_mutex);
+    resource_load_request *request = state_ptr->completed_head;
+    state_ptr->completed_head      = 0;
+    state_ptr->completed_tail      = 0;
+    platform_mutex_unlock(&state_ptr->completed_mutex);
+
+    while (request)
+    {
+        resource_load_request *next = request->next;
+        if (!request->success)
+        {
+            DERROR("resource_system_pump_completions - Asynchronous load of '%s' failed.", request->name);
+        }
+        request->callback(request->success, &request->resource, request->user_data);
+        free_load_request(request);
+        request = next;
+    }
+}
+
+b8 resource_system_load_custom(const char *name, const char *custom_type, resource *out_resource)
+{
+    resource_loader *loader = state_ptr ? find_custom_loader(custom_type) : 0;
+    if (loader)
+    {
+        return load(name, loader, out_resource);
+    }
+
     out_resource->loader_id = INVALID_ID;
     DERROR("resource_system_load_custom - No loader for type %s was found.", custom_type);
     return false;
@@ -153,19 +822,40 @@ b8 resource_system_load_custom(const char *name, const char *custom_type, resour
 
 void resource_system_unload(resource *resource)
 {
-    if (state_ptr && resource)
+    if (state_ptr && resource && !cache_release(resource))
     {
         if (resource->loader_id != INVALID_ID)
         {
             resource_loader *l = &state_ptr->registered_loaders[resource->loader_id];
-            if (l->id != INVALID_ID && l->unload)
+            if (l->id != INVALID_ID)
             {
-                l->unload(l, resource);
+                unload_resource(l, resource);
             }
         }
     }
 }
 
+void resource_system_evict(const char *name, resource_type type)
+{
+    resource_loader *loader = state_ptr && name ? find_loader(type) : 0;
+    if (!loader || !is_cached(loader))
+    {
+        return;
+    }
+
+    platform_mutex_lock(&state_ptr->cache_mutex);
+    resource_cache_entry *entry = cache_find(loader->id, name, resource_pack_hash(name, string_length(name)));
+    if (entry && entry->reference_count == 0)
+    {
+        cache_free_entry(entry);
+    }
+    else if (entry)
+    {
+        entry->stale = true;
+    }
+    platform_mutex_unlock(&state_ptr->cache_mutex);
+}
+
 const char *resource_system_base_path()
 {
     if (state_ptr)
@@ -177,6 +867,129 @@ const char *resource_system_base_path()
     return "";
 }
 
+b8 resource_system_mount_pack(const char *path)
+{
+    if (!state_ptr || !path)
+    {
+        return false;
+    }
+
+    if (state_ptr->pack_count >= RESOURCE_MAX_PACKS)
+    {
+        DERROR("resource_system_mount_pack - Cannot mount '%s'; %i packs are already mounted.", path,
+               RESOURCE_MAX_PACKS);
+        return false;
+    }
+
+    if (!resource_pack_open(path, &state_ptr->packs[state_ptr->pack_count]))
+    {
+        return false;
+    }
+
+    DINFO("Mounted resource pack '%s' with %i files.", path,
+          state_ptr->packs[state_ptr->pack_count].header->entry_count);
+    state_ptr->pack_count++;
+    return true;
+}
+
+void resource_system_prefer_loose_file(const char *full_file_path)
+{
+    const char *entry_path = state_ptr && full_file_path ? pack_entry_path(full_file_path) : 0;
+    if (!entry_path)
+    {
+        return;
+    }
+
+    u64 hash  = resource_pack_hash(entry_path, string_length(entry_path));
+    u32 count = state_ptr->loose_file_count;
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (state_ptr->loose_file_hashes[i] == hash)
+        {
+            return;
+        }
+    }
+    if (count >= RESOURCE_MAX_LOOSE_FILES)
+    {
+        DWARN("resource_system_prefer_loose_file - Too many loose files; '%s' will still be read from its pack.",
+              full_file_path);
+        return;
+    }
+
+    // Publish the hash before the count that makes it visible.
+    state_ptr->loose_file_hashes[count] = hash;
+    datomic_store(&state_ptr->loose_file_count, count + 1, DATOMIC_RELEASE);
+}
+
+b8 resource_system_map_file(const char *full_file_path, file_mapping *out_mapping)
+{
+    if (!full_file_path || !out_mapping)
+    {
+        return false;
+    }
+
+    if (find_in_packs(full_file_path, out_mapping))
+    {
+        return true;
+    }
+    return filesystem_map(full_file_path, out_mapping);
+}
+
+u32 resource_system_find_file(const resource_loader *loader, const char *name, char *out_full_file_path)
+{
+    const char *format_str = "%s/%s/%s%s";
+    const char *base_path  = resource_system_base_path();
+    if (loader->extension_count == 1)
+    {
+        // Nothing to choose between, so leave it to the loader to find out if the file exists.
+        string_format(out_full_file_path, format_str, base_path, loader->type_path, name, loader->extensions[0]);
+        return 0;
+    }
+
+    for (u32 i = 0; i < loader->extension_count; ++i)
+    {
+        string_format(out_full_file_path, format_str, base_path, loader->type_path, name, loader->extensions[i]);
+        file_mapping view;
+        if (find_in_packs(out_full_file_path, &view) || filesystem_exists(out_full_file_path))
+        {
+            return i;
+        }
+    }
+
+    string_format(out_full_file_path, format_str, base_path, loader->type_path, name, loader->extensions[0]);
+    return INVALID_ID;
+}
+
+void resource_system_create_arena(resource *out_resource, const char *full_file_path, u64 size)
+{
+    // Rounded up, so the loader's first allocation is aligned.
+    u64 path_length = string_length(full_file_path);
+    u64 path_size   = (path_length + 1 + 7) & ~(u64)7;
+    linear_allocator_create(path_size + size, 0, &out_resource->arena);
+    out_resource->full_path = linear_allocator_allocate(&out_resource->arena, path_size);
+    dcopy_memory(out_resource->full_path, full_file_path, path_length + 1);
+}
+
+void resource_system_unmap_file(file_mapping *mapping)
+{
+    if (!mapping)
+    {
+        return;
+    }
+
+    // Views into a pack stay mapped with the pack.
+    for (u32 i = 0; state_ptr && i < state_ptr->pack_count; ++i)
+    {
+        if (resource_pack_contains(&state_ptr->packs[i], mapping->data))
+        {
+            mapping->data = 0;
+            mapping->size = 0;
+            return;
+        }
+    }
+    filesystem_unmap(mapping);
+}
+
 b8 load(const char *name, resource_loader *loader, resource *out_resource)
 {
     if (!name || !loader || !loader->load || !out_resource)
@@ -186,5 +999,17 @@ b8 load(const char *name, resource_loader *loader, resource *out_resource)
     }
 
     out_resource->loader_id = loader->id;
-    return loader->load(loader, name, out_resource);
+    if (cache_acquire(loader, name, out_resource))
+    {
+        return true;
+    }
+    dzero_memory(&out_resource->arena, sizeof(linear_allocator));
+    if (!loader->load(loader, name, out_resource))
+    {
+        // Whatever the loader allocated before failing goes with the arena.
+        linear_allocator_destroy(&out_resource->arena);
+        return false;
+    }
+    cache_insert(loader, name, out_resource);
+    return true;
 }
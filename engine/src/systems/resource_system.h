@@ -1,12 +1,25 @@
 #pragma once
 
+#include "platform/filesystem.h"
 #include "resources/resource_types.h"
 
+// The maximum number of packs that can be mounted at once.
+#define RESOURCE_MAX_PACKS 8
+// The maximum number of files that can be read from disk in place of mounted packs.
+#define RESOURCE_MAX_LOOSE_FILES 256
+// The maximum number of decoded resources held in the cache at once.
+#define RESOURCE_CACHE_MAX_ENTRIES 256
+// The maximum number of file extensions a loader can try.
+#define RESOURCE_LOADER_MAX_EXTENSIONS 4
+
 typedef struct resource_system_config
 {
     u32 max_loader_count;
     // The relative base path for assets.
     char *asset_base_path;
+    // The most memory, in bytes, decoded resources may hold in the cache. Loads of cached resources
+    // share them rather than reading and decoding again. 0 disables the cache.
+    u64 cache_budget;
 } resource_system_config;
 
 typedef struct resource_loader
@@ -15,18 +28,151 @@ typedef struct resource_loader
     resource_type type;
     const char *custom_type;
     const char *type_path;
+    // Appended to resource names to get their file names, e.g. ".png". Tried in order until a file
+    // exists, so faster formats, such as cooked ones, should come first. Can be a single empty string.
+    const char *extensions[RESOURCE_LOADER_MAX_EXTENSIONS];
+    u32 extension_count;
     b8 (*load)(struct resource_loader *self, const char *name, resource *out_resource);
+    // Optional. Loads from the contents of the file at full_file_path, already read by the resource
+    // system. Lets resource_system_load_batch_async read many files at once.
+    b8 (*load_from_memory)(struct resource_loader *self, const char *name, const char *full_file_path,
+                           const void *data, u64 data_size, resource *out_resource);
     void (*unload)(struct resource_loader *self, resource *resource);
+    // Optional. Gets the memory held by a loaded resource. Only resources of loaders that provide it
+    // are cached, and since loads share them, they must be treated as read-only.
+    u64 (*memory_size)(struct resource_loader *self, const resource *resource);
 } resource_loader;
 
+/**
+ * @brief Invoked on the main thread once an asynchronous load has finished.
+ * On success, the callee owns loaded_resource and must eventually pass it to
+ * resource_system_unload. loaded_resource->name is only valid during the call. Loads still waiting
+ * to be pumped when the resource system shuts down are completed with success = false.
+ */
+typedef void (*PFN_resource_loaded)(b8 success, resource *loaded_resource, void *user_data);
+
 b8 resource_system_initialize(u64 *memory_requirement, void *state, resource_system_config config);
 void resource_system_shutdown(void *state);
 
+/**
+ * @brief Invokes the callbacks of all asynchronous loads completed since the last call.
+ * Should be called once per frame from the main thread.
+ */
+void resource_system_pump_completions();
+
+/**
+ * @brief Registers a loader. Only one loader may be registered for each type, or for each custom type,
+ * which is matched ignoring case.
+ *
+ * @param loader The loader to register. Copied.
+ * @return True if registered successfully; otherwise false.
+ */
 DAPI b8 resource_system_register_loader(resource_loader loader);
 
 DAPI b8 resource_system_load(const char *name, resource_type type, resource *out_resource);
+/**
+ * @brief Loads a resource on a worker thread. The loader runs off the main thread; callback
+ * is invoked later from resource_system_pump_completions() on the main thread.
+ *
+ * @param name The name of the resource to load. Copied, so it need not outlive the call.
+ * @param type The type of resource to load.
+ * @param callback The function invoked with the result. Required.
+ * @param user_data Passed as-is to callback. Can be 0/NULL.
+ * @return True if the load was started; otherwise false, in which case callback is never invoked.
+ */
+DAPI b8 resource_system_load_async(const char *name, resource_type type, PFN_resource_loaded callback,
+                                   void *user_data);
+/**
+ * @brief Loads many resources of the same type on worker threads. If the loader supports it, all of
+ * the files are read in a single batch first, so the storage device sees them all at once rather than
+ * one per job. callback is invoked once per resource, exactly as for resource_system_load_async.
+ *
+ * @param count The number of resources to load.
+ * @param names The names of the resources to load. Copied, so they need not outlive the call.
+ * @param type The type of resource to load.
+ * @param callback The function invoked with each result. Required.
+ * @param user_data Passed as-is to callback. Can be 0/NULL.
+ * @return True if the loads were started; otherwise false, in which case callback is never invoked.
+ */
+DAPI b8 resource_system_load_batch_async(u32 count, const char **names, resource_type type,
+                                         PFN_resource_loaded callback, void *user_data);
 DAPI b8 resource_system_load_custom(const char *name, const char *custom_type, resource *out_resource);
 
+/**
+ * @brief Unloads a resource. If it is cached, it stays loaded for later loads to share, until the cache
+ * runs over its budget and it is the least recently used resource no longer in use.
+ *
+ * @param resource A pointer to the resource to be unloaded.
+ */
 DAPI void resource_system_unload(resource *resource);
 
+/**
+ * @brief Drops a resource from the cache, so the next load reads its file again. Used by hot reload. If the
+ * cached resource is still in use, it is freed once the last user unloads it.
+ *
+ * @param name The name of the resource.
+ * @param type The type of the resource.
+ */
+DAPI void resource_system_evict(const char *name, resource_type type);
+
 DAPI const char *resource_system_base_path();
+
+/**
+ * @brief Finds the file holding a resource, trying each of its loader's extensions in order. Files in
+ * mounted packs are found as well as loose files.
+ *
+ * @param loader A pointer to the loader of the resource.
+ * @param name The name of the resource.
+ * @param out_full_file_path A buffer of at least 512 characters to hold the file's path. If no file is
+ * found, it holds the path with the first extension, so the failure to open it can be reported.
+ * @return The index of the extension of the file found; otherwise INVALID_ID.
+ */
+DAPI u32 resource_system_find_file(const resource_loader *loader, const char *name, char *out_full_file_path);
+
+/**
+ * @brief Creates the arena holding everything a loader allocates for a resource, and copies the resource's
+ * path into it as its full_path. Loaders call it once per load with the size of everything else they need,
+ * then take that from out_resource->arena with linear_allocator_allocate. It is a single allocation, freed
+ * as a whole after the loader's unload, or by the resource system if the load fails.
+ *
+ * @param out_resource A pointer to the resource being loaded.
+ * @param full_file_path The path of the resource's file.
+ * @param size The number of bytes the loader needs besides the path. Allocations are not aligned, beyond the
+ * first being 8-byte aligned, so structures should be taken before strings and pixels.
+ */
+DAPI void resource_system_create_arena(resource *out_resource, const char *full_file_path, u64 size);
+
+/**
+ * @brief Mounts a resource pack. From then on, files it contains are loaded from it rather than from
+ * the loose files under the asset base path. Packs mounted later take precedence. Should be called
+ * before any loads are started, since packs are read from worker threads without locking.
+ *
+ * @param path The path of the pack file.
+ * @return True if mounted successfully; otherwise false.
+ */
+DAPI b8 resource_system_mount_pack(const char *path);
+
+/**
+ * @brief Makes later loads of a file read it from disk, even when a mounted pack holds it. Used by hot
+ * reload, so an edited file takes effect while everything else still comes from packs. Main thread only.
+ *
+ * @param full_file_path The file's path, starting with the asset base path.
+ */
+DAPI void resource_system_prefer_loose_file(const char *full_file_path);
+
+/**
+ * @brief Maps a file for a loader to read. If a mounted pack holds the file, the view points into
+ * the pack; otherwise the loose file is mapped. Either way, release it with resource_system_unmap_file.
+ *
+ * @param full_file_path The file's path, starting with the asset base path.
+ * @param out_mapping A pointer to hold the mapping.
+ * @return True if successful; otherwise false.
+ */
+DAPI b8 resource_system_map_file(const char *full_file_path, file_mapping *out_mapping);
+
+/**
+ * @brief Releases a mapping from resource_system_map_file.
+ *
+ * @param mapping A pointer to the mapping to be released.
+ */
+DAPI void resource_system_unmap_file(file_mapping *mapping);
@@ -0,0 +1,160 @@
+#include "texture_streaming.h"
+
+// Gets the width or height of a mip level from that of the full size image.
+static u32 mip_dimension(u32 size, u32 level)
+{
+    return size >> level ? size >> level : 1;
+}
+
+u32 texture_streaming_start_level(u32 width, u32 height, u32 mip_count)
+{
+    u32 largest = width > height ? width : height;
+    u32 level   = 0;
+    while (level + 1 < mip_count && mip_dimension(largest, level) > TEXTURE_STREAMING_START_SIZE)
+    {
+        level++;
+    }
+    return level;
+}
+
+u32 texture_streaming_wanted_level(u32 width, u32 height, u32 mip_count, f32 screen_size)
+{
+    u32 largest = width > height ? width : height;
+    u32 level   = 0;
+    while (level + 1 < mip_count && (f32)mip_dimension(largest, level + 1) >= screen_size)
+    {
+        level++;
+    }
+    return level;
+}
+
+u64 texture_streaming_size(u32 width, u32 height, u32 mip_count, u32 level)
+{
+    u64 size = 0;
+    for (u32 i = level; i < mip_count; ++i)
+    {
+        size += (u64)mip_dimension(width, i) * mip_dimension(height, i) * 4;
+    }
+    return size;
+}
+
+static u64 resident_size(const texture_streaming_entry *entry, u32 level)
+{
+    return texture_streaming_size(entry->width, entry->height, entry->mip_count, level);
+}
+
+static b8 is_changing(u32 index, u32 change_count, const texture_streaming_change *changes)
+{
+    for (u32 i = 0; i < change_count; ++i)
+    {
+        if (changes[i].index == index)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Finds the least important texture held finer than it wants, optionally only among those less important
+// than limit. Returns INVALID_ID if there is none.
+static u32 find_lowerable(u32 count, const texture_streaming_entry *entries, b8 limited, f32 limit, u32 change_count,
+                          const texture_streaming_change *changes)
+{
+    u32 found = INVALID_ID;
+    for (u32 i = 0; i < count; ++i)
+    {
+        const texture_streaming_entry *entry = &entries[i];
+        if (entry->mip_count == 0 || entry->busy || entry->resident_level >= entry->wanted_level ||
+            (limited && entry->importance >= limit) ||
+            (found != INVALID_ID && entry->importance >= entries[found].importance) ||
+            is_changing(i, change_count, changes))
+        {
+            continue;
+        }
+        found = i;
+    }
+    return found;
+}
+
+// Finds the most important texture drawn larger than it is held. Returns INVALID_ID if there is none.
+static u32 find_raisable(u32 count, const texture_streaming_entry *entries, u32 change_count,
+                         const texture_streaming_change *changes)
+{
+    u32 found = INVALID_ID;
+    for (u32 i = 0; i < count; ++i)
+    {
+        const texture_streaming_entry *entry = &entries[i];
+        if (entry->mip_count == 0 || entry->busy || entry->importance <= 0 ||
+            entry->wanted_level >= entry->resident_level ||
+            (found != INVALID_ID && entry->importance <= entries[found].importance) ||
+            is_changing(i, change_count, changes))
+        {
+            continue;
+        }
+        found = i;
+    }
+    return found;
+}
+
+u32 texture_streaming_plan(u32 count, const texture_streaming_entry *entries, u64 budget, u32 max_changes,
+                           texture_streaming_change *out_changes)
+{
+    // Textures being changed are counted at what they hold now, until the change lands.
+    u64 used = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (entries[i].mip_count > 0)
+        {
+            used += resident_size(&entries[i], entries[i].resident_level);
+        }
+    }
+
+    // Over budget, so lower whatever is held finer than it needs, least important first.
+    u32 change_count = 0;
+    while (used > budget && change_count < max_changes)
+    {
+        u32 index = find_lowerable(count, entries, false, 0, change_count, out_changes);
+        if (index == INVALID_ID)
+        {
+            break;
+        }
+        const texture_streaming_entry *entry = &entries[index];
+        used -= resident_size(entry, entry->resident_level) - resident_size(entry, entry->wanted_level);
+        out_changes[change_count++] = (texture_streaming_change){index, entry->wanted_level};
+    }
+
+    // Raise the most important textures, making room by lowering less important ones. Stops at the first
+    // that does not fit, so a less important texture never takes memory a more important one is waiting for.
+    while (change_count < max_changes)
+    {
+        u32 index = find_raisable(count, entries, change_count, out_changes);
+        if (index == INVALID_ID)
+        {
+            break;
+        }
+        const texture_streaming_entry *entry = &entries[index];
+        u64 cost = resident_size(entry, entry->wanted_level) - resident_size(entry, entry->resident_level);
+
+        // Leave room in the changes for the raise itself.
+        while (used + cost > budget && change_count + 1 < max_changes)
+        {
+            u32 lower = find_lowerable(count, entries, true, entry->importance, change_count, out_changes);
+            if (lower == INVALID_ID)
+            {
+                break;
+            }
+            const texture_streaming_entry *lowered = &entries[lower];
+            used -= resident_size(lowered, lowered->resident_level) - resident_size(lowered, lowered->wanted_level);
+            out_changes[change_count++] = (texture_streaming_change){lower, lowered->wanted_level};
+        }
+        if (used + cost > budget)
+        {
+            break;
+        }
+
+        used += cost;
+        out_changes[change_count++] = (texture_streaming_change){index, entry->wanted_level};
+    }
+
+    return change_count;
+}
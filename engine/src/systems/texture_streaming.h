@@ -0,0 +1,82 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Texture streaming keeps only the mip levels a texture needs on the GPU. A cooked texture is
+first uploaded at a small size, then the renderer reports how large it is drawn each frame, and
+finer levels are loaded for the textures that need them most, within a memory budget. Textures
+drawn smaller than they are held are dropped to coarser levels when the budget runs short.
+
+This is the policy, kept apart from the texture system so it can be tested on its own.
+*/
+
+// Textures are first uploaded at the first level no larger than this on either side.
+#define TEXTURE_STREAMING_START_SIZE 64
+
+// How one texture is held, and how it is being drawn.
+typedef struct texture_streaming_entry
+{
+    // The size of the full image.
+    u32 width;
+    u32 height;
+    // The number of mip levels the source has. 0 if the texture is not streamed.
+    u32 mip_count;
+    // The finest level on the GPU. The levels from it to the last are held.
+    u32 resident_level;
+    // The finest level worth holding for how the texture was last drawn.
+    u32 wanted_level;
+    // How large the texture was last drawn, in pixels across. 0 if it was not drawn.
+    f32 importance;
+    // If a change of level is being loaded.
+    b8 busy;
+} texture_streaming_entry;
+
+// A change of resident level for one texture.
+typedef struct texture_streaming_change
+{
+    u32 index;
+    u32 level;
+} texture_streaming_change;
+
+/**
+ * @brief Gets the level to first upload a texture at.
+ *
+ * @param width The width of the full image.
+ * @param height The height of the full image.
+ * @param mip_count The number of mip levels the image has.
+ * @return The level to upload from.
+ */
+DAPI u32 texture_streaming_start_level(u32 width, u32 height, u32 mip_count);
+
+/**
+ * @brief Gets the finest level worth holding for a texture drawn at a given size.
+ *
+ * @param width The width of the full image.
+ * @param height The height of the full image.
+ * @param mip_count The number of mip levels the image has.
+ * @param screen_size How large the texture is drawn, in pixels across.
+ * @return The coarsest level at least as large as screen_size, or level 0 if none is.
+ */
+DAPI u32 texture_streaming_wanted_level(u32 width, u32 height, u32 mip_count, f32 screen_size);
+
+/**
+ * @brief Gets the GPU memory taken by a texture's levels from level to the last, at 4 bytes per texel.
+ */
+DAPI u64 texture_streaming_size(u32 width, u32 height, u32 mip_count, u32 level);
+
+/**
+ * @brief Decides which textures to change the resident level of. Textures drawn larger than they are
+ * held are raised to the level they want, most important first. To stay within the budget, textures
+ * held finer than they want, least important first, are lowered to the level they want; only textures
+ * less important than the one being raised are lowered for it. Textures that are busy are left alone.
+ *
+ * @param count The number of entries.
+ * @param entries The textures. Entries with a mip_count of 0 are skipped.
+ * @param budget The most GPU memory, in bytes, the resident levels may take.
+ * @param max_changes The most changes to make at once.
+ * @param out_changes An array of max_changes to hold the changes.
+ * @return The number of changes written to out_changes.
+ */
+DAPI u32 texture_streaming_plan(u32 count, const texture_streaming_entry *entries, u64 budget, u32 max_changes,
+                                texture_streaming_change *out_changes);
@@ -7,7 +7,22 @@
 
 #include "renderer/renderer_frontend.h"
 
+#include "systems/job_system.h"
 #include "systems/resource_system.h"
+#include "systems/texture_streaming.h"
+
+// The most mip level changes being loaded at once, so streaming does not crowd out other loads.
+#define TEXTURE_STREAMING_MAX_LOADS 4
+
+// A mip level change that has finished loading, waiting to be uploaded along with the others.
+typedef struct texture_streamed_level
+{
+    u32 handle;
+    u32 level;
+    // The name of the texture, to check the slot still holds it.
+    char name[TEXTURE_NAME_MAX_LENGTH];
+    resource img_resource;
+} texture_streamed_level;
 
 typedef struct texture_system_state
 {
@@ -19,6 +34,16 @@ typedef struct texture_system_state
 
     // Hashtable for texture lookups.
     hashtable registered_texture_table;
+
+    // How each registered texture is streamed, by slot.
+    texture_streaming_entry *streaming;
+    // The background load filling each slot for the first time, if any, by slot.
+    struct texture_load_request **loading;
+    // If the renderer has reported any usage since the last update.
+    b8 usage_reported;
+    // Mip level changes loaded since the last update.
+    texture_streamed_level streamed_levels[TEXTURE_STREAMING_MAX_LOADS];
+    u32 streamed_level_count;
 } texture_system_state;
 
 typedef struct texture_reference
@@ -28,12 +53,60 @@ typedef struct texture_reference
     b8 auto_release;
 } texture_reference;
 
+// How acquire_texture should fill a slot the first time a texture is acquired.
+typedef enum texture_load_mode
+{
+    // Load and upload before returning.
+    TEXTURE_LOAD_MODE_SYNC,
+    // Reserve the slot and load in the background.
+    TEXTURE_LOAD_MODE_ASYNC,
+    // Only reserve the slot. The caller is responsible for loading it.
+    TEXTURE_LOAD_MODE_DEFERRED
+} texture_load_mode;
+
+// A callback waiting on a background load of a texture.
+typedef struct texture_load_waiter
+{
+    PFN_texture_loaded callback;
+    void *user_data;
+    struct texture_load_waiter *next;
+} texture_load_waiter;
+
+// Tracks a background load of a texture until it has been uploaded.
+typedef struct texture_load_request
+{
+    u32 handle;
+    // The mip level to hold from once loaded, or INVALID_ID to keep what is held, or start small.
+    u32 level;
+    // Invoked once the load has finished, in the order they were added.
+    texture_load_waiter *waiters;
+    texture_load_waiter *last_waiter;
+} texture_load_request;
+
+// Decodes one image of a texture_system_acquire_many batch on a worker thread.
+typedef struct texture_decode_job
+{
+    const char *name;
+    texture *t;
+    b8 success;
+    resource img_resource;
+} texture_decode_job;
+
 static texture_system_state *state_ptr = 0;
 
 b8 create_default_textures(texture_system_state *state);
 void destroy_default_textures(texture_system_state *state);
 b8 load_texture(const char *texture_name, texture *t);
+void upload_textures(u32 count, const char **texture_names, image_resource_data **resource_data, const u32 *levels,
+                     texture **textures);
 void destroy_texture(texture *t);
+static texture *acquire_texture(const char *name, b8 auto_release, texture_load_mode mode, PFN_texture_loaded callback,
+                                void *user_data, b8 *out_reserved);
+static b8 start_texture_load(u32 handle, u32 level, PFN_texture_loaded callback, void *user_data);
+static void add_texture_load_waiter(texture_load_request *request, PFN_texture_loaded callback, void *user_data);
+static void texture_load_completed(b8 success, resource *img_resource, void *user_data);
+static void texture_decode_job_entry(void *params);
+static void upload_streamed_levels();
 
 b8 texture_system_initialize(u64 *memory_requirement, void *state, texture_system_config config)
 {
@@ -43,11 +116,15 @@ b8 texture_system_initialize(u64 *memory_requirement, void *state, texture_syste
         return false;
     }
 
-    // Block of memory will contain state structure, then block for array, then block for hashtable.
+    // Block of memory will contain state structure, then block for array, then block for hashtable,
+    // then block for streaming, then block for loads.
     u64 struct_requirement    = sizeof(texture_system_state);
     u64 array_requirement     = sizeof(texture) * config.max_texture_count;
     u64 hashtable_requirement = sizeof(texture_reference) * config.max_texture_count;
-    *memory_requirement       = struct_requirement + array_requirement + hashtable_requirement;
+    u64 streaming_requirement = sizeof(texture_streaming_entry) * config.max_texture_count;
+    u64 loading_requirement   = sizeof(texture_load_request *) * config.max_texture_count;
+    *memory_requirement =
+        struct_requirement + array_requirement + hashtable_requirement + streaming_requirement + loading_requirement;
 
     if (!state)
     {
@@ -68,6 +145,14 @@ b8 texture_system_initialize(u64 *memory_requirement, void *state, texture_syste
     hashtable_create(sizeof(texture_reference), config.max_texture_count, hashtable_block, false,
                      &state_ptr->registered_texture_table);
 
+    // Streaming block is after hashtable.
+    state_ptr->streaming = hashtable_block + hashtable_requirement;
+    dzero_memory(state_ptr->streaming, streaming_requirement);
+
+    // Loads block is after streaming.
+    state_ptr->loading = (void *)state_ptr->streaming + streaming_requirement;
+    dzero_memory(state_ptr->loading, loading_requirement);
+
     // Fill the hashtable with invalid references to use as a default.
     texture_reference invalid_ref;
     invalid_ref.auto_release    = false;
@@ -93,6 +178,12 @@ void texture_system_shutdown(void *state)
 {
     if (state_ptr)
     {
+        for (u32 i = 0; i < state_ptr->streamed_level_count; ++i)
+        {
+            resource_system_unload(&state_ptr->streamed_levels[i].img_resource);
+        }
+        state_ptr->streamed_level_count = 0;
+
         // Destroy all loaded textures.
         for (u32 i = 0; i < state_ptr->config.max_texture_count; ++i)
         {
@@ -110,12 +201,129 @@ void texture_system_shutdown(void *state)
 }
 
 texture *texture_system_acquire(const char *name, b8 auto_release)
+{
+    return acquire_texture(name, auto_release, TEXTURE_LOAD_MODE_SYNC, 0, 0, 0);
+}
+
+texture *texture_system_acquire_async(const char *name, b8 auto_release)
+{
+    return acquire_texture(name, auto_release, TEXTURE_LOAD_MODE_ASYNC, 0, 0, 0);
+}
+
+texture *texture_system_acquire_async_notify(const char *name, b8 auto_release, PFN_texture_loaded callback,
+                                             void *user_data)
+{
+    if (!callback)
+    {
+        return 0;
+    }
+    return acquire_texture(name, auto_release, TEXTURE_LOAD_MODE_ASYNC, callback, user_data, 0);
+}
+
+b8 texture_system_acquire_many(u32 count, const char **names, b8 auto_release, texture **out_textures)
+{
+    if (!state_ptr || count == 0 || !names || !out_textures)
+    {
+        return false;
+    }
+
+    // Reserve slots for everything first. Only textures not already loaded get a decode job.
+    texture_decode_job *jobs = dallocate(sizeof(texture_decode_job) * count, MEMORY_TAG_JOB);
+    u32 job_count            = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        b8 reserved     = false;
+        out_textures[i] = acquire_texture(names[i], auto_release, TEXTURE_LOAD_MODE_DEFERRED, 0, 0, &reserved);
+        if (reserved)
+        {
+            texture_decode_job *job = &jobs[job_count++];
+            job->name               = out_textures[i]->name;
+            job->t                  = out_textures[i];
+        }
+    }
+
+    // Decode in parallel. This thread helps out while it waits.
+    job_counter counter = {0};
+    for (u32 i = 0; i < job_count; ++i)
+    {
+        job_system_submit(job_create(texture_decode_job_entry, &jobs[i], JOB_PRIORITY_HIGH, &counter));
+    }
+    job_system_wait(&counter);
+
+    // Upload everything that decoded in one batch.
+    const char **upload_names         = dallocate(sizeof(const char *) * count, MEMORY_TAG_TEXTURE);
+    image_resource_data **upload_data = dallocate(sizeof(image_resource_data *) * count, MEMORY_TAG_TEXTURE);
+    texture **upload_targets          = dallocate(sizeof(texture *) * count, MEMORY_TAG_TEXTURE);
+    u32 upload_count                  = 0;
+    b8 all_loaded                     = true;
+    for (u32 i = 0; i < job_count; ++i)
+    {
+        texture_decode_job *job = &jobs[i];
+        if (job->success)
+        {
+            upload_names[upload_count]   = job->name;
+            upload_data[upload_count]    = job->img_resource.data;
+            upload_targets[upload_count] = job->t;
+            upload_count++;
+            continue;
+        }
+
+        // Undo the reservation, the same as a failed texture_system_acquire.
+        DERROR("Failed to load texture '%s'.", job->name);
+        all_loaded = false;
+        texture_reference ref;
+        hashtable_get(&state_ptr->registered_texture_table, job->name, &ref);
+        ref.reference_count = 0;
+        ref.handle          = INVALID_ID;
+        ref.auto_release    = false;
+        hashtable_set(&state_ptr->registered_texture_table, job->name, &ref);
+        for (u32 j = 0; j < count; ++j)
+        {
+            if (out_textures[j] == job->t)
+            {
+                out_textures[j] = 0;
+            }
+        }
+        destroy_texture(job->t);
+    }
+
+    upload_textures(upload_count, upload_names, upload_data, 0, upload_targets);
+
+    for (u32 i = 0; i < job_count; ++i)
+    {
+        if (jobs[i].success)
+        {
+            resource_system_unload(&jobs[i].img_resource);
+        }
+    }
+
+    dfree(upload_names, sizeof(const char *) * count, MEMORY_TAG_TEXTURE);
+    dfree(upload_data, sizeof(image_resource_data *) * count, MEMORY_TAG_TEXTURE);
+    dfree(upload_targets, sizeof(texture *) * count, MEMORY_TAG_TEXTURE);
+    dfree(jobs, sizeof(texture_decode_job) * count, MEMORY_TAG_JOB);
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (!out_textures[i])
+        {
+            all_loaded = false;
+        }
+    }
+    return all_loaded;
+}
+
+static texture *acquire_texture(const char *name, b8 auto_release, texture_load_mode mode, PFN_texture_loaded callback,
+                                void *user_data, b8 *out_reserved)
 {
     // Return default texture, but warn about it since this should be returned via get_default_texture();
     if (strings_equali(name, DEFAULT_TEXTURE_NAME))
     {
         DWARN("texture_system_acquire called for default texture. Use texture_system_get_default_texture for texture "
               "'default'.");
+        if (callback)
+        {
+            callback(true, &state_ptr->default_texture, user_data);
+        }
         return &state_ptr->default_texture;
     }
 
@@ -152,20 +360,66 @@ texture *texture_system_acquire(const char *name, b8 auto_release)
                 return 0;
             }
 
-            // Create new texture.
-            if (!load_texture(name, t))
+            if (mode == TEXTURE_LOAD_MODE_DEFERRED)
+            {
+                // The caller loads the texture. Until then the slot looks like a pending async load.
+                string_ncopy(t->name, name, TEXTURE_NAME_MAX_LENGTH);
+                t->generation = INVALID_ID;
+                if (out_reserved)
+                {
+                    *out_reserved = true;
+                }
+            }
+            else if (mode == TEXTURE_LOAD_MODE_ASYNC)
+            {
+                // Reserve the slot now. The generation stays invalid until the load completes,
+                // which makes the renderer substitute the default texture.
+                string_ncopy(t->name, name, TEXTURE_NAME_MAX_LENGTH);
+                t->generation = INVALID_ID;
+                if (!start_texture_load(ref.handle, INVALID_ID, callback, user_data))
+                {
+                    DERROR("Failed to start loading texture '%s'.", name);
+                    dzero_memory(t->name, sizeof(char) * TEXTURE_NAME_MAX_LENGTH);
+                    return 0;
+                }
+            }
+            else if (!load_texture(name, t))
             {
+                // Create new texture.
                 DERROR("Failed to load texture '%s'.", name);
                 return 0;
             }
 
             // Also use the handle as the texture id.
             t->id = ref.handle;
-            DTRACE("Texture '%s' does not yet exist. Created, and ref_count is now %i.", name, ref.reference_count);
+            DLOG_RATE_LIMITED(LOG_LEVEL_TRACE, "Texture '%s' does not yet exist. Created, and ref_count is now %i.",
+                              name, ref.reference_count);
         }
         else
         {
-            DTRACE("Texture '%s' already exists, ref_count increased to %i.", name, ref.reference_count);
+            DLOG_RATE_LIMITED(LOG_LEVEL_TRACE, "Texture '%s' already exists, ref_count increased to %i.", name,
+                              ref.reference_count);
+
+            // Either loaded, or being loaded by an earlier acquire, in which case the callback waits for that
+            // load. Without one, an invalid generation means the texture failed to load.
+            texture *t = &state_ptr->registered_textures[ref.handle];
+            if (callback)
+            {
+                hashtable_set(&state_ptr->registered_texture_table, name, &ref);
+                if (t->generation != INVALID_ID)
+                {
+                    callback(true, t, user_data);
+                }
+                else if (state_ptr->loading[ref.handle])
+                {
+                    add_texture_load_waiter(state_ptr->loading[ref.handle], callback, user_data);
+                }
+                else
+                {
+                    callback(false, t, user_data);
+                }
+                return t;
+            }
         }
 
         // Update the entry.
@@ -210,13 +464,16 @@ void texture_system_release(const char *name)
             // Reset the reference.
             ref.handle       = INVALID_ID;
             ref.auto_release = false;
-            DTRACE("Released texture '%s'., Texture unloaded because reference count=0 and auto_release=true.",
-                   name_copy);
+            DLOG_RATE_LIMITED(LOG_LEVEL_TRACE,
+                              "Released texture '%s'., Texture unloaded because reference count=0 and "
+                              "auto_release=true.",
+                              name_copy);
         }
         else
         {
-            DTRACE("Released texture '%s', now has a reference count of '%i' (auto_release=%s).", name_copy,
-                   ref.reference_count, ref.auto_release ? "true" : "false");
+            DLOG_RATE_LIMITED(LOG_LEVEL_TRACE,
+                              "Released texture '%s', now has a reference count of '%i' (auto_release=%s).", name_copy,
+                              ref.reference_count, ref.auto_release ? "true" : "false");
         }
 
         // Update the entry.
@@ -228,6 +485,143 @@ void texture_system_release(const char *name)
     }
 }
 
+b8 texture_system_reload(const char *name)
+{
+    texture_reference ref;
+    if (!state_ptr || !hashtable_get(&state_ptr->registered_texture_table, name, &ref) || ref.handle == INVALID_ID)
+    {
+        // Not loaded, so the next acquire reads the new image anyway.
+        return false;
+    }
+
+    // Completes through texture_load_completed like any async load, replacing the image in the same slot.
+    if (!start_texture_load(ref.handle, INVALID_ID, 0, 0))
+    {
+        DERROR("Failed to start reloading texture '%s'.", name);
+        return false;
+    }
+
+    DDEBUG("Reloading texture '%s'.", name);
+    return true;
+}
+
+// Gets how a texture is streamed, or nullptr for textures not in a slot, such as the default texture.
+static texture_streaming_entry *streaming_entry(texture *t)
+{
+    if (!state_ptr || t < state_ptr->registered_textures ||
+        t >= state_ptr->registered_textures + state_ptr->config.max_texture_count)
+    {
+        return 0;
+    }
+    return &state_ptr->streaming[t - state_ptr->registered_textures];
+}
+
+void texture_system_report_usage(texture *t, f32 screen_size)
+{
+    texture_streaming_entry *entry = streaming_entry(t);
+    if (!entry || entry->mip_count == 0)
+    {
+        return;
+    }
+
+    // Drawn several times, a texture needs what its largest use needs.
+    u32 level = texture_streaming_wanted_level(entry->width, entry->height, entry->mip_count, screen_size);
+    if (screen_size > entry->importance)
+    {
+        entry->importance = screen_size;
+    }
+    if (level < entry->wanted_level)
+    {
+        entry->wanted_level = level;
+    }
+    state_ptr->usage_reported = true;
+}
+
+void texture_system_update()
+{
+    if (!state_ptr)
+    {
+        return;
+    }
+
+    upload_streamed_levels();
+
+    if (state_ptr->config.streaming_budget == 0 || !state_ptr->usage_reported)
+    {
+        return;
+    }
+
+    u32 count      = state_ptr->config.max_texture_count;
+    u32 busy_count = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        busy_count += state_ptr->streaming[i].busy ? 1 : 0;
+    }
+
+    if (busy_count < TEXTURE_STREAMING_MAX_LOADS)
+    {
+        texture_streaming_change changes[TEXTURE_STREAMING_MAX_LOADS];
+        u32 change_count = texture_streaming_plan(count, state_ptr->streaming, state_ptr->config.streaming_budget,
+                                                  TEXTURE_STREAMING_MAX_LOADS - busy_count, changes);
+        for (u32 i = 0; i < change_count; ++i)
+        {
+            texture_streaming_entry *entry = &state_ptr->streaming[changes[i].index];
+            DTRACE("Streaming texture '%s' from mip level %u to %u.",
+                   state_ptr->registered_textures[changes[i].index].name, entry->resident_level, changes[i].level);
+            entry->busy = start_texture_load(changes[i].index, changes[i].level, 0, 0);
+        }
+    }
+
+    // Usage is reported afresh each frame. Until then, a texture wants no more than it started with.
+    for (u32 i = 0; i < count; ++i)
+    {
+        texture_streaming_entry *entry = &state_ptr->streaming[i];
+        if (entry->mip_count > 0)
+        {
+            entry->importance   = 0;
+            entry->wanted_level = texture_streaming_start_level(entry->width, entry->height, entry->mip_count);
+        }
+    }
+    state_ptr->usage_reported = false;
+}
+
+// Uploads the mip level changes loaded since the last update in one go, rather than one renderer upload each.
+static void upload_streamed_levels()
+{
+    const char *names[TEXTURE_STREAMING_MAX_LOADS];
+    image_resource_data *resource_data[TEXTURE_STREAMING_MAX_LOADS];
+    u32 levels[TEXTURE_STREAMING_MAX_LOADS];
+    texture *textures[TEXTURE_STREAMING_MAX_LOADS];
+    u32 upload_count = 0;
+    for (u32 i = 0; i < state_ptr->streamed_level_count; ++i)
+    {
+        texture_streamed_level *streamed = &state_ptr->streamed_levels[i];
+        texture *t                       = &state_ptr->registered_textures[streamed->handle];
+        // Released textures have their streaming entry cleared.
+        if (t->id == streamed->handle && strings_equal(t->name, streamed->name) &&
+            state_ptr->streaming[streamed->handle].busy)
+        {
+            names[upload_count]         = streamed->name;
+            resource_data[upload_count] = streamed->img_resource.data;
+            levels[upload_count]        = streamed->level;
+            textures[upload_count]      = t;
+            upload_count++;
+        }
+    }
+
+    upload_textures(upload_count, names, resource_data, levels, textures);
+
+    for (u32 i = 0; i < upload_count; ++i)
+    {
+        state_ptr->streaming[textures[i]->id].busy = false;
+    }
+    for (u32 i = 0; i < state_ptr->streamed_level_count; ++i)
+    {
+        resource_system_unload(&state_ptr->streamed_levels[i].img_resource);
+    }
+    state_ptr->streamed_level_count = 0;
+}
+
 texture *texture_system_get_default_texture()
 {
     if (state_ptr)
@@ -307,58 +701,229 @@ b8 load_texture(const char *texture_name, texture *t)
     }
 
     image_resource_data *resource_data = img_resource.data;
+    upload_textures(1, &texture_name, &resource_data, 0, &t);
 
-    // Use a temporary texture to load into.
-    texture temp_texture;
-    temp_texture.width         = resource_data->width;
-    temp_texture.height        = resource_data->height;
-    temp_texture.channel_count = resource_data->channel_count;
+    // Clean up data.
+    resource_system_unload(&img_resource);
+    return true;
+}
 
-    u32 current_generation = t->generation;
-    t->generation          = INVALID_ID;
+// Loads the image of the texture in a slot in the background, to be uploaded by texture_load_completed.
+static b8 start_texture_load(u32 handle, u32 level, PFN_texture_loaded callback, void *user_data)
+{
+    texture_load_request *request = dallocate(sizeof(texture_load_request), MEMORY_TAG_TEXTURE);
+    request->handle               = handle;
+    request->level                = level;
+    if (callback)
+    {
+        add_texture_load_waiter(request, callback, user_data);
+    }
 
-    u64 total_size = temp_texture.width * temp_texture.height * temp_texture.channel_count;
-    // Check for transparency
-    b32 has_transparency = false;
-    for (u64 i = 0; i < total_size; i += temp_texture.channel_count)
+    texture *t = &state_ptr->registered_textures[handle];
+    if (!resource_system_load_async(t->name, RESOURCE_TYPE_IMAGE, texture_load_completed, request))
     {
-        u8 a = resource_data->pixels[i + 3];
-        if (a < 255)
+        if (request->waiters)
         {
-            has_transparency = true;
-            break;
+            dfree(request->waiters, sizeof(texture_load_waiter), MEMORY_TAG_TEXTURE);
         }
+        dfree(request, sizeof(texture_load_request), MEMORY_TAG_TEXTURE);
+        return false;
+    }
+    // Later acquires of a texture being loaded for the first time wait on this load.
+    if (level == INVALID_ID)
+    {
+        state_ptr->loading[handle] = request;
+    }
+    return true;
+}
+
+static void add_texture_load_waiter(texture_load_request *request, PFN_texture_loaded callback, void *user_data)
+{
+    texture_load_waiter *waiter = dallocate(sizeof(texture_load_waiter), MEMORY_TAG_TEXTURE);
+    waiter->callback            = callback;
+    waiter->user_data           = user_data;
+    if (request->last_waiter)
+    {
+        request->last_waiter->next = waiter;
+    }
+    else
+    {
+        request->waiters = waiter;
     }
+    request->last_waiter = waiter;
+}
 
-    // Take a copy of the name.
-    string_ncopy(temp_texture.name, texture_name, TEXTURE_NAME_MAX_LENGTH);
-    temp_texture.generation       = INVALID_ID;
-    temp_texture.has_transparency = has_transparency;
+static void texture_load_completed(b8 success, resource *img_resource, void *user_data)
+{
+    texture_load_request request = *(texture_load_request *)user_data;
+    if (state_ptr && state_ptr->loading[request.handle] == user_data)
+    {
+        state_ptr->loading[request.handle] = 0;
+    }
+    dfree(user_data, sizeof(texture_load_request), MEMORY_TAG_TEXTURE);
 
-    // Acquire internal texture resources and upload to GPU.
-    renderer_create_texture(resource_data->pixels, &temp_texture);
+    // The texture may have been released, or its slot reused, while it was loading.
+    texture *t = state_ptr ? &state_ptr->registered_textures[request.handle] : 0;
+    if (!t || t->id != request.handle || !strings_equal(t->name, img_resource->name))
+    {
+        DTRACE("Discarding loaded image '%s'; its texture was released while loading.", img_resource->name);
+        if (success)
+        {
+            resource_system_unload(img_resource);
+        }
+        t = 0;
+    }
+    else if (success && request.level != INVALID_ID)
+    {
+        // Uploaded with the other level changes loaded this frame by the next update, and busy until then.
+        if (state_ptr->streamed_level_count == TEXTURE_STREAMING_MAX_LOADS)
+        {
+            upload_streamed_levels();
+        }
+        texture_streamed_level *streamed = &state_ptr->streamed_levels[state_ptr->streamed_level_count++];
+        streamed->handle                 = request.handle;
+        streamed->level                  = request.level;
+        string_ncopy(streamed->name, t->name, TEXTURE_NAME_MAX_LENGTH);
+        streamed->img_resource = *img_resource;
+    }
+    else if (success)
+    {
+        image_resource_data *resource_data = img_resource->data;
+        upload_textures(1, &img_resource->name, &resource_data, 0, &t);
+        resource_system_unload(img_resource);
+    }
+    else if (t && request.level != INVALID_ID)
+    {
+        state_ptr->streaming[request.handle].busy = false;
+    }
+    // Otherwise the slot keeps its invalid generation, so the default texture stays in place.
 
-    // Take a copy of the old texture.
-    texture old = *t;
+    // A waiter may acquire or release textures, so each is unlinked before it is invoked.
+    texture_load_waiter *waiter = request.waiters;
+    while (waiter)
+    {
+        texture_load_waiter current = *waiter;
+        dfree(waiter, sizeof(texture_load_waiter), MEMORY_TAG_TEXTURE);
+        current.callback(success && t, t, current.user_data);
+        waiter = current.next;
+    }
+}
 
-    // Assign the temp texture to the pointer.
-    *t = temp_texture;
+static void texture_decode_job_entry(void *params)
+{
+    texture_decode_job *job = params;
+    job->success            = resource_system_load(job->name, RESOURCE_TYPE_IMAGE, &job->img_resource);
+}
 
-    // Destroy the old texture.
-    renderer_destroy_texture(&old);
+// Uploads images into textures. levels optionally gives the mip level each texture is to hold from. Otherwise
+// streamed textures keep the level they hold, or start small, and others get every level.
+void upload_textures(u32 count, const char **texture_names, image_resource_data **resource_data, const u32 *levels,
+                     texture **textures)
+{
+    if (count == 0)
+    {
+        return;
+    }
 
-    if (current_generation == INVALID_ID)
+    // Use temporary textures to load into.
+    texture *temp_textures   = dallocate(sizeof(texture) * count, MEMORY_TAG_TEXTURE);
+    texture **temp_pointers  = dallocate(sizeof(texture *) * count, MEMORY_TAG_TEXTURE);
+    const u8 ***mips         = dallocate(sizeof(const u8 **) * count, MEMORY_TAG_TEXTURE);
+    u32 *current_generations = dallocate(sizeof(u32) * count, MEMORY_TAG_TEXTURE);
+    for (u32 i = 0; i < count; ++i)
     {
-        t->generation = 0;
+        image_resource_data *image = resource_data[i];
+        u32 mip_count              = image->mip_count ? image->mip_count : 1;
+
+        // Only cooked textures, which come with their mip levels, are streamed.
+        texture_streaming_entry *entry = streaming_entry(textures[i]);
+        u32 level                      = 0;
+        if (entry && mip_count > 1 && state_ptr->config.streaming_budget > 0)
+        {
+            if (levels)
+            {
+                level = levels[i];
+            }
+            else if (entry->mip_count > 0)
+            {
+                level = entry->resident_level;
+            }
+            else
+            {
+                level               = texture_streaming_start_level(image->width, image->height, mip_count);
+                entry->wanted_level = level;
+            }
+            level                 = level < mip_count ? level : mip_count - 1;
+            entry->width          = image->width;
+            entry->height         = image->height;
+            entry->mip_count      = mip_count;
+            entry->resident_level = level;
+        }
+        else if (entry)
+        {
+            dzero_memory(entry, sizeof(texture_streaming_entry));
+        }
+
+        texture *temp_texture       = &temp_textures[i];
+        temp_texture->id            = textures[i]->id;
+        temp_texture->width         = image->width >> level ? image->width >> level : 1;
+        temp_texture->height        = image->height >> level ? image->height >> level : 1;
+        temp_texture->channel_count = image->channel_count;
+        temp_texture->mip_count     = mip_count - level;
+
+        current_generations[i]  = textures[i]->generation;
+        textures[i]->generation = INVALID_ID;
+
+        // Take a copy of the name.
+        string_ncopy(temp_texture->name, texture_names[i], TEXTURE_NAME_MAX_LENGTH);
+        temp_texture->generation       = INVALID_ID;
+        temp_texture->has_transparency = resource_data[i]->has_transparency;
+
+        temp_pointers[i] = temp_texture;
+        if (image->mip_count)
+        {
+            mips[i] = &image->mip_pixels[level];
+        }
+        else
+        {
+            // Images made without mip levels.
+            mips[i] = (const u8 **)&image->pixels;
+        }
     }
-    else
+
+    // Acquire internal texture resources and upload to GPU.
+    renderer_create_textures(count, mips, temp_pointers);
+
+    for (u32 i = 0; i < count; ++i)
     {
-        t->generation = current_generation + 1;
+        texture *t = textures[i];
+
+        // Take a copy of the old texture.
+        texture old = *t;
+
+        // Assign the temp texture to the pointer.
+        *t = temp_textures[i];
+
+        // Destroy the old texture. Freshly reserved slots have nothing to destroy.
+        if (old.internal_data)
+        {
+            renderer_destroy_texture(&old);
+        }
+
+        if (current_generations[i] == INVALID_ID)
+        {
+            t->generation = 0;
+        }
+        else
+        {
+            t->generation = current_generations[i] + 1;
+        }
     }
 
-    // Clean up data.
-    resource_system_unload(&img_resource);
-    return true;
+    dfree(temp_textures, sizeof(texture) * count, MEMORY_TAG_TEXTURE);
+    dfree(temp_pointers, sizeof(texture *) * count, MEMORY_TAG_TEXTURE);
+    dfree(mips, sizeof(const u8 **) * count, MEMORY_TAG_TEXTURE);
+    dfree(current_generations, sizeof(u32) * count, MEMORY_TAG_TEXTURE);
 }
 
 void destroy_texture(texture *t)
@@ -366,6 +931,14 @@ void destroy_texture(texture *t)
     // Clean up backend resources.
     renderer_destroy_texture(t);
 
+    texture_streaming_entry *entry = streaming_entry(t);
+    if (entry)
+    {
+        dzero_memory(entry, sizeof(texture_streaming_entry));
+        // A load still in flight finds the slot released once it completes.
+        state_ptr->loading[t - state_ptr->registered_textures] = 0;
+    }
+
     dzero_memory(t->name, sizeof(char) * TEXTURE_NAME_MAX_LENGTH);
     dzero_memory(t, sizeof(texture));
     t->id         = INVALID_ID;
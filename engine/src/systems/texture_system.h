@@ -5,6 +5,9 @@
 typedef struct texture_system_config
 {
     u32 max_texture_count;
+    // The most GPU memory, in bytes, the mip levels of cooked textures may take. Cooked textures are first
+    // uploaded small, then finer levels are streamed in as they are drawn larger. 0 uploads every level at once.
+    u64 streaming_budget;
 } texture_system_config;
 
 #define DEFAULT_TEXTURE_NAME "default"
@@ -13,6 +16,74 @@ b8 texture_system_initialize(u64 *memory_requirement, void *state, texture_syste
 void texture_system_shutdown(void *state);
 
 texture *texture_system_acquire(const char *name, b8 auto_release);
+
+/**
+ * @brief Like texture_system_acquire, but a texture that is not yet loaded is loaded in the
+ * background. The returned texture keeps an invalid generation, so the renderer draws the
+ * default texture in its place until the load completes.
+ *
+ * @param name The name of the texture to acquire.
+ * @param auto_release Indicates if the texture should be unloaded when its reference count reaches 0.
+ * @return A pointer to the texture, or nullptr if no slot is available.
+ */
+texture *texture_system_acquire_async(const char *name, b8 auto_release);
+
+/**
+ * @brief Invoked on the main thread once a texture acquired with texture_system_acquire_async_notify
+ * is ready to use. On failure the texture keeps an invalid generation, so the default texture is drawn
+ * in its place, but the reference is still held. t is nullptr if the texture was released while loading.
+ */
+typedef void (*PFN_texture_loaded)(b8 success, texture *t, void *user_data);
+
+/**
+ * @brief Like texture_system_acquire_async, but invokes callback once the texture has been uploaded.
+ * If the texture is already loaded, callback is invoked with success before this returns. If it is
+ * already being loaded by another acquire, callback is invoked once that load completes.
+ *
+ * @param name The name of the texture to acquire.
+ * @param auto_release Indicates if the texture should be unloaded when its reference count reaches 0.
+ * @param callback The function invoked once the texture is ready. Required.
+ * @param user_data Passed as-is to callback. Can be 0/NULL.
+ * @return A pointer to the texture, or nullptr if it could not be acquired, in which case callback is never invoked.
+ */
+texture *texture_system_acquire_async_notify(const char *name, b8 auto_release, PFN_texture_loaded callback,
+                                             void *user_data);
+
+/**
+ * @brief Acquires several textures at once. Images not yet loaded are decoded in parallel
+ * on the job system, then uploaded together. Must be called from the main thread.
+ *
+ * @param count The number of textures to acquire.
+ * @param names An array of count texture names.
+ * @param auto_release Indicates if the textures should be unloaded when their reference count reaches 0.
+ * @param out_textures An array of count texture pointers to be filled in. Entries that fail to load are set to nullptr.
+ * @return True if every texture was acquired; otherwise false.
+ */
+b8 texture_system_acquire_many(u32 count, const char **names, b8 auto_release, texture **out_textures);
 void texture_system_release(const char *name);
 
+/**
+ * @brief Reloads a loaded texture's image in the background. The current image stays in use until
+ * the new one is uploaded in its place, which bumps the generation so the renderer rebinds it.
+ *
+ * @param name The name of the texture to reload.
+ * @return True if a reload was started; false if the texture is not loaded or the load could not start.
+ */
+b8 texture_system_reload(const char *name);
+
+/**
+ * @brief Reports how large a texture is being drawn this frame, so the mip levels it needs can be streamed
+ * in. Called by the renderer for each texture it draws.
+ *
+ * @param t The texture being drawn.
+ * @param screen_size Roughly how large the texture appears on screen, in pixels across.
+ */
+void texture_system_report_usage(texture *t, f32 screen_size);
+
+/**
+ * @brief Starts streaming mip levels in or out, based on how textures were drawn since the last call.
+ * Should be called once per frame from the main thread, while nothing is being drawn.
+ */
+void texture_system_update();
+
 texture *texture_system_get_default_texture();
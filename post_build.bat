@@ -14,4 +14,10 @@ IF %ERRORLEVEL% NEQ 0 (echo Error: %ERRORLEVEL% && exit)
 echo "Copying assets..."
 echo xcopy "assets" "bin\assets" /h /i /c /k /e /r /y
 xcopy "assets" "bin\assets" /h /i /c /k /e /r /y
+echo "Cooking assets..."
+bin\cook.exe bin\assets
+IF %ERRORLEVEL% NEQ 0 (echo Error: %ERRORLEVEL% && exit)
+echo "Packing assets..."
+bin\pack.exe bin\assets bin\assets.dpk
+IF %ERRORLEVEL% NEQ 0 (echo Error: %ERRORLEVEL% && exit)
 echo "Done."
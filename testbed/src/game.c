@@ -72,8 +72,9 @@ b8 game_update(game *game_inst, f32 delta_time)
     if (input_is_key_up('T') && input_was_key_down('T'))
     {
         DDEBUG("Swapping texture!");
+        // Posted, so the swap happens between frames rather than while one is drawn.
         event_context context = {};
-        event_fire(EVENT_CODE_DEBUG0, game_inst, context);
+        event_post(EVENT_CODE_DEBUG0, game_inst, context);
     }
     // TODO: end temp
 
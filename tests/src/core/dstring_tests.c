@@ -0,0 +1,73 @@
+#include "dstring_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dstring.h>
+#include <defines.h>
+
+b8 string_view_should_iterate_lines()
+{
+    const char text[]     = "first\r\n\n  third  \nlast";
+    string_view remaining = string_view_create(text, sizeof(text) - 1);
+    string_view line;
+
+    expect_to_be_true(string_view_next_line(&remaining, &line));
+    expect_to_be_true(string_view_equali(line, "first"));
+    expect_to_be_true(string_view_next_line(&remaining, &line));
+    expect_should_be(0, line.length);
+    expect_to_be_true(string_view_next_line(&remaining, &line));
+    expect_to_be_true(string_view_equali(string_view_trim(line), "third"));
+    expect_to_be_true(string_view_next_line(&remaining, &line));
+    expect_to_be_true(string_view_equali(line, "LAST"));
+    expect_to_be_false(string_view_next_line(&remaining, &line));
+
+    return true;
+}
+
+b8 string_view_should_iterate_tokens()
+{
+    const char text[]     = "  1.0 2.5\t-3  ";
+    string_view remaining = string_view_create(text, sizeof(text) - 1);
+    string_view token;
+    char buffer[16];
+
+    expect_to_be_true(string_view_next_token(&remaining, &token));
+    expect_should_be(3, string_view_copy(buffer, token, sizeof(buffer) - 1));
+    expect_to_be_true(strings_equal(buffer, "1.0"));
+    expect_to_be_true(string_view_next_token(&remaining, &token));
+    expect_to_be_true(string_view_equali(token, "2.5"));
+    expect_to_be_true(string_view_next_token(&remaining, &token));
+    expect_to_be_true(string_view_equali(token, "-3"));
+    expect_to_be_false(string_view_next_token(&remaining, &token));
+
+    return true;
+}
+
+b8 string_view_should_split_and_clamp()
+{
+    string_view line = string_view_create("name = test_material", 20);
+    s64 equal_index  = string_view_index_of(line, '=');
+    expect_should_be(5, equal_index);
+    expect_should_be(-1, string_view_index_of(line, '#'));
+
+    string_view var_name = string_view_trim(string_view_mid(line, 0, equal_index));
+    string_view value    = string_view_trim(string_view_mid(line, equal_index + 1, -1));
+    expect_to_be_true(string_view_equali(var_name, "name"));
+    expect_to_be_true(string_view_equali(value, "test_material"));
+
+    // Out of range slices are clamped, and copies truncated.
+    expect_should_be(0, string_view_mid(line, 100, 5).length);
+    expect_should_be(4, string_view_mid(line, 16, 50).length);
+    char buffer[5];
+    expect_should_be(4, string_view_copy(buffer, value, sizeof(buffer) - 1));
+    expect_to_be_true(strings_equal(buffer, "test"));
+
+    return true;
+}
+
+void dstring_register_tests()
+{
+    test_manager_register_test(string_view_should_iterate_lines, "String view should iterate lines");
+    test_manager_register_test(string_view_should_iterate_tokens, "String view should iterate tokens");
+    test_manager_register_test(string_view_should_split_and_clamp, "String view should split and clamp");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void dstring_register_tests();
@@ -0,0 +1,139 @@
+#include "event_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dmemory.h>
+#include <core/event.h>
+#include <defines.h>
+#include <platform/platform.h>
+
+#define EVENT_TEST_CODE 0x100
+#define EVENT_TEST_THREAD_COUNT 4
+#define EVENT_TEST_POSTS_PER_THREAD 500
+
+typedef struct event_test_listener
+{
+    u32 fired_count;
+    u32 last_value;
+    u64 value_sum;
+} event_test_listener;
+
+static b8 on_test_event(u16 code, void *sender, void *listener_inst, event_context data)
+{
+    event_test_listener *listener = listener_inst;
+    listener->fired_count++;
+    listener->last_value = data.data.u32[0];
+    listener->value_sum += data.data.u32[0];
+    return true;
+}
+
+static u32 thread_post_events(void *params)
+{
+    u32 thread_index = *(u32 *)params;
+    for (u32 i = 0; i < EVENT_TEST_POSTS_PER_THREAD; ++i)
+    {
+        event_context context = {0};
+        context.data.u32[0]   = thread_index * EVENT_TEST_POSTS_PER_THREAD + i;
+        event_post(EVENT_TEST_CODE, 0, context);
+    }
+    return 0;
+}
+
+static void *event_test_startup()
+{
+    u64 memory_requirement = 0;
+    event_system_initialize(&memory_requirement, 0);
+    void *state = dallocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    event_system_initialize(&memory_requirement, state);
+    return state;
+}
+
+static void event_test_shutdown(void *state)
+{
+    u64 memory_requirement = 0;
+    event_system_initialize(&memory_requirement, 0);
+    event_system_shutdown(state);
+    dfree(state, memory_requirement, MEMORY_TAG_APPLICATION);
+}
+
+b8 event_post_should_defer_until_dispatch()
+{
+    void *state                  = event_test_startup();
+    event_test_listener listener = {0};
+    expect_to_be_true(event_register(EVENT_TEST_CODE, &listener, on_test_event));
+
+    event_context context = {0};
+    context.data.u32[0]   = 7;
+    expect_to_be_true(event_post(EVENT_TEST_CODE, 0, context));
+    expect_should_be(0, listener.fired_count);
+
+    event_dispatch_posted();
+    expect_should_be(1, listener.fired_count);
+    expect_should_be(7, listener.last_value);
+
+    // Nothing is left over for the next dispatch.
+    event_dispatch_posted();
+    expect_should_be(1, listener.fired_count);
+
+    event_test_shutdown(state);
+    return true;
+}
+
+b8 event_post_should_coalesce_mouse_moves()
+{
+    void *state                  = event_test_startup();
+    event_test_listener listener = {0};
+    expect_to_be_true(event_register(EVENT_CODE_MOUSE_MOVED, &listener, on_test_event));
+
+    for (u32 i = 1; i <= 10; ++i)
+    {
+        event_context context = {0};
+        context.data.u32[0]   = i;
+        event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
+    }
+
+    event_dispatch_posted();
+    expect_should_be(1, listener.fired_count);
+    expect_should_be(10, listener.last_value);
+
+    event_test_shutdown(state);
+    return true;
+}
+
+b8 event_post_should_deliver_from_all_threads()
+{
+    void *state                  = event_test_startup();
+    event_test_listener listener = {0};
+    expect_to_be_true(event_register(EVENT_TEST_CODE, &listener, on_test_event));
+
+    platform_thread threads[EVENT_TEST_THREAD_COUNT];
+    u32 indices[EVENT_TEST_THREAD_COUNT];
+    for (u32 i = 0; i < EVENT_TEST_THREAD_COUNT; ++i)
+    {
+        indices[i] = i;
+        expect_to_be_true(platform_thread_create(thread_post_events, &indices[i], &threads[i]));
+    }
+    for (u32 i = 0; i < EVENT_TEST_THREAD_COUNT; ++i)
+    {
+        platform_thread_join(&threads[i]);
+    }
+
+    event_dispatch_posted();
+
+    // Every value from 0 to total - 1 is posted exactly once.
+    u64 total = EVENT_TEST_THREAD_COUNT * EVENT_TEST_POSTS_PER_THREAD;
+    expect_should_be(total, listener.fired_count);
+    expect_should_be(total * (total - 1) / 2, listener.value_sum);
+
+    event_test_shutdown(state);
+    return true;
+}
+
+void event_register_tests()
+{
+    test_manager_register_test(event_post_should_defer_until_dispatch, "Posted events should fire only on dispatch");
+    test_manager_register_test(event_post_should_coalesce_mouse_moves,
+                               "Posted mouse moves should coalesce into the latest");
+    test_manager_register_test(event_post_should_deliver_from_all_threads,
+                               "Events posted from several threads should all be delivered");
+}
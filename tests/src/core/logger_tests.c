@@ -0,0 +1,161 @@
+#include "logger_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dmemory.h>
+#include <core/dstring.h>
+#include <core/logger.h>
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <platform/platform.h>
+
+b8 rate_limit_should_allow_burst_then_suppress()
+{
+    log_rate_limit limit = {0};
+    u32 suppressed       = 0;
+
+    for (u32 i = 0; i < 3; ++i)
+    {
+        expect_to_be_true(log_rate_limit_allow(&limit, 3, 60000, &suppressed));
+        expect_should_be(0, suppressed);
+    }
+    for (u32 i = 0; i < 10; ++i)
+    {
+        expect_to_be_false(log_rate_limit_allow(&limit, 3, 60000, &suppressed));
+    }
+    expect_should_be(10, limit.suppressed);
+
+    return true;
+}
+
+b8 rate_limit_should_report_suppressed_count_in_next_interval()
+{
+    log_rate_limit limit = {0};
+    u32 suppressed       = 0;
+
+    expect_to_be_true(log_rate_limit_allow(&limit, 1, 20, &suppressed));
+    expect_to_be_false(log_rate_limit_allow(&limit, 1, 20, &suppressed));
+    expect_to_be_false(log_rate_limit_allow(&limit, 1, 20, &suppressed));
+
+    platform_sleep(30);
+
+    expect_to_be_true(log_rate_limit_allow(&limit, 1, 20, &suppressed));
+    expect_should_be(2, suppressed);
+
+    // Reported once only.
+    platform_sleep(30);
+    expect_to_be_true(log_rate_limit_allow(&limit, 1, 20, &suppressed));
+    expect_should_be(0, suppressed);
+
+    return true;
+}
+
+// Counts the lines of console.log equal to line.
+static u32 count_log_lines(const char *line)
+{
+    file_mapping mapping;
+    if (!filesystem_map("console.log", &mapping))
+    {
+        return 0;
+    }
+    u32 count             = 0;
+    string_view remaining = string_view_create(mapping.data, mapping.size);
+    string_view current;
+    while (string_view_next_line(&remaining, &current))
+    {
+        if (current.length == string_length(line) && string_view_equali(current, line))
+        {
+            count++;
+        }
+    }
+    filesystem_unmap(&mapping);
+    return count;
+}
+
+b8 rate_limit_should_report_suppressed_count_when_call_site_goes_quiet()
+{
+    u64 memory_requirement = 0;
+    initialize_logging(&memory_requirement, 0);
+    void *state = dallocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(initialize_logging(&memory_requirement, state));
+
+    // Nothing logs from this call site afterwards, so the writer reports the count at shutdown.
+    for (u32 i = 0; i < LOG_RATE_LIMIT_BURST + 3; ++i)
+    {
+        DLOG_RATE_LIMITED(LOG_LEVEL_INFO, "Flooding %u", i);
+    }
+    shutdown_logging(state);
+    dfree(state, memory_requirement, MEMORY_TAG_APPLICATION);
+
+    expect_should_be(1, count_log_lines("[INFO]:  Flooding 0"));
+    expect_should_be(0, count_log_lines("[INFO]:  Flooding 5"));
+    expect_should_be(1, count_log_lines("[INFO]:  3 messages like \"Flooding %u\" were suppressed."));
+
+    return true;
+}
+
+typedef struct decoded_messages
+{
+    u32 count;
+    log_level levels[4];
+    char text[4][128];
+} decoded_messages;
+
+static void on_message_decoded(f64 timestamp, log_level level, const char *message, void *user_data)
+{
+    decoded_messages *decoded = user_data;
+    if (decoded->count < 4)
+    {
+        decoded->levels[decoded->count] = level;
+        string_ncopy(decoded->text[decoded->count], message, 127);
+    }
+    decoded->count++;
+}
+
+b8 binary_log_should_decode_what_was_logged()
+{
+    u64 memory_requirement = 0;
+    initialize_logging(&memory_requirement, 0);
+    void *state = dallocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(initialize_logging(&memory_requirement, state));
+
+    // The second message at a call site only records its arguments.
+    for (s32 i = 0; i < 2; ++i)
+    {
+        DLOG_BINARY(LOG_LEVEL_WARN, "Entry %d of %u: %s, %.2f", i - 1, 2u, "text", 1.5f);
+    }
+    DLOG_BINARY(LOG_LEVEL_INFO, "No arguments, 100%%");
+    log_binary_flush();
+    shutdown_logging(state);
+    dfree(state, memory_requirement, MEMORY_TAG_APPLICATION);
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map("console.blog", &mapping));
+    decoded_messages decoded = {0};
+    expect_to_be_true(log_binary_decode(mapping.data, mapping.size, on_message_decoded, &decoded));
+    filesystem_unmap(&mapping);
+
+    expect_should_be(3, decoded.count);
+    expect_should_be(LOG_LEVEL_WARN, decoded.levels[0]);
+    expect_to_be_true(strings_equal(decoded.text[0], "Entry -1 of 2: text, 1.50"));
+    expect_to_be_true(strings_equal(decoded.text[1], "Entry 0 of 2: text, 1.50"));
+    expect_should_be(LOG_LEVEL_INFO, decoded.levels[2]);
+    expect_to_be_true(strings_equal(decoded.text[2], "No arguments, 100%"));
+
+    // Anything else is rejected.
+    expect_to_be_false(log_binary_decode("not a log", 9, on_message_decoded, &decoded));
+
+    return true;
+}
+
+void logger_register_tests()
+{
+    test_manager_register_test(rate_limit_should_allow_burst_then_suppress,
+                               "Rate limit should allow a burst, then suppress");
+    test_manager_register_test(rate_limit_should_report_suppressed_count_in_next_interval,
+                               "Rate limit should report the suppressed count in the next interval");
+    test_manager_register_test(rate_limit_should_report_suppressed_count_when_call_site_goes_quiet,
+                               "Rate limit should report the suppressed count when the call site goes quiet");
+    test_manager_register_test(binary_log_should_decode_what_was_logged,
+                               "Binary log should decode what was logged");
+}
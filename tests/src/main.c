@@ -1,5 +1,16 @@
 #include "containers/hashtable_tests.h"
+#include "core/dstring_tests.h"
+#include "core/event_tests.h"
+#include "core/logger_tests.h"
 #include "memory/linear_allocator_tests.h"
+#include "platform/filesystem_tests.h"
+#include "platform/threading_tests.h"
+#include "resources/material_file_tests.h"
+#include "resources/mesh_file_tests.h"
+#include "resources/resource_pack_tests.h"
+#include "resources/texture_file_tests.h"
+#include "systems/resource_system_tests.h"
+#include "systems/texture_streaming_tests.h"
 #include "test_manager.h"
 
 #include <core/logger.h>
@@ -11,6 +22,17 @@ int main()
 
     linear_allocator_register_tests();
     hashtable_register_tests();
+    threading_register_tests();
+    event_register_tests();
+    dstring_register_tests();
+    logger_register_tests();
+    filesystem_register_tests();
+    resource_pack_register_tests();
+    texture_file_register_tests();
+    material_file_register_tests();
+    mesh_file_register_tests();
+    resource_system_register_tests();
+    texture_streaming_register_tests();
 
     test_manager_run_tests();
 
@@ -0,0 +1,371 @@
+#include "filesystem_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dmemory.h>
+#include <core/dstring.h>
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <platform/platform.h>
+
+#define WRITER_TEST_PATH "filesystem_writer_test.bin"
+
+// Returns how many bytes have actually reached the file.
+static u64 size_on_disk(const char *path)
+{
+    file_handle handle;
+    u64 size = 0;
+    if (filesystem_open(path, FILE_MODE_READ, true, &handle))
+    {
+        filesystem_size(&handle, &size);
+        filesystem_close(&handle);
+    }
+    return size;
+}
+
+b8 writer_should_write_out_when_full()
+{
+    file_writer_config config = {0};
+    config.buffer_size        = 16;
+    config.flush_policy       = FILE_FLUSH_ON_SIZE;
+    file_writer writer;
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+
+    u8 data[40] = {0};
+    expect_to_be_true(filesystem_writer_write(&writer, 10, data));
+    expect_should_be(0, size_on_disk(WRITER_TEST_PATH));
+
+    // Does not fit, so the first 10 bytes are written out.
+    expect_to_be_true(filesystem_writer_write(&writer, 10, data));
+    expect_should_be(10, size_on_disk(WRITER_TEST_PATH));
+
+    // Larger than the whole buffer, so written straight through after what was buffered.
+    expect_to_be_true(filesystem_writer_write(&writer, 40, data));
+    expect_should_be(60, size_on_disk(WRITER_TEST_PATH));
+
+    filesystem_writer_close(&writer);
+    expect_should_be(60, size_on_disk(WRITER_TEST_PATH));
+    expect_to_be_false(writer.is_valid);
+
+    return true;
+}
+
+b8 writer_should_hold_everything_until_close()
+{
+    file_writer_config config = {0};
+    config.buffer_size        = 8;
+    config.flush_policy       = FILE_FLUSH_ON_CLOSE | FILE_FLUSH_ON_FATAL;
+    file_writer writer;
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+
+    u8 data[100];
+    for (u32 i = 0; i < 100; ++i)
+    {
+        data[i] = (u8)i;
+    }
+    for (u32 i = 0; i < 10; ++i)
+    {
+        expect_to_be_true(filesystem_writer_write(&writer, 10, data + i * 10));
+    }
+    expect_should_be(0, size_on_disk(WRITER_TEST_PATH));
+    expect_to_be_true(writer.capacity >= 100);
+
+    expect_to_be_true(filesystem_writer_notify_fatal(&writer));
+    expect_should_be(100, size_on_disk(WRITER_TEST_PATH));
+    filesystem_writer_close(&writer);
+
+    // Make sure the bytes survived the buffer growing.
+    file_handle handle;
+    u8 read_back[100] = {0};
+    u64 read          = 0;
+    expect_to_be_true(filesystem_open(WRITER_TEST_PATH, FILE_MODE_READ, true, &handle));
+    expect_to_be_true(filesystem_read(&handle, 100, read_back, &read));
+    filesystem_close(&handle);
+    for (u32 i = 0; i < 100; ++i)
+    {
+        expect_should_be(i, read_back[i]);
+    }
+
+    return true;
+}
+
+b8 writer_should_write_out_after_interval()
+{
+    file_writer_config config = {0};
+    config.flush_policy       = FILE_FLUSH_ON_SIZE | FILE_FLUSH_ON_INTERVAL;
+    config.flush_interval_ms  = 20;
+    file_writer writer;
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+
+    u8 data[10] = {0};
+    expect_to_be_true(filesystem_writer_write(&writer, 10, data));
+    expect_to_be_true(filesystem_writer_update(&writer));
+    expect_should_be(0, size_on_disk(WRITER_TEST_PATH));
+
+    platform_sleep(30);
+    expect_to_be_true(filesystem_writer_update(&writer));
+    expect_should_be(10, size_on_disk(WRITER_TEST_PATH));
+
+    // Fatal errors are not part of this policy.
+    expect_to_be_true(filesystem_writer_write(&writer, 10, data));
+    expect_to_be_true(filesystem_writer_notify_fatal(&writer));
+    expect_should_be(10, size_on_disk(WRITER_TEST_PATH));
+
+    filesystem_writer_close(&writer);
+    expect_should_be(20, size_on_disk(WRITER_TEST_PATH));
+
+    return true;
+}
+
+b8 map_should_view_file_contents()
+{
+    file_writer_config config = {0};
+    file_writer writer;
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+    const char text[] = "mapped contents";
+    expect_to_be_true(filesystem_writer_write(&writer, sizeof(text), text));
+    filesystem_writer_close(&writer);
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(WRITER_TEST_PATH, &mapping));
+    expect_should_be(sizeof(text), mapping.size);
+    for (u32 i = 0; i < sizeof(text); ++i)
+    {
+        expect_should_be(text[i], ((const char *)mapping.data)[i]);
+    }
+    filesystem_unmap(&mapping);
+    expect_should_be(0, mapping.data);
+
+    // Empty files map to an empty view.
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+    filesystem_writer_close(&writer);
+    expect_to_be_true(filesystem_map(WRITER_TEST_PATH, &mapping));
+    expect_should_be(0, mapping.size);
+    filesystem_unmap(&mapping);
+
+    return true;
+}
+
+b8 writer_should_replace_the_file_on_close()
+{
+    file_writer_config config = {0};
+    file_writer writer;
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+    expect_to_be_true(filesystem_writer_write(&writer, 4, "old!"));
+    filesystem_writer_close(&writer);
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(WRITER_TEST_PATH, &mapping));
+
+    // The file stays as it was until the writer closes, after which a mapping of it still sees the old contents.
+    config.replace_on_close = true;
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+    expect_to_be_true(filesystem_writer_write(&writer, 6, "newer!"));
+    expect_to_be_true(filesystem_writer_flush(&writer));
+    expect_should_be(4, size_on_disk(WRITER_TEST_PATH));
+    filesystem_writer_close(&writer);
+    expect_should_be(6, size_on_disk(WRITER_TEST_PATH));
+    expect_to_be_false(filesystem_exists(WRITER_TEST_PATH ".tmp"));
+    expect_should_be(4, mapping.size);
+    expect_should_be('o', ((const char *)mapping.data)[0]);
+    filesystem_unmap(&mapping);
+
+    // A failed write leaves the file alone.
+    expect_to_be_true(filesystem_writer_open(WRITER_TEST_PATH, true, config, &writer));
+    writer.failed = true;
+    filesystem_writer_close(&writer);
+    expect_should_be(6, size_on_disk(WRITER_TEST_PATH));
+    expect_to_be_false(filesystem_exists(WRITER_TEST_PATH ".tmp"));
+
+    // Failing to open frees the paths.
+    expect_to_be_false(filesystem_writer_open("missing_directory/" WRITER_TEST_PATH, true, config, &writer));
+    expect_should_be(0, writer.path);
+    expect_should_be(0, writer.temp_path);
+
+    return true;
+}
+
+static b8 write_test_file(const char *path, u64 size)
+{
+    file_writer_config config = {0};
+    file_writer writer;
+    if (!filesystem_writer_open(path, true, config, &writer))
+    {
+        return false;
+    }
+    for (u64 i = 0; i < size; ++i)
+    {
+        u8 value = (u8)(i * 7);
+        filesystem_writer_write(&writer, 1, &value);
+    }
+    filesystem_writer_close(&writer);
+    return true;
+}
+
+b8 read_batch_should_read_every_file()
+{
+    expect_to_be_true(write_test_file("read_batch_test_0.bin", 100000));
+    expect_to_be_true(write_test_file("read_batch_test_1.bin", 0));
+    expect_to_be_true(write_test_file("read_batch_test_2.bin", 300));
+
+    u8 partial[64];
+    file_read_request requests[4] = {0};
+    requests[0].path              = "read_batch_test_0.bin";
+    requests[1].path              = "read_batch_test_1.bin";
+    requests[2].path              = "read_batch_test_2.bin";
+    requests[2].buffer            = partial;
+    requests[2].buffer_size       = sizeof(partial);
+    requests[3].path              = "read_batch_test_missing.bin";
+
+    // One file is missing, so the batch as a whole fails while the others still succeed.
+    expect_to_be_false(filesystem_read_batch(4, requests));
+
+    expect_to_be_true(requests[0].success);
+    expect_should_be(100000, requests[0].bytes_read);
+    expect_should_be(100000, requests[0].buffer_size);
+    for (u64 i = 0; i < 100000; ++i)
+    {
+        expect_should_be((u8)(i * 7), ((u8 *)requests[0].buffer)[i]);
+    }
+    dfree(requests[0].buffer, requests[0].buffer_size, MEMORY_TAG_ARRAY);
+
+    expect_to_be_true(requests[1].success);
+    expect_should_be(0, requests[1].bytes_read);
+
+    // Stops at the end of the caller's buffer.
+    expect_to_be_true(requests[2].success);
+    expect_should_be(sizeof(partial), requests[2].bytes_read);
+    expect_should_be((u8)(63 * 7), partial[63]);
+
+    expect_to_be_false(requests[3].success);
+
+    return true;
+}
+
+#define READ_AT_THREAD_COUNT 4
+#define READ_AT_REGION_SIZE 25000
+
+typedef struct read_at_region
+{
+    file_handle *handle;
+    u64 offset;
+    b8 matches;
+} read_at_region;
+
+// Reads one region of the shared handle, and checks it against what write_test_file wrote.
+static u32 read_region(void *params)
+{
+    read_at_region *region = params;
+    u8 *data               = dallocate(READ_AT_REGION_SIZE, MEMORY_TAG_ARRAY);
+    u64 read               = 0;
+    region->matches        = filesystem_read_at(region->handle, region->offset, READ_AT_REGION_SIZE, data, &read) &&
+                      read == READ_AT_REGION_SIZE;
+    for (u64 i = 0; i < READ_AT_REGION_SIZE && region->matches; ++i)
+    {
+        region->matches = data[i] == (u8)((region->offset + i) * 7);
+    }
+    dfree(data, READ_AT_REGION_SIZE, MEMORY_TAG_ARRAY);
+    return 0;
+}
+
+b8 read_at_should_read_regions_in_parallel()
+{
+    expect_to_be_true(write_test_file("read_at_test.bin", READ_AT_THREAD_COUNT * READ_AT_REGION_SIZE));
+
+    file_handle handle;
+    expect_to_be_true(filesystem_open("read_at_test.bin", FILE_MODE_READ, true, &handle));
+
+    // Neither the size nor positional reads move the stream.
+    u64 size = 0;
+    expect_to_be_true(filesystem_size(&handle, &size));
+    expect_should_be(READ_AT_THREAD_COUNT * READ_AT_REGION_SIZE, size);
+    u8 first[4];
+    u64 read = 0;
+    expect_to_be_true(filesystem_read(&handle, 2, first, &read));
+    expect_to_be_true(filesystem_read_at(&handle, 100, 2, first + 2, &read));
+    expect_to_be_true(filesystem_read(&handle, 1, first + 3, &read));
+    expect_should_be((u8)(1 * 7), first[1]);
+    expect_should_be((u8)(100 * 7), first[2]);
+    // Carries on from where the stream was.
+    expect_should_be((u8)(2 * 7), first[3]);
+
+    // Reading past the end stops there.
+    expect_to_be_false(filesystem_read_at(&handle, size - 2, 4, first, &read));
+    expect_should_be(2, read);
+
+    read_at_region regions[READ_AT_THREAD_COUNT];
+    platform_thread threads[READ_AT_THREAD_COUNT];
+    for (u32 i = 0; i < READ_AT_THREAD_COUNT; ++i)
+    {
+        regions[i].handle  = &handle;
+        regions[i].offset  = (u64)i * READ_AT_REGION_SIZE;
+        regions[i].matches = false;
+        expect_to_be_true(platform_thread_create(read_region, &regions[i], &threads[i]));
+    }
+    for (u32 i = 0; i < READ_AT_THREAD_COUNT; ++i)
+    {
+        platform_thread_join(&threads[i]);
+        expect_to_be_true(regions[i].matches);
+    }
+
+    filesystem_close(&handle);
+    return true;
+}
+
+// Counts reports of the file written by watcher_should_report_written_files.
+static void on_watched_file_changed(const char *path, void *user_data)
+{
+    if (strings_equal(path, "watcher_test.txt"))
+    {
+        (*(u32 *)user_data)++;
+    }
+}
+
+b8 watcher_should_report_written_files()
+{
+    file_watcher watcher;
+    expect_to_be_true(filesystem_watcher_create(".", &watcher));
+
+    // Nothing has changed yet.
+    u32 reports = 0;
+    filesystem_watcher_poll(&watcher, on_watched_file_changed, &reports);
+    expect_should_be(0, reports);
+
+    file_writer_config config = {0};
+    file_writer writer;
+    expect_to_be_true(filesystem_writer_open("watcher_test.txt", false, config, &writer));
+    expect_to_be_true(filesystem_writer_write(&writer, 5, "hello"));
+    filesystem_writer_close(&writer);
+
+    // Reported once the file is closed, and only once.
+    for (u32 attempt = 0; attempt < 100 && reports == 0; ++attempt)
+    {
+        filesystem_watcher_poll(&watcher, on_watched_file_changed, &reports);
+        if (reports == 0)
+        {
+            platform_sleep(10);
+        }
+    }
+    expect_should_be(1, reports);
+    filesystem_watcher_poll(&watcher, on_watched_file_changed, &reports);
+    expect_should_be(1, reports);
+
+    filesystem_watcher_destroy(&watcher);
+    expect_should_be(0, watcher.internal_data);
+
+    return true;
+}
+
+void filesystem_register_tests()
+{
+    test_manager_register_test(writer_should_write_out_when_full, "File writer should write out when full");
+    test_manager_register_test(writer_should_hold_everything_until_close,
+                               "File writer should hold everything until close");
+    test_manager_register_test(writer_should_write_out_after_interval,
+                               "File writer should write out after the interval");
+    test_manager_register_test(writer_should_replace_the_file_on_close, "File writer should replace the file on close");
+    test_manager_register_test(map_should_view_file_contents, "File mapping should view the file's contents");
+    test_manager_register_test(read_batch_should_read_every_file, "Batched reads should read every file");
+    test_manager_register_test(read_at_should_read_regions_in_parallel,
+                               "Positional reads should read regions in parallel");
+    test_manager_register_test(watcher_should_report_written_files, "File watcher should report written files");
+}
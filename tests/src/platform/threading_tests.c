@@ -0,0 +1,205 @@
+#include "threading_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/datomic.h>
+#include <defines.h>
+#include <platform/platform.h>
+
+#define THREAD_TEST_COUNT 4
+#define THREAD_TEST_ITERATIONS 10000
+
+typedef struct thread_test_state
+{
+    platform_mutex mutex;
+    platform_semaphore semaphore;
+    platform_condition condition;
+    u64 counter;
+    b8 ready;
+} thread_test_state;
+
+static u32 thread_set_flag(void *params)
+{
+    *(u32 *)params = 42;
+    return 0;
+}
+
+static u32 thread_increment_locked(void *params)
+{
+    thread_test_state *state = params;
+    for (u32 i = 0; i < THREAD_TEST_ITERATIONS; ++i)
+    {
+        platform_mutex_lock(&state->mutex);
+        state->counter++;
+        platform_mutex_unlock(&state->mutex);
+    }
+    return 0;
+}
+
+static u32 thread_increment_atomic(void *params)
+{
+    thread_test_state *state = params;
+    for (u32 i = 0; i < THREAD_TEST_ITERATIONS; ++i)
+    {
+        datomic_fetch_add(&state->counter, 1, DATOMIC_RELAXED);
+    }
+    return 0;
+}
+
+static u32 thread_signal_semaphore(void *params)
+{
+    thread_test_state *state = params;
+    for (u32 i = 0; i < THREAD_TEST_ITERATIONS; ++i)
+    {
+        platform_semaphore_signal(&state->semaphore);
+    }
+    return 0;
+}
+
+static u32 thread_wait_condition(void *params)
+{
+    thread_test_state *state = params;
+    platform_mutex_lock(&state->mutex);
+    while (!state->ready)
+    {
+        platform_condition_wait(&state->condition, &state->mutex);
+    }
+    state->counter++;
+    platform_mutex_unlock(&state->mutex);
+    return 0;
+}
+
+b8 thread_should_run_and_join()
+{
+    u32 flag = 0;
+    platform_thread thread;
+    expect_to_be_true(platform_thread_create(thread_set_flag, &flag, &thread));
+    expect_should_not_be(0, thread.internal_data);
+
+    platform_thread_join(&thread);
+    expect_should_be(0, thread.internal_data);
+    expect_should_be(42, flag);
+
+    return true;
+}
+
+b8 mutex_should_serialize_increments()
+{
+    thread_test_state state = {0};
+    expect_to_be_true(platform_mutex_create(&state.mutex));
+
+    platform_thread threads[THREAD_TEST_COUNT];
+    for (u32 i = 0; i < THREAD_TEST_COUNT; ++i)
+    {
+        expect_to_be_true(platform_thread_create(thread_increment_locked, &state, &threads[i]));
+    }
+    for (u32 i = 0; i < THREAD_TEST_COUNT; ++i)
+    {
+        platform_thread_join(&threads[i]);
+    }
+
+    expect_should_be(THREAD_TEST_COUNT * THREAD_TEST_ITERATIONS, state.counter);
+
+    platform_mutex_destroy(&state.mutex);
+    expect_should_be(0, state.mutex.internal_data);
+
+    return true;
+}
+
+b8 atomic_fetch_add_should_not_lose_increments()
+{
+    thread_test_state state = {0};
+
+    platform_thread threads[THREAD_TEST_COUNT];
+    for (u32 i = 0; i < THREAD_TEST_COUNT; ++i)
+    {
+        expect_to_be_true(platform_thread_create(thread_increment_atomic, &state, &threads[i]));
+    }
+    for (u32 i = 0; i < THREAD_TEST_COUNT; ++i)
+    {
+        platform_thread_join(&threads[i]);
+    }
+
+    expect_should_be(THREAD_TEST_COUNT * THREAD_TEST_ITERATIONS, datomic_load(&state.counter, DATOMIC_ACQUIRE));
+
+    return true;
+}
+
+b8 atomic_compare_exchange_should_report_current_value()
+{
+    u32 value    = 5;
+    u32 expected = 4;
+    expect_to_be_false(datomic_compare_exchange(&value, &expected, 10, DATOMIC_SEQ_CST, DATOMIC_RELAXED));
+    expect_should_be(5, expected);
+    expect_should_be(5, value);
+
+    expect_to_be_true(datomic_compare_exchange(&value, &expected, 10, DATOMIC_SEQ_CST, DATOMIC_RELAXED));
+    expect_should_be(10, value);
+    expect_should_be(10, datomic_exchange(&value, 3, DATOMIC_SEQ_CST));
+    expect_should_be(3, value);
+
+    return true;
+}
+
+b8 semaphore_should_count_signals()
+{
+    thread_test_state state = {0};
+    expect_to_be_true(platform_semaphore_create(0, &state.semaphore));
+
+    platform_thread thread;
+    expect_to_be_true(platform_thread_create(thread_signal_semaphore, &state, &thread));
+
+    // Every signal must be matched by exactly one successful wait.
+    for (u32 i = 0; i < THREAD_TEST_ITERATIONS; ++i)
+    {
+        expect_to_be_true(platform_semaphore_wait(&state.semaphore));
+    }
+    platform_thread_join(&thread);
+
+    platform_semaphore_destroy(&state.semaphore);
+    expect_should_be(0, state.semaphore.internal_data);
+
+    return true;
+}
+
+b8 condition_broadcast_should_wake_all_waiters()
+{
+    thread_test_state state = {0};
+    expect_to_be_true(platform_mutex_create(&state.mutex));
+    expect_to_be_true(platform_condition_create(&state.condition));
+
+    platform_thread threads[THREAD_TEST_COUNT];
+    for (u32 i = 0; i < THREAD_TEST_COUNT; ++i)
+    {
+        expect_to_be_true(platform_thread_create(thread_wait_condition, &state, &threads[i]));
+    }
+
+    platform_mutex_lock(&state.mutex);
+    state.ready = true;
+    platform_condition_broadcast(&state.condition);
+    platform_mutex_unlock(&state.mutex);
+
+    for (u32 i = 0; i < THREAD_TEST_COUNT; ++i)
+    {
+        platform_thread_join(&threads[i]);
+    }
+    expect_should_be(THREAD_TEST_COUNT, state.counter);
+
+    platform_condition_destroy(&state.condition);
+    platform_mutex_destroy(&state.mutex);
+
+    return true;
+}
+
+void threading_register_tests()
+{
+    test_manager_register_test(thread_should_run_and_join, "Thread should run its entry point and join");
+    test_manager_register_test(mutex_should_serialize_increments, "Mutex should serialize increments across threads");
+    test_manager_register_test(atomic_fetch_add_should_not_lose_increments,
+                               "Atomic fetch_add should not lose increments across threads");
+    test_manager_register_test(atomic_compare_exchange_should_report_current_value,
+                               "Atomic compare_exchange should report the current value on failure");
+    test_manager_register_test(semaphore_should_count_signals, "Semaphore should count every signal");
+    test_manager_register_test(condition_broadcast_should_wake_all_waiters,
+                               "Condition broadcast should wake all waiters");
+}
@@ -0,0 +1,79 @@
+#include "material_file_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dstring.h>
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <resources/material_file.h>
+
+#define MATERIAL_TEST_SOURCE_PATH "material_file_test.kmt"
+#define MATERIAL_TEST_PATH "material_file_test.dmt"
+
+b8 material_file_should_cook_source_materials()
+{
+    const char *source = "# A test material.\n"
+                         "version = 0.1\n"
+                         "diffuse_colour = 0.5 0.25 1.0 1.0\n"
+                         "diffuse_map_name = cobblestone\n";
+    file_handle handle;
+    expect_to_be_true(filesystem_open(MATERIAL_TEST_SOURCE_PATH, FILE_MODE_WRITE, true, &handle));
+    u64 written = 0;
+    expect_to_be_true(filesystem_write(&handle, string_length(source), source, &written));
+    filesystem_close(&handle);
+
+    expect_to_be_true(material_file_cook(MATERIAL_TEST_SOURCE_PATH, MATERIAL_TEST_PATH));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(MATERIAL_TEST_PATH, &mapping));
+    expect_to_be_true(material_file_is_cooked(mapping.data, mapping.size));
+
+    // Named after the file, since the source does not set a name.
+    material_config config;
+    expect_to_be_true(material_file_read(mapping.data, mapping.size, &config));
+    expect_to_be_true(strings_equal(config.name, "material_file_test"));
+    expect_to_be_true(strings_equal(config.diffuse_map_name, "cobblestone"));
+    expect_to_be_true(config.auto_release);
+    expect_float_to_be(0.5f, config.diffuse_colour.x);
+    expect_float_to_be(0.25f, config.diffuse_colour.y);
+    expect_float_to_be(1.0f, config.diffuse_colour.z);
+
+    // Truncated files are rejected.
+    expect_to_be_false(material_file_read(mapping.data, mapping.size - 1, &config));
+
+    filesystem_unmap(&mapping);
+    return true;
+}
+
+b8 material_file_should_store_repeated_strings_once()
+{
+    material_config config  = {0};
+    config.diffuse_colour.x  = 1.0f;
+    config.diffuse_colour.y  = 1.0f;
+    config.diffuse_colour.z  = 1.0f;
+    config.diffuse_colour.w  = 1.0f;
+    string_copy(config.name, "brick");
+    string_copy(config.diffuse_map_name, "brick");
+    expect_to_be_true(material_file_write(MATERIAL_TEST_PATH, &config));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(MATERIAL_TEST_PATH, &mapping));
+    const material_file_header *header = mapping.data;
+    expect_should_be(sizeof(material_file_header) + sizeof("brick"), header->file_size);
+    expect_should_be(header->name_offset, header->diffuse_map_name_offset);
+
+    material_config read_config;
+    expect_to_be_true(material_file_read(mapping.data, mapping.size, &read_config));
+    expect_to_be_true(strings_equal(read_config.diffuse_map_name, "brick"));
+    expect_to_be_false(read_config.auto_release);
+
+    filesystem_unmap(&mapping);
+    return true;
+}
+
+void material_file_register_tests()
+{
+    test_manager_register_test(material_file_should_cook_source_materials, "Material file should cook source materials");
+    test_manager_register_test(material_file_should_store_repeated_strings_once,
+                               "Material file should store repeated strings once");
+}
@@ -0,0 +1,85 @@
+#include "mesh_file_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dstring.h>
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <resources/mesh_file.h>
+
+#define MESH_TEST_PATH "mesh_file_test.dmsh"
+
+b8 mesh_file_should_round_trip_submeshes()
+{
+    // A quad, and a single triangle with no name, so padding and empty strings are covered.
+    vertex_3d quad_vertices[4];
+    for (u32 i = 0; i < 4; ++i)
+    {
+        quad_vertices[i].position = (vec3){(f32)(i & 1), (f32)(i >> 1), 0};
+        quad_vertices[i].texcoord = (vec2){(f32)(i & 1), (f32)(i >> 1)};
+    }
+    u32 quad_indices[6]            = {0, 1, 2, 2, 1, 3};
+    vertex_3d triangle_vertices[3] = {0};
+    triangle_vertices[2].position  = (vec3){0, 0, 5.0f};
+    u32 triangle_indices[3]        = {0, 1, 2};
+
+    submesh_resource_data submeshes[2] = {0};
+    submeshes[0].vertex_count          = 4;
+    submeshes[0].vertices              = quad_vertices;
+    submeshes[0].index_count           = 6;
+    submeshes[0].indices               = quad_indices;
+    submeshes[0].name                  = "quad";
+    submeshes[0].material_name         = "brick";
+    submeshes[1].vertex_count          = 3;
+    submeshes[1].vertices              = triangle_vertices;
+    submeshes[1].index_count           = 3;
+    submeshes[1].indices               = triangle_indices;
+    submeshes[1].material_name         = "brick";
+    expect_to_be_true(mesh_file_write(MESH_TEST_PATH, 2, submeshes));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(MESH_TEST_PATH, &mapping));
+    expect_to_be_true(mesh_file_is_cooked(mapping.data, mapping.size));
+
+    // The submesh count can be read first, to size the array.
+    u32 count = 0;
+    expect_to_be_true(mesh_file_parse(mapping.data, mapping.size, 0, 0, &count));
+    expect_should_be(2, count);
+
+    submesh_resource_data read[2];
+    expect_to_be_true(mesh_file_parse(mapping.data, mapping.size, 2, read, &count));
+    expect_to_be_true(strings_equal(read[0].name, "quad"));
+    expect_to_be_true(strings_equal(read[0].material_name, "brick"));
+    expect_to_be_true(strings_equal(read[1].name, ""));
+    expect_should_be(4, read[0].vertex_count);
+    expect_should_be(6, read[0].index_count);
+    expect_should_be(3, read[1].vertex_count);
+
+    // Pointers into the file, aligned, rather than copies.
+    const u8 *start = mapping.data;
+    expect_to_be_true((const u8 *)read[1].vertices > start);
+    expect_to_be_true((const u8 *)read[1].vertices < start + mapping.size);
+    expect_should_be(0, ((u64)read[0].vertices) % MESH_FILE_ALIGNMENT);
+    expect_should_be(0, ((u64)read[1].indices) % MESH_FILE_ALIGNMENT);
+    expect_float_to_be(1.0f, read[0].vertices[3].position.x);
+    expect_float_to_be(1.0f, read[0].vertices[3].texcoord.y);
+    expect_float_to_be(5.0f, read[1].vertices[2].position.z);
+    expect_should_be(3, read[0].indices[5]);
+    expect_should_be(2, read[1].indices[2]);
+
+    // Too small an array, and truncated files, are rejected.
+    expect_to_be_false(mesh_file_parse(mapping.data, mapping.size, 1, read, &count));
+    expect_to_be_false(mesh_file_parse(mapping.data, mapping.size - 1, 2, read, &count));
+
+    filesystem_unmap(&mapping);
+
+    // Indices past the last vertex are caught when writing.
+    triangle_indices[2] = 3;
+    expect_to_be_false(mesh_file_write(MESH_TEST_PATH, 2, submeshes));
+    return true;
+}
+
+void mesh_file_register_tests()
+{
+    test_manager_register_test(mesh_file_should_round_trip_submeshes, "Mesh file should round trip submeshes");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void mesh_file_register_tests();
@@ -0,0 +1,92 @@
+#include "resource_pack_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <resources/resource_pack.h>
+
+#define PACK_TEST_PATH "resource_pack_test.dpk"
+
+static b8 write_test_file(const char *path, u64 size, u8 seed)
+{
+    file_writer_config config = {0};
+    file_writer writer;
+    if (!filesystem_writer_open(path, true, config, &writer))
+    {
+        return false;
+    }
+    for (u64 i = 0; i < size; ++i)
+    {
+        u8 value = (u8)(i * 3 + seed);
+        filesystem_writer_write(&writer, 1, &value);
+    }
+    filesystem_writer_close(&writer);
+    return true;
+}
+
+b8 pack_should_find_every_entry()
+{
+    expect_to_be_true(write_test_file("resource_pack_test_0.bin", 1000, 1));
+    expect_to_be_true(write_test_file("resource_pack_test_1.bin", 0, 0));
+    expect_to_be_true(write_test_file("resource_pack_test_2.bin", 37, 5));
+
+    const char *entry_paths[3]  = {"textures/test.png", "empty.txt", "materials/test.kmt"};
+    const char *source_paths[3] = {"resource_pack_test_0.bin", "resource_pack_test_1.bin", "resource_pack_test_2.bin"};
+    u64 sizes[3]                = {1000, 0, 37};
+    u8 seeds[3]                 = {1, 0, 5};
+    expect_to_be_true(resource_pack_build(PACK_TEST_PATH, 3, entry_paths, source_paths));
+
+    resource_pack pack;
+    expect_to_be_true(resource_pack_open(PACK_TEST_PATH, &pack));
+    expect_should_be(3, pack.header->entry_count);
+
+    for (u32 i = 0; i < 3; ++i)
+    {
+        file_mapping view;
+        expect_to_be_true(resource_pack_find(&pack, entry_paths[i], &view));
+        expect_should_be(sizes[i], view.size);
+        expect_should_be(0, ((u64)view.data) % RESOURCE_PACK_ALIGNMENT);
+        expect_to_be_true(resource_pack_contains(&pack, view.data));
+        for (u64 b = 0; b < view.size; ++b)
+        {
+            expect_should_be((u8)(b * 3 + seeds[i]), ((const u8 *)view.data)[b]);
+        }
+    }
+
+    file_mapping missing;
+    expect_to_be_false(resource_pack_find(&pack, "textures/missing.png", &missing));
+    expect_to_be_false(resource_pack_find(&pack, "textures/test.pn", &missing));
+    expect_to_be_false(resource_pack_contains(&pack, &missing));
+
+    resource_pack_close(&pack);
+    expect_should_be(0, pack.header);
+
+    return true;
+}
+
+b8 pack_should_reject_bad_input()
+{
+    expect_to_be_true(write_test_file("resource_pack_test_0.bin", 10, 0));
+
+    // The same path twice.
+    const char *entry_paths[2]  = {"a.bin", "a.bin"};
+    const char *source_paths[2] = {"resource_pack_test_0.bin", "resource_pack_test_0.bin"};
+    expect_to_be_false(resource_pack_build(PACK_TEST_PATH, 2, entry_paths, source_paths));
+
+    // A source that does not exist.
+    const char *missing_source[1] = {"resource_pack_test_missing.bin"};
+    expect_to_be_false(resource_pack_build(PACK_TEST_PATH, 1, entry_paths, missing_source));
+
+    // Something that is not a pack.
+    resource_pack pack;
+    expect_to_be_false(resource_pack_open("resource_pack_test_0.bin", &pack));
+
+    return true;
+}
+
+void resource_pack_register_tests()
+{
+    test_manager_register_test(pack_should_find_every_entry, "Resource pack should find every entry");
+    test_manager_register_test(pack_should_reject_bad_input, "Resource pack should reject bad input");
+}
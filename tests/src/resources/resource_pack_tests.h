@@ -0,0 +1,3 @@
+#pragma once
+
+void resource_pack_register_tests();
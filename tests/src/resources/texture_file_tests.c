@@ -0,0 +1,89 @@
+#include "texture_file_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dmemory.h>
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <resources/texture_file.h>
+
+#define TEXTURE_TEST_PATH "texture_file_test.dtex"
+
+b8 texture_file_should_round_trip_with_mips()
+{
+    // A 5x3 image, opaque apart from its last pixel, so odd sizes and the transparency flag are covered.
+    const u32 width  = 5;
+    const u32 height = 3;
+    u8 pixels[5 * 3 * 4];
+    for (u32 i = 0; i < width * height; ++i)
+    {
+        pixels[i * 4 + 0] = (u8)(i * 10);
+        pixels[i * 4 + 1] = 100;
+        pixels[i * 4 + 2] = 200;
+        pixels[i * 4 + 3] = i == width * height - 1 ? 0 : 255;
+    }
+    expect_to_be_true(texture_file_write(TEXTURE_TEST_PATH, width, height, pixels));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(TEXTURE_TEST_PATH, &mapping));
+    expect_to_be_true(texture_file_is_cooked(mapping.data, mapping.size));
+
+    const texture_file_header *header;
+    expect_to_be_true(texture_file_parse(mapping.data, mapping.size, &header));
+    expect_should_be(5, header->width);
+    expect_should_be(3, header->height);
+    expect_should_be(TEXTURE_FILE_FORMAT_RGBA8, header->format);
+    expect_to_be_true((header->flags & TEXTURE_FILE_FLAG_HAS_TRANSPARENCY) != 0);
+
+    // 5x3, 2x1, 1x1.
+    expect_should_be(3, header->mip_count);
+    expect_should_be(2 * 1 * 4, header->mip_sizes[1]);
+    expect_should_be(1 * 1 * 4, header->mip_sizes[2]);
+    expect_to_be_true(texture_file_mip(header, 3) == 0);
+
+    const u8 *level0 = texture_file_mip(header, 0);
+    expect_should_be(0, ((u64)level0) % TEXTURE_FILE_ALIGNMENT);
+    for (u32 i = 0; i < sizeof(pixels); ++i)
+    {
+        expect_should_be(pixels[i], level0[i]);
+    }
+
+    // Each texel of level 1 averages a 2x2 block of level 0: red is 0, 10, 50 and 60 for the first.
+    const u8 *level1 = texture_file_mip(header, 1);
+    expect_should_be(30, level1[0]);
+    expect_should_be(100, level1[1]);
+    expect_should_be(200, level1[2]);
+
+    // Truncated files are rejected.
+    const texture_file_header *truncated;
+    expect_to_be_false(texture_file_parse(mapping.data, mapping.size - 1, &truncated));
+
+    filesystem_unmap(&mapping);
+    return true;
+}
+
+b8 texture_file_should_clear_transparency_for_opaque_images()
+{
+    u8 pixels[2 * 2 * 4];
+    for (u32 i = 0; i < sizeof(pixels); ++i)
+    {
+        pixels[i] = 255;
+    }
+    expect_to_be_true(texture_file_write(TEXTURE_TEST_PATH, 2, 2, pixels));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(TEXTURE_TEST_PATH, &mapping));
+    const texture_file_header *header;
+    expect_to_be_true(texture_file_parse(mapping.data, mapping.size, &header));
+    expect_to_be_false((header->flags & TEXTURE_FILE_FLAG_HAS_TRANSPARENCY) != 0);
+
+    filesystem_unmap(&mapping);
+    return true;
+}
+
+void texture_file_register_tests()
+{
+    test_manager_register_test(texture_file_should_round_trip_with_mips, "Texture file should round trip with mips");
+    test_manager_register_test(texture_file_should_clear_transparency_for_opaque_images,
+                               "Texture file should clear transparency for opaque images");
+}
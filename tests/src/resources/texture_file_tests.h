@@ -0,0 +1,3 @@
+#pragma once
+
+void texture_file_register_tests();
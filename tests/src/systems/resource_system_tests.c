@@ -0,0 +1,291 @@
+#include "resource_system_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <core/dmemory.h>
+#include <core/dstring.h>
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <systems/resource_system.h>
+
+#define CACHE_TEST_TYPE "cache_test"
+// Room for two test resources, but not three.
+#define CACHE_TEST_RESOURCE_SIZE 40
+#define CACHE_TEST_BUDGET 100
+
+static u32 load_count   = 0;
+static u32 unload_count = 0;
+
+static b8 counting_loader_load(struct resource_loader *self, const char *name, resource *out_resource)
+{
+    load_count++;
+    out_resource->name      = name;
+    out_resource->full_path = 0;
+    out_resource->data_size = CACHE_TEST_RESOURCE_SIZE;
+    out_resource->data      = dallocate(CACHE_TEST_RESOURCE_SIZE, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+static void counting_loader_unload(struct resource_loader *self, resource *resource)
+{
+    unload_count++;
+    dfree(resource->data, resource->data_size, MEMORY_TAG_ARRAY);
+    resource->data      = 0;
+    resource->data_size = 0;
+    resource->loader_id = INVALID_ID;
+}
+
+static u64 counting_loader_memory_size(struct resource_loader *self, const resource *resource)
+{
+    return resource->data_size;
+}
+
+static void *resource_test_startup()
+{
+    resource_system_config config = {0};
+    config.max_loader_count       = 8;
+    config.asset_base_path        = ".";
+    config.cache_budget           = CACHE_TEST_BUDGET;
+
+    u64 memory_requirement = 0;
+    resource_system_initialize(&memory_requirement, 0, config);
+    void *state = dallocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    resource_system_initialize(&memory_requirement, state, config);
+
+    resource_loader loader = {0};
+    loader.type            = RESOURCE_TYPE_CUSTOM;
+    loader.custom_type     = CACHE_TEST_TYPE;
+    loader.load            = counting_loader_load;
+    loader.unload          = counting_loader_unload;
+    loader.memory_size     = counting_loader_memory_size;
+    loader.type_path       = "";
+    loader.extensions[0]   = "";
+    loader.extension_count = 1;
+    resource_system_register_loader(loader);
+
+    load_count   = 0;
+    unload_count = 0;
+    return state;
+}
+
+static void resource_test_shutdown(void *state)
+{
+    resource_system_config config = {0};
+    config.max_loader_count       = 8;
+
+    u64 memory_requirement = 0;
+    resource_system_initialize(&memory_requirement, 0, config);
+    resource_system_shutdown(state);
+    dfree(state, memory_requirement, MEMORY_TAG_APPLICATION);
+}
+
+b8 cache_should_share_repeated_loads()
+{
+    void *state = resource_test_startup();
+
+    resource first;
+    expect_to_be_true(resource_system_load_custom("a", CACHE_TEST_TYPE, &first));
+    void *data = first.data;
+    resource_system_unload(&first);
+    expect_should_be(0, unload_count);
+
+    // Loaded again after being unloaded, and while still loaded.
+    resource second;
+    resource third;
+    expect_to_be_true(resource_system_load_custom("a", CACHE_TEST_TYPE, &second));
+    expect_to_be_true(resource_system_load_custom("a", CACHE_TEST_TYPE, &third));
+    expect_should_be(1, load_count);
+    expect_to_be_true(second.data == data);
+    expect_to_be_true(third.data == data);
+    resource_system_unload(&second);
+    resource_system_unload(&third);
+    expect_should_be(0, unload_count);
+
+    resource_test_shutdown(state);
+    expect_should_be(1, unload_count);
+    return true;
+}
+
+b8 cache_should_evict_least_recently_used()
+{
+    void *state = resource_test_startup();
+
+    resource a;
+    resource b;
+    resource c;
+    expect_to_be_true(resource_system_load_custom("a", CACHE_TEST_TYPE, &a));
+    expect_to_be_true(resource_system_load_custom("b", CACHE_TEST_TYPE, &b));
+    resource_system_unload(&a);
+    resource_system_unload(&b);
+
+    // Use a again, so b is now the least recently used.
+    expect_to_be_true(resource_system_load_custom("a", CACHE_TEST_TYPE, &a));
+    resource_system_unload(&a);
+    expect_should_be(2, load_count);
+
+    // Going over the budget evicts b, and only b.
+    expect_to_be_true(resource_system_load_custom("c", CACHE_TEST_TYPE, &c));
+    expect_should_be(1, unload_count);
+    expect_to_be_true(resource_system_load_custom("a", CACHE_TEST_TYPE, &a));
+    expect_should_be(3, load_count);
+
+    // Resources in use are never evicted, even over the budget...
+    expect_to_be_true(resource_system_load_custom("b", CACHE_TEST_TYPE, &b));
+    expect_should_be(4, load_count);
+    expect_should_be(1, unload_count);
+
+    // ...until they are unloaded.
+    resource_system_unload(&a);
+    expect_should_be(2, unload_count);
+    resource_system_unload(&b);
+    resource_system_unload(&c);
+    expect_should_be(2, unload_count);
+
+    resource_test_shutdown(state);
+    expect_should_be(4, unload_count);
+    return true;
+}
+
+b8 registry_should_match_custom_types_ignoring_case()
+{
+    void *state = resource_test_startup();
+
+    resource loaded;
+    expect_to_be_true(resource_system_load_custom("a", "Cache_Test", &loaded));
+    resource_system_unload(&loaded);
+    expect_to_be_false(resource_system_load_custom("a", "other_type", &loaded));
+
+    resource_loader duplicate = {0};
+    duplicate.type            = RESOURCE_TYPE_CUSTOM;
+    duplicate.custom_type     = "CACHE_TEST";
+    duplicate.load            = counting_loader_load;
+    duplicate.unload          = counting_loader_unload;
+    duplicate.type_path       = "";
+    duplicate.extensions[0]   = "";
+    duplicate.extension_count = 1;
+    expect_to_be_false(resource_system_register_loader(duplicate));
+    duplicate.custom_type = "another_test";
+    expect_to_be_true(resource_system_register_loader(duplicate));
+
+    resource_test_shutdown(state);
+    return true;
+}
+
+static b8 touch_file(const char *path)
+{
+    file_handle handle;
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &handle))
+    {
+        return false;
+    }
+    filesystem_close(&handle);
+    return true;
+}
+
+b8 find_file_should_probe_extensions_in_order()
+{
+    void *state = resource_test_startup();
+
+    resource_loader loader = {0};
+    loader.type_path       = ".";
+    loader.extensions[0]   = ".first";
+    loader.extensions[1]   = ".second";
+    loader.extension_count = 2;
+
+    expect_to_be_true(touch_file("probe_test_a.second"));
+    expect_to_be_true(touch_file("probe_test_b.first"));
+    expect_to_be_true(touch_file("probe_test_b.second"));
+
+    char path[512];
+    expect_should_be(1, resource_system_find_file(&loader, "probe_test_a", path));
+    expect_to_be_true(strings_equal(path, "././probe_test_a.second"));
+    expect_should_be(0, resource_system_find_file(&loader, "probe_test_b", path));
+    expect_to_be_true(strings_equal(path, "././probe_test_b.first"));
+    expect_should_be(INVALID_ID, resource_system_find_file(&loader, "probe_test_missing", path));
+    expect_to_be_true(strings_equal(path, "././probe_test_missing.first"));
+
+    resource_test_shutdown(state);
+    return true;
+}
+
+#define ARENA_TEST_TYPE "arena_test"
+
+// Takes its path and data from the resource's arena, failing partway for "fail".
+static b8 arena_loader_load(struct resource_loader *self, const char *name, resource *out_resource)
+{
+    resource_system_create_arena(out_resource, name, 64);
+    out_resource->name      = name;
+    out_resource->data_size = 64;
+    out_resource->data      = linear_allocator_allocate(&out_resource->arena, 64);
+    return !strings_equal(name, "fail");
+}
+
+b8 arena_should_hold_a_resource_until_unloaded()
+{
+    void *state = resource_test_startup();
+
+    resource_loader loader = {0};
+    loader.type            = RESOURCE_TYPE_CUSTOM;
+    loader.custom_type     = ARENA_TEST_TYPE;
+    loader.load            = arena_loader_load;
+    loader.type_path       = "";
+    loader.extensions[0]   = "";
+    loader.extension_count = 1;
+    expect_to_be_true(resource_system_register_loader(loader));
+
+    // Path and data share one allocation, the path first and rounded up to keep the data aligned.
+    resource loaded;
+    expect_to_be_true(resource_system_load_custom("arena", ARENA_TEST_TYPE, &loaded));
+    expect_to_be_true(strings_equal(loaded.full_path, "arena"));
+    expect_to_be_true(loaded.full_path == loaded.arena.memory);
+    expect_to_be_true((u8 *)loaded.data == (u8 *)loaded.arena.memory + 8);
+    expect_should_be(72, loaded.arena.total_size);
+    expect_should_be(72, loaded.arena.allocated);
+
+    resource_system_unload(&loaded);
+    expect_to_be_true(loaded.arena.memory == 0);
+    expect_to_be_true(loaded.full_path == 0);
+
+    // A failed load frees whatever it took.
+    expect_to_be_false(resource_system_load_custom("fail", ARENA_TEST_TYPE, &loaded));
+    expect_to_be_true(loaded.arena.memory == 0);
+
+    resource_test_shutdown(state);
+    return true;
+}
+
+static void count_completion(b8 success, resource *loaded_resource, void *user_data)
+{
+    u32 *counts = user_data;
+    counts[success ? 0 : 1]++;
+}
+
+b8 shutdown_should_fail_loads_never_pumped()
+{
+    void *state = resource_test_startup();
+
+    // Without a job system, the load runs here and waits for the pump.
+    u32 counts[2] = {0};
+    expect_to_be_true(resource_system_load_async("missing", RESOURCE_TYPE_TEXT, count_completion, counts));
+    expect_should_be(0, counts[0] + counts[1]);
+
+    resource_test_shutdown(state);
+    expect_should_be(0, counts[0]);
+    expect_should_be(1, counts[1]);
+    return true;
+}
+
+void resource_system_register_tests()
+{
+    test_manager_register_test(cache_should_share_repeated_loads, "Resource cache should share repeated loads");
+    test_manager_register_test(cache_should_evict_least_recently_used,
+                               "Resource cache should evict the least recently used resource");
+    test_manager_register_test(registry_should_match_custom_types_ignoring_case,
+                               "Resource loader registry should match custom types ignoring case");
+    test_manager_register_test(find_file_should_probe_extensions_in_order,
+                               "Resource system should probe extensions in order");
+    test_manager_register_test(arena_should_hold_a_resource_until_unloaded,
+                               "Resource arena should hold a resource until unloaded");
+    test_manager_register_test(shutdown_should_fail_loads_never_pumped,
+                               "Resource system shutdown should fail loads never pumped");
+}
@@ -0,0 +1,100 @@
+#include "texture_streaming_tests.h"
+#include "../expect.h"
+#include "../test_manager.h"
+
+#include <defines.h>
+#include <systems/texture_streaming.h>
+
+// A 256x256 texture with its 9 mip levels, held from the given level and wanting another.
+static texture_streaming_entry make_entry(u32 resident_level, u32 wanted_level, f32 importance)
+{
+    texture_streaming_entry entry = {0};
+    entry.width                   = 256;
+    entry.height                  = 256;
+    entry.mip_count               = 9;
+    entry.resident_level          = resident_level;
+    entry.wanted_level            = wanted_level;
+    entry.importance              = importance;
+    return entry;
+}
+
+b8 texture_streaming_should_pick_levels_by_size()
+{
+    // Starts at the first level no larger than 64 on either side.
+    expect_should_be(4, texture_streaming_start_level(1024, 512, 11));
+    expect_should_be(0, texture_streaming_start_level(32, 32, 6));
+    // Or the last level, if the image has too few.
+    expect_should_be(1, texture_streaming_start_level(1024, 1024, 2));
+
+    // Wants the coarsest level still at least as large as it is drawn.
+    expect_should_be(3, texture_streaming_wanted_level(1024, 512, 11, 100.0f));
+    expect_should_be(4, texture_streaming_wanted_level(1024, 512, 11, 64.0f));
+    expect_should_be(0, texture_streaming_wanted_level(1024, 512, 11, 2000.0f));
+    expect_should_be(10, texture_streaming_wanted_level(1024, 512, 11, 0.0f));
+
+    expect_should_be(4 * (16 + 4 + 1), texture_streaming_size(4, 4, 3, 0));
+    expect_should_be(4 * (4 + 1), texture_streaming_size(4, 4, 3, 1));
+    return true;
+}
+
+b8 texture_streaming_should_raise_most_important_first()
+{
+    texture_streaming_entry entries[3];
+    entries[0] = make_entry(4, 0, 10.0f);
+    entries[1] = make_entry(4, 0, 50.0f);
+    entries[2] = make_entry(4, 0, 100.0f);
+    // Already loading, so left alone.
+    entries[2].busy = true;
+
+    // Room for one texture at full size, and the others at their start size.
+    u64 budget = texture_streaming_size(256, 256, 9, 0) + texture_streaming_size(256, 256, 9, 4) * 2;
+    texture_streaming_change changes[4];
+    u32 count = texture_streaming_plan(3, entries, budget, 4, changes);
+    expect_should_be(1, count);
+    expect_should_be(1, changes[0].index);
+    expect_should_be(0, changes[0].level);
+    return true;
+}
+
+b8 texture_streaming_should_lower_least_important_over_budget()
+{
+    texture_streaming_entry entries[3];
+    entries[0] = make_entry(0, 4, 5.0f);
+    entries[1] = make_entry(0, 4, 1.0f);
+    // Not streamed, so neither counted nor changed.
+    entries[2] = (texture_streaming_entry){0};
+
+    // Room for only one of them at full size.
+    u64 budget = texture_streaming_size(256, 256, 9, 0) + texture_streaming_size(256, 256, 9, 4);
+    texture_streaming_change changes[4];
+    u32 count = texture_streaming_plan(3, entries, budget, 4, changes);
+    expect_should_be(1, count);
+    expect_should_be(1, changes[0].index);
+    expect_should_be(4, changes[0].level);
+
+    // Lowers a less important texture to make room for a more important one.
+    entries[0] = make_entry(4, 0, 50.0f);
+    entries[1] = make_entry(0, 4, 1.0f);
+    count      = texture_streaming_plan(2, entries, budget, 4, changes);
+    expect_should_be(2, count);
+    expect_should_be(1, changes[0].index);
+    expect_should_be(4, changes[0].level);
+    expect_should_be(0, changes[1].index);
+    expect_should_be(0, changes[1].level);
+
+    // But not a more important one.
+    entries[1].importance = 100.0f;
+    count                 = texture_streaming_plan(2, entries, budget, 4, changes);
+    expect_should_be(0, count);
+    return true;
+}
+
+void texture_streaming_register_tests()
+{
+    test_manager_register_test(texture_streaming_should_pick_levels_by_size,
+                               "Texture streaming should pick levels by size");
+    test_manager_register_test(texture_streaming_should_raise_most_important_first,
+                               "Texture streaming should raise the most important textures first");
+    test_manager_register_test(texture_streaming_should_lower_least_important_over_budget,
+                               "Texture streaming should lower the least important textures over budget");
+}
@@ -1,7 +1,7 @@
 #include "test_manager.h"
 
 #include <containers/darray.h>
-#include <core/dclock.h>
+#include <core/clock.h>
 #include <core/dstring.h>
 #include <core/logger.h>
 
@@ -0,0 +1,149 @@
+/*
+cook - converts source assets into the formats the engine loads fastest.
+
+Usage: cook <assets directory>    (e.g. cook ../assets)
+
+Each file is cooked next to its source, which the resource system then prefers:
+    textures/<name>.png, .jpg or .tga -> textures/<name>.dtex
+    materials/<name>.kmt              -> materials/<name>.dmt
+*/
+
+#include <core/dstring.h>
+#include <resources/material_file.h>
+#include <resources/texture_file.h>
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+typedef b8 (*PFN_cook)(const char *source_path, const char *out_path);
+
+// A kind of source file, and how to cook it.
+typedef struct cook_rule
+{
+    const char *directory;
+    const char *source_extension;
+    const char *cooked_extension;
+    PFN_cook cook;
+} cook_rule;
+
+static const cook_rule cook_rules[] = {
+    {"textures", ".png", ".dtex", texture_file_cook},
+    {"textures", ".jpg", ".dtex", texture_file_cook},
+    {"textures", ".tga", ".dtex", texture_file_cook},
+    {"materials", ".kmt", ".dmt", material_file_cook},
+};
+
+typedef struct cook_totals
+{
+    u32 cooked;
+    u32 failed;
+} cook_totals;
+
+// Cooks path if it is a source file of the rule, writing the result beside it.
+static void cook_file(const char *path, const cook_rule *rule, cook_totals *totals)
+{
+    u64 length           = string_length(path);
+    u64 extension_length = string_length(rule->source_extension);
+    if (length <= extension_length || !strings_equali(path + length - extension_length, rule->source_extension))
+    {
+        return;
+    }
+
+    char out_path[1024];
+    string_format(out_path, "%.*s%s", (int)(length - extension_length), path, rule->cooked_extension);
+    if (rule->cook(path, out_path))
+    {
+        totals->cooked++;
+    }
+    else
+    {
+        printf("cook: failed to cook '%s'.\n", path);
+        totals->failed++;
+    }
+}
+
+// Cooks every source file of the rule under directory.
+static void cook_directory(const char *directory, const cook_rule *rule, cook_totals *totals)
+{
+    char path[1024];
+#ifdef _WIN32
+    char pattern[1024];
+    string_format(pattern, "%s\\*", directory);
+    WIN32_FIND_DATAA find_data;
+    HANDLE find = FindFirstFileA(pattern, &find_data);
+    if (find == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+    do
+    {
+        const char *name = find_data.cFileName;
+        b8 is_directory  = (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    DIR *dir = opendir(directory);
+    if (!dir)
+    {
+        return;
+    }
+    struct dirent *item;
+    while ((item = readdir(dir)) != 0)
+    {
+        const char *name = item->d_name;
+#endif
+        if (name[0] == '.')
+        {
+            continue;
+        }
+
+        string_format(path, "%s/%s", directory, name);
+#ifndef _WIN32
+        struct stat info;
+        if (stat(path, &info) != 0)
+        {
+            continue;
+        }
+        b8 is_directory = S_ISDIR(info.st_mode);
+#endif
+        if (is_directory)
+        {
+            cook_directory(path, rule, totals);
+        }
+        else
+        {
+            cook_file(path, rule, totals);
+        }
+#ifdef _WIN32
+    } while (FindNextFileA(find, &find_data));
+    FindClose(find);
+#else
+    }
+    closedir(dir);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: cook <assets directory>\n");
+        return 1;
+    }
+
+    cook_totals totals = {0};
+    u32 rule_count     = sizeof(cook_rules) / sizeof(cook_rule);
+    for (u32 i = 0; i < rule_count; ++i)
+    {
+        char directory[1024];
+        string_format(directory, "%s/%s", argv[1], cook_rules[i].directory);
+        cook_directory(directory, &cook_rules[i], &totals);
+    }
+
+    printf("cook: cooked %u files, %u failed.\n", totals.cooked, totals.failed);
+    return totals.failed ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+/*
+logdecode - expands a binary log (console.blog) written by DLOG_BINARY into text.
+
+Usage: logdecode [path]    (defaults to console.blog)
+
+Entries are buffered per thread in the engine, so log_binary_decode sorts them by
+timestamp to restore the order they were logged in.
+*/
+
+#include <core/logger.h>
+#include <platform/filesystem.h>
+
+#include <stdio.h>
+
+// Timestamps are printed relative to the first message.
+typedef struct decode_state
+{
+    b8 started;
+    f64 start_time;
+} decode_state;
+
+static void print_message(f64 timestamp, log_level level, const char *message, void *user_data)
+{
+    const char *level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
+    decode_state *state          = user_data;
+    if (!state->started)
+    {
+        state->started    = true;
+        state->start_time = timestamp;
+    }
+    printf("%12.6f %s%s\n", timestamp - state->start_time, level_strings[level], message);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "console.blog";
+
+    file_mapping mapping;
+    if (!filesystem_map(path, &mapping))
+    {
+        printf("logdecode: unable to open '%s'.\n", path);
+        return 1;
+    }
+
+    decode_state state = {0};
+    b8 result          = log_binary_decode(mapping.data, mapping.size, print_message, &state);
+    filesystem_unmap(&mapping);
+    if (!result)
+    {
+        printf("logdecode: '%s' is not a version %i binary log.\n", path, LOG_BINARY_VERSION);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+pack - builds a resource pack from a directory of assets.
+
+Usage: pack <assets directory> <output pack>    (e.g. pack ../assets assets.dpk)
+
+Every file under the directory is added, keyed by its path relative to the directory
+with '/' separators, which is how the resource system looks files up once the pack is
+mounted. Files and directories starting with '.' are skipped.
+*/
+
+#include <containers/darray.h>
+#include <core/dmemory.h>
+#include <core/dstring.h>
+#include <resources/resource_pack.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+// Gathers every file under directory. relative_path is the directory's path within the pack, or "" for the root.
+static void collect_files(const char *directory, const char *relative_path, char ***entry_paths, char ***source_paths)
+{
+    char source_path[1024];
+    char entry_path[1024];
+#ifdef _WIN32
+    char pattern[1024];
+    string_format(pattern, "%s\\*", directory);
+    WIN32_FIND_DATAA find_data;
+    HANDLE find = FindFirstFileA(pattern, &find_data);
+    if (find == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+    do
+    {
+        const char *name = find_data.cFileName;
+        b8 is_directory  = (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    DIR *dir = opendir(directory);
+    if (!dir)
+    {
+        return;
+    }
+    struct dirent *item;
+    while ((item = readdir(dir)) != 0)
+    {
+        const char *name = item->d_name;
+#endif
+        if (name[0] == '.')
+        {
+            continue;
+        }
+
+        string_format(source_path, "%s/%s", directory, name);
+        if (relative_path[0])
+        {
+            string_format(entry_path, "%s/%s", relative_path, name);
+        }
+        else
+        {
+            string_format(entry_path, "%s", name);
+        }
+
+#ifndef _WIN32
+        struct stat info;
+        if (stat(source_path, &info) != 0)
+        {
+            continue;
+        }
+        b8 is_directory = S_ISDIR(info.st_mode);
+#endif
+        if (is_directory)
+        {
+            collect_files(source_path, entry_path, entry_paths, source_paths);
+        }
+        else
+        {
+            char *entry  = string_duplicate(entry_path);
+            char *source = string_duplicate(source_path);
+            darray_push(*entry_paths, entry);
+            darray_push(*source_paths, source);
+        }
+#ifdef _WIN32
+    } while (FindNextFileA(find, &find_data));
+    FindClose(find);
+#else
+    }
+    closedir(dir);
+#endif
+}
+
+typedef struct pack_file
+{
+    char *entry_path;
+    char *source_path;
+} pack_file;
+
+static int compare_files(const void *a, const void *b)
+{
+    return strcmp(((const pack_file *)a)->entry_path, ((const pack_file *)b)->entry_path);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: pack <assets directory> <output pack>\n");
+        return 1;
+    }
+
+    char **entry_paths  = darray_create(char *);
+    char **source_paths = darray_create(char *);
+    collect_files(argv[1], "", &entry_paths, &source_paths);
+    u32 count = (u32)darray_length(entry_paths);
+
+    // Sort by path, so the same assets always produce the same pack.
+    pack_file *files = dallocate(sizeof(pack_file) * (count ? count : 1), MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i < count; ++i)
+    {
+        files[i].entry_path  = entry_paths[i];
+        files[i].source_path = source_paths[i];
+    }
+    qsort(files, count, sizeof(pack_file), compare_files);
+    for (u32 i = 0; i < count; ++i)
+    {
+        entry_paths[i]  = files[i].entry_path;
+        source_paths[i] = files[i].source_path;
+    }
+
+    b8 result = resource_pack_build(argv[2], count, (const char **)entry_paths, (const char **)source_paths);
+    if (result)
+    {
+        printf("pack: wrote %u files to '%s'.\n", count, argv[2]);
+    }
+    else
+    {
+        printf("pack: failed to write '%s'.\n", argv[2]);
+    }
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        dfree(entry_paths[i], string_length(entry_paths[i]) + 1, MEMORY_TAG_STRING);
+        dfree(source_paths[i], string_length(source_paths[i]) + 1, MEMORY_TAG_STRING);
+    }
+    dfree(files, sizeof(pack_file) * (count ? count : 1), MEMORY_TAG_ARRAY);
+    darray_destroy(source_paths);
+    darray_destroy(entry_paths);
+    return result ? 0 : 1;
+}